@@ -76,6 +76,25 @@ namespace DataLoaders
         std::vector<size_t> m_trainIndices;
         std::vector<size_t> m_validationIndices;
         std::vector<size_t> m_testIndices;
+
+        // Host-resident pools map the buffer directly; otherwise the data goes through the pinned staging
+        // ring and the upload event is appended to p_uploadEvents.
+        cl::Buffer uploadBatchData(const std::vector<float> &p_data, std::vector<cl::Event> &p_uploadEvents) const
+        {
+            const std::shared_ptr<Utils::BufferPool> &bufferPool = m_sharedResources->getBufferPool();
+            size_t bytes = p_data.size() * sizeof(float);
+            if (bufferPool->isZeroCopy())
+            {
+                return bufferPool->acquire(bytes, p_data.data());
+            }
+            cl::Buffer buffer = bufferPool->acquire(bytes);
+            cl::Event uploadEvent = m_sharedResources->getStagingRing()->upload(buffer, p_data.data(), bytes);
+            if (uploadEvent() != nullptr)
+            {
+                p_uploadEvents.push_back(uploadEvent);
+            }
+            return buffer;
+        }
     };
 
     class DataLoaderIterator
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Layers/Layer.hpp"
+
+#include <algorithm>
+#include <string>
+
 namespace Layers::Activation
 {
     class ActivationLayer : public Layer
@@ -9,15 +13,17 @@ namespace Layers::Activation
         ActivationLayer(const size_t p_layerId,
                         std::shared_ptr<Utils::SharedResources> p_sharedResources,
                         const Utils::Dimensions &p_outputDimensions,
-                        const size_t p_batchSize)
-            : Layer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize)
+                        const size_t p_batchSize,
+                        const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : Layer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize, p_mode)
         {
         }
 
         ActivationLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                         const H5::Group &p_layerGroup,
-                        const size_t p_batchSize)
-            : Layer(p_sharedResources, p_layerGroup, p_batchSize)
+                        const size_t p_batchSize,
+                        const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : Layer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
         {
         }
 
@@ -25,19 +31,16 @@ namespace Layers::Activation
 
         cl::Event runForward(const cl::CommandQueue &p_forwardBackpropQueue, const cl::Buffer &p_inputs, const size_t p_batchSize) override
         {
-            if (m_batchSize < p_batchSize)
-                setBatchSize(p_batchSize);
+            ensureBatchCapacity(p_batchSize);
             cl::Event forwardEvent;
 
             Utils::setKernelArgs(m_forwardKernel, p_inputs);
+            if (isGridStride())
+            {
+                Utils::setKernelArgs(3, m_forwardKernel, (cl_uint)(p_batchSize * getTotalOutputElements()));
+            }
 
-            cl_int err = p_forwardBackpropQueue.enqueueNDRangeKernel(
-                m_forwardKernel,
-                cl::NullRange,
-                getForwardWorkSize(p_batchSize),
-                cl::NullRange,
-                nullptr,
-                &forwardEvent);
+            cl_int err = enqueueActivationKernel(p_forwardBackpropQueue, m_forwardKernel, getForwardWorkSize(p_batchSize), &forwardEvent);
 
             if (err != CL_SUCCESS)
             {
@@ -49,18 +52,15 @@ namespace Layers::Activation
 
         cl::Event backpropDeltas(const cl::CommandQueue &p_forwardBackpropQueue, const cl::Buffer &p_previousLayerDeltas, const size_t p_batchSize) override
         {
-            if (m_batchSize < p_batchSize)
-                setBatchSize(p_batchSize);
+            ensureBatchCapacity(p_batchSize);
             cl::Event backpropEvent;
             Utils::setKernelArgs(m_backwardKernel, p_previousLayerDeltas);
+            if (isGridStride())
+            {
+                Utils::setKernelArgs(4, m_backwardKernel, (cl_uint)(p_batchSize * getTotalOutputElements()));
+            }
 
-            cl_int err = p_forwardBackpropQueue.enqueueNDRangeKernel(
-                m_backwardKernel,
-                cl::NullRange,
-                getForwardWorkSize(p_batchSize),
-                cl::NullRange,
-                nullptr,
-                &backpropEvent);
+            cl_int err = enqueueActivationKernel(p_forwardBackpropQueue, m_backwardKernel, getBackwardWorkSize(p_batchSize), &backpropEvent);
 
             if (err != CL_SUCCESS)
             {
@@ -70,18 +70,93 @@ namespace Layers::Activation
             return backpropEvent;
         }
 
-        virtual void setBatchSize(const size_t p_batchSize) override
-        {
-            allocateLayerBuffers(p_batchSize);
-            Utils::setKernelArgs(1, m_forwardKernel, getOutputs());
-            Utils::setKernelArgs(1, m_backwardKernel, getDeltas(), getOutputs());
-        }
+        virtual bool readsOutputsInBackward() const override { return true; }
+
+        // Elementwise activations whose backward pass only reads their outputs can be applied by the bias
+        // kernel of the trainable layer before them.
+        virtual bool isFusable() const { return false; }
+
+        virtual float getFusedAlpha() const { return 0.0f; }
+
+        cl_uint getVectorWidth() const { return m_vectorWidth; }
+
+        bool isVectorized() const { return m_vectorWidth > 1; }
+
+        // Elementwise kernels created by createVectorKernels, at any width, take the element count and stride over it.
+        bool isGridStride() const { return m_gridStride; }
 
     protected:
+        // Grid-stride vector kernels never need more work-items than this to keep a device busy.
+        static constexpr size_t MAX_VECTOR_WORK_ITEMS = 65536;
+
         cl::Kernel m_forwardKernel;
         cl::Kernel m_backwardKernel;
+        cl_uint m_vectorWidth = 1;
+        bool m_gridStride = false;
+
+        // Creates the grid-stride kernels of an elementwise activation at the smallest preferred float vector
+        // width of the devices: float8 at 8 or more, float4 at 4 or more, the scalar kernels otherwise. Their
+        // alpha argument is left at 0.
+        void createVectorKernels(const std::string &p_name, const std::string &p_label)
+        {
+            cl_uint preferredWidth = 8;
+            for (const cl::Device &device : m_sharedResources->getDevices())
+            {
+                preferredWidth = std::min(preferredWidth, device.getInfo<CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT>());
+            }
+            m_vectorWidth = preferredWidth >= 8 ? 8 : (preferredWidth >= 4 ? 4 : 1);
+            m_gridStride = true;
+            const std::string suffix = isVectorized() ? "Vec" + std::to_string(m_vectorWidth) : "";
+            cl_int err;
+
+            m_forwardKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Activation), (p_name + "Forward" + suffix).c_str(), &err);
+            if (err != CL_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create " + p_label + " forward kernel");
+            }
+            Utils::setKernelArgs(2, m_forwardKernel, 0.0f);
 
-        virtual cl::NDRange getForwardWorkSize(const size_t p_batchSize) const { return cl::NDRange(p_batchSize * getTotalOutputElements()); }
+            m_backwardKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Activation), (p_name + "Backward" + suffix).c_str(), &err);
+            if (err != CL_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create " + p_label + " backward kernel");
+            }
+            Utils::setKernelArgs(3, m_backwardKernel, 0.0f);
+        }
+
+        virtual void bindBufferArgs() override
+        {
+            Utils::setKernelArgs(1, m_forwardKernel, getOutputs());
+            if (!isInferenceOnly())
+            {
+                Utils::setKernelArgs(1, m_backwardKernel, getDeltas(), getOutputs());
+            }
+        }
+
+        virtual cl::NDRange getForwardWorkSize(const size_t p_batchSize) const
+        {
+            const size_t elements = p_batchSize * getTotalOutputElements();
+            if (isGridStride())
+            {
+                return cl::NDRange(std::min((elements + m_vectorWidth - 1) / m_vectorWidth, MAX_VECTOR_WORK_ITEMS));
+            }
+            return cl::NDRange(elements);
+        }
+
+        virtual cl::NDRange getBackwardWorkSize(const size_t p_batchSize) const { return getForwardWorkSize(p_batchSize); }
+
+        // Kernels that cooperate through local memory return their local size; NullRange leaves it to the tuner.
+        virtual cl::NDRange getWorkGroupSize() const { return cl::NullRange; }
+
+        cl_int enqueueActivationKernel(const cl::CommandQueue &p_queue, const cl::Kernel &p_kernel, const cl::NDRange &p_global, cl::Event *p_event) const
+        {
+            cl::NDRange local = getWorkGroupSize();
+            if (local.dimensions() == 0)
+            {
+                return m_sharedResources->enqueueKernel(p_queue, p_kernel, p_global, nullptr, p_event);
+            }
+            return m_sharedResources->enqueueKernel(p_queue, p_kernel, p_global, local, nullptr, p_event);
+        }
 
         void saveActivationLayer(H5::Group &p_layerGroup) const { saveLayer(p_layerGroup); }
 
@@ -10,19 +10,23 @@ namespace Layers::Activation
                        std::shared_ptr<Utils::SharedResources> p_sharedResources,
                        const Utils::Dimensions &p_outputDimensions,
                        float p_alpha,
-                       const size_t p_batchSize)
-            : PreActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize),
+                       const size_t p_batchSize,
+                       const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : PreActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize, p_mode),
               m_alpha(p_alpha)
         {
+            allocateSignMask(m_batchSize);
             setupKernels();
         }
 
         LeakyReLULayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                        const H5::Group &p_layerGroup,
-                       const size_t p_batchSize)
-            : PreActivationLayer(p_sharedResources, p_layerGroup, p_batchSize)
+                       const size_t p_batchSize,
+                       const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : PreActivationLayer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
         {
             m_alpha = Utils::readValueFromHDF5<float>(p_layerGroup, "alpha");
+            allocateSignMask(m_batchSize);
             setupKernels();
         }
 
@@ -32,10 +36,24 @@ namespace Layers::Activation
 
         float getAlpha() const { return m_alpha; }
 
+        float getFusedAlpha() const final override { return m_alpha; }
+
+        cl::Event runForward(const cl::CommandQueue &p_forwardBackpropQueue, const cl::Buffer &p_inputs, const size_t p_batchSize) final override
+        {
+            if (usesSignMask())
+            {
+                Utils::setKernelArgs(4, m_forwardKernel, (cl_uint)(p_batchSize * getTotalOutputElements()));
+            }
+            return PreActivationLayer::runForward(p_forwardBackpropQueue, p_inputs, p_batchSize);
+        }
+
         void save(const cl::CommandQueue &, H5::Group &p_layerGroup) const final override { saveLeakyReLULayer(p_layerGroup); }
         bool equals(const cl::CommandQueue &, const Layer &p_other) const final override { return leakyReLULayerEquals(p_other); }
         void print(const cl::CommandQueue &p_queue, const size_t p_batchSize) const final override { printLeakyReLULayer(p_queue, p_batchSize); }
 
+    protected:
+        bool preservesInputSign() const final override { return m_alpha >= 0.0f; }
+
     private:
         void setupKernels() final override;
 
@@ -3,59 +3,105 @@
 #include "Layers/ActivationLayers/ActivationLayer.hpp"
 namespace Layers::Activation
 {
+    // Activation whose backward pass depends on the sign of its input. The outputs carry that sign when
+    // the activation preserves it; otherwise a packed 1-bit sign mask is kept instead of a float copy.
     class PreActivationLayer : public ActivationLayer
     {
     public:
         PreActivationLayer(const size_t p_layerId,
                            std::shared_ptr<Utils::SharedResources> p_sharedResources,
                            const Utils::Dimensions &p_outputDimensions,
-                           const size_t p_batchSize)
-            : ActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize)
+                           const size_t p_batchSize,
+                           const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : ActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize, p_mode)
         {
-            allocatePreActivationLayerBuffers(p_batchSize);
         }
 
         PreActivationLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                            const H5::Group &p_layerGroup,
-                           const size_t p_batchSize)
-            : ActivationLayer(p_sharedResources, p_layerGroup, p_batchSize)
+                           const size_t p_batchSize,
+                           const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : ActivationLayer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
         {
-            allocatePreActivationLayerBuffers(p_batchSize);
         }
 
-        virtual ~PreActivationLayer() = default;
+        virtual ~PreActivationLayer()
+        {
+            m_sharedResources->getBufferPool()->release(m_signMask);
+        }
 
-        cl::Buffer &getPreActivations() { return m_preActivations; }
+        cl::Buffer &getSignMask() { return m_signMask; }
 
         virtual void print(const cl::CommandQueue &p_queue, const size_t p_batchSize) const override { printPreActivationLayer(p_queue, p_batchSize); }
 
         void setBatchSize(const size_t p_batchSize) final override
         {
             allocateLayerBuffers(p_batchSize);
-            allocatePreActivationLayerBuffers(p_batchSize);
-            Utils::setKernelArgs(1, m_forwardKernel, getOutputs(), getPreActivations());
-            Utils::setKernelArgs(1, m_backwardKernel, getDeltas(), getPreActivations());
+            allocateSignMask(p_batchSize);
+            bindBufferArgs();
+        }
+
+        bool readsOutputsInBackward() const final override { return !usesSignMask(); }
+
+        bool isFusable() const final override { return !usesSignMask(); }
+
+        void reportMemory(Utils::MemoryTracker &p_tracker) const final override
+        {
+            Layer::reportMemory(p_tracker);
+            p_tracker.record(m_layerId, Utils::MemoryRole::SignMasks, m_signMask);
         }
 
     protected:
-        cl::Buffer m_preActivations;
+        cl::Buffer m_signMask;
+
+        virtual bool preservesInputSign() const { return true; }
+
+        bool usesSignMask() const { return !isInferenceOnly() && !preservesInputSign(); }
 
-        void allocatePreActivationLayerBuffers(const size_t p_batchSize)
+        static size_t getSignMaskWords(const size_t p_elements) { return (p_elements + 31) / 32; }
+
+        void bindBufferArgs() final override
         {
-            m_preActivations = cl::Buffer(
-                m_sharedResources->getContext(),
-                CL_MEM_READ_WRITE,
-                p_batchSize * getTotalOutputElements() * sizeof(float));
+            if (!usesSignMask())
+            {
+                ActivationLayer::bindBufferArgs();
+                return;
+            }
+            Utils::setKernelArgs(1, m_forwardKernel, getOutputs(), getSignMask());
+            Utils::setKernelArgs(1, m_backwardKernel, getDeltas(), getSignMask());
         }
 
-        void savePreActivationLayer(H5::Group &p_layerGroup) const { saveLayer(p_layerGroup); }
+        cl::NDRange getForwardWorkSize(const size_t p_batchSize) const override
+        {
+            if (usesSignMask())
+            {
+                return cl::NDRange(getSignMaskWords(p_batchSize * getTotalOutputElements()));
+            }
+            return ActivationLayer::getForwardWorkSize(p_batchSize);
+        }
 
-        bool preActivationLayerEquals(const PreActivationLayer &p_other) const { return layerEquals(p_other); }
+        cl::NDRange getBackwardWorkSize(const size_t p_batchSize) const override
+        {
+            if (usesSignMask())
+            {
+                return cl::NDRange(p_batchSize * getTotalOutputElements());
+            }
+            return ActivationLayer::getBackwardWorkSize(p_batchSize);
+        }
 
-        void printPreActivationLayer(const cl::CommandQueue &p_queue, const size_t p_batchSize) const
+        void allocateSignMask(const size_t p_batchSize)
         {
-            printLayer(p_queue, p_batchSize);
-            Utils::printCLBuffer(p_queue, m_preActivations, p_batchSize * m_outputDimensions.getTotalElements(), "Pre Activations");
+            m_sharedResources->getBufferPool()->release(m_signMask);
+            if (usesSignMask())
+            {
+                m_signMask = m_sharedResources->getBufferPool()->acquire(getSignMaskWords(p_batchSize * getTotalOutputElements()) * sizeof(cl_uint));
+            }
         }
+
+        void savePreActivationLayer(H5::Group &p_layerGroup) const { saveLayer(p_layerGroup); }
+
+        bool preActivationLayerEquals(const PreActivationLayer &p_other) const { return layerEquals(p_other); }
+
+        void printPreActivationLayer(const cl::CommandQueue &p_queue, const size_t p_batchSize) const { printLayer(p_queue, p_batchSize); }
     };
 }
\ No newline at end of file
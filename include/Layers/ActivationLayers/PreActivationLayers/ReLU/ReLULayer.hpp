@@ -9,16 +9,18 @@ namespace Layers::Activation
         ReLULayer(const size_t p_layerId,
                   std::shared_ptr<Utils::SharedResources> p_sharedResources,
                   const Utils::Dimensions &p_outputDimensions,
-                  const size_t p_batchSize)
-            : PreActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize)
+                  const size_t p_batchSize,
+                  const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : PreActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize, p_mode)
         {
             setupKernels();
         }
 
         ReLULayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                   const H5::Group &p_layerGroup,
-                  const size_t p_batchSize)
-            : PreActivationLayer(p_sharedResources, p_layerGroup, p_batchSize)
+                  const size_t p_batchSize,
+                  const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : PreActivationLayer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
         {
             setupKernels();
         }
@@ -9,16 +9,18 @@ namespace Layers::Activation
         SigmoidLayer(const size_t p_layerId,
                      std::shared_ptr<Utils::SharedResources> p_sharedResources,
                      const Utils::Dimensions &p_outputDimensions,
-                     const size_t p_batchSize)
-            : ActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize)
+                     const size_t p_batchSize,
+                     const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : ActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize, p_mode)
         {
             setupKernels();
         }
 
         SigmoidLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                      const H5::Group &p_layerGroup,
-                     const size_t p_batchSize)
-            : ActivationLayer(p_sharedResources, p_layerGroup, p_batchSize)
+                     const size_t p_batchSize,
+                     const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : ActivationLayer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
         {
             setupKernels();
         }
@@ -27,6 +29,8 @@ namespace Layers::Activation
 
         Utils::LayerType getType() const final override { return Utils::LayerType::Sigmoid; }
 
+        bool isFusable() const final override { return true; }
+
     private:
         void setupKernels() final override;
 
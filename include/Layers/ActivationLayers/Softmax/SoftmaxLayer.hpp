@@ -9,16 +9,18 @@ namespace Layers::Activation
         SoftmaxLayer(const size_t p_layerId,
                      std::shared_ptr<Utils::SharedResources> p_sharedResources,
                      const Utils::Dimensions &p_outputDimensions,
-                     const size_t p_batchSize)
-            : ActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize)
+                     const size_t p_batchSize,
+                     const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : ActivationLayer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize, p_mode)
         {
             setupKernels();
         }
 
         SoftmaxLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                      const H5::Group &p_layerGroup,
-                     const size_t p_batchSize)
-            : ActivationLayer(p_sharedResources, p_layerGroup, p_batchSize)
+                     const size_t p_batchSize,
+                     const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : ActivationLayer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
         {
             setupKernels();
         }
@@ -27,10 +29,28 @@ namespace Layers::Activation
 
         Utils::LayerType getType() const final override { return Utils::LayerType::Softmax; }
 
+        // Rows of at least WORK_GROUP_CLASS_THRESHOLD classes are reduced by one work-group each; narrower
+        // rows keep one work-item per row.
+        bool usesWorkGroupKernels() const { return m_rowLocalSize != 0; }
+
     private:
+        static constexpr size_t WORK_GROUP_CLASS_THRESHOLD = 64;
+        // Must match SOFTMAX_ROW_GROUP_SIZE in HelperFunctions.clh.
+        static constexpr size_t ROW_GROUP_SIZE = 256;
+        size_t m_rowLocalSize = 0;
+
         void setupKernels() final override;
+        size_t selectRowLocalSize(const cl::Kernel &p_forwardKernel, const cl::Kernel &p_backwardKernel) const;
 
-        cl::NDRange getForwardWorkSize(const size_t p_batchSize) const final override { return cl::NDRange(p_batchSize); }
+        cl::NDRange getForwardWorkSize(const size_t p_batchSize) const final override
+        {
+            return usesWorkGroupKernels() ? cl::NDRange(p_batchSize * m_rowLocalSize) : cl::NDRange(p_batchSize);
+        }
+
+        cl::NDRange getWorkGroupSize() const final override
+        {
+            return usesWorkGroupKernels() ? cl::NDRange(m_rowLocalSize) : cl::NullRange;
+        }
 
         void saveSoftmaxLayer(H5::Group &p_layerGroup) const { saveLayer(p_layerGroup); }
         bool softmaxLayerEquals(const SoftmaxLayer &p_other) const { return layerEquals(p_other); }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Utils/BatchCapacity.hpp"
 #include "Utils/Dimensions.hpp"
+#include "Utils/ExecutionMode.hpp"
 #include "Utils/OpenCLResources.hpp"
 #include "Utils/LayerType.hpp"
 
@@ -18,9 +20,11 @@ namespace Layers
         Layer(const size_t p_layerId,
               std::shared_ptr<Utils::SharedResources> p_sharedResources,
               const Utils::Dimensions &p_outputDimensions,
-              const size_t p_batchSize)
+              const size_t p_batchSize,
+              const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
             : m_layerId(p_layerId),
               m_sharedResources(p_sharedResources),
+              m_executionMode(p_mode),
               m_outputDimensions(p_outputDimensions)
         {
             allocateLayerBuffers(p_batchSize);
@@ -28,23 +32,46 @@ namespace Layers
 
         Layer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
               const H5::Group &p_layerGroup,
-              const size_t p_batchSize)
-            : m_sharedResources(p_sharedResources)
+              const size_t p_batchSize,
+              const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : m_sharedResources(p_sharedResources),
+              m_executionMode(p_mode)
         {
             p_layerGroup.openAttribute("layerId").read(H5::PredType::NATIVE_HSIZE, &m_layerId);
             m_outputDimensions = Utils::Dimensions(Utils::readVectorFromHDF5<size_t>(p_layerGroup, "outputDimensions"));
             allocateLayerBuffers(p_batchSize);
         }
 
-        virtual ~Layer() = default;
+        virtual ~Layer()
+        {
+            releaseLayerBuffer(m_outputs, m_plannedOutputs);
+            releaseLayerBuffer(m_deltas, m_plannedDeltas);
+        }
 
         virtual cl::Event runForward(const cl::CommandQueue &p_forwardBackpropQueue, const cl::Buffer &p_inputs, const size_t p_batchSize) = 0;
         virtual cl::Event backpropDeltas(const cl::CommandQueue &p_forwardBackpropQueue, const cl::Buffer &p_previousLayerDeltas, const size_t p_batchSize) = 0;
 
         virtual bool isTrainable() const { return false; }
 
+        virtual bool readsOutputsInBackward() const { return false; }
+
+        virtual std::vector<Utils::BlasShape> getBlasShapes(const size_t) const { return {}; }
+
+        virtual void reserveBlasScratch(const cl::CommandQueue &, Utils::BlasScratch &, const size_t, const Utils::ExecutionMode) const {}
+
+        virtual void assignBlasScratch(const std::shared_ptr<Utils::BlasScratch> &) {}
+
+        virtual void reportMemory(Utils::MemoryTracker &p_tracker) const
+        {
+            p_tracker.record(m_layerId, Utils::MemoryRole::Outputs, m_outputs, m_plannedOutputs);
+            p_tracker.record(m_layerId, Utils::MemoryRole::Deltas, m_deltas, m_plannedDeltas);
+        }
+
         size_t getLayerId() const { return m_layerId; }
 
+        // Inference-only layers never allocate deltas or any other state that only backpropagation reads.
+        bool isInferenceOnly() const { return m_executionMode == Utils::ExecutionMode::Inference; }
+
         cl::Buffer &getOutputs() { return m_outputs; }
 
         cl::Buffer &getDeltas() { return m_deltas; }
@@ -71,25 +98,87 @@ namespace Layers
         virtual void setBatchSize(const size_t p_batchSize)
         {
             allocateLayerBuffers(p_batchSize);
+            bindBufferArgs();
+        }
+
+        void ensureBatchCapacity(const size_t p_batchSize)
+        {
+            if (m_batchSize < p_batchSize)
+            {
+                setBatchSize(Utils::growBatchCapacity(m_batchSize, p_batchSize));
+            }
+        }
+
+        // Points outputs and deltas at regions of a network-owned arena. A null buffer hands that tensor
+        // back to the layer, which then allocates its own again.
+        void assignPlannedBuffers(const cl::Buffer &p_outputs, const cl::Buffer &p_deltas)
+        {
+            assignPlannedBuffer(m_outputs, m_plannedOutputs, p_outputs);
+            if (!isInferenceOnly())
+            {
+                assignPlannedBuffer(m_deltas, m_plannedDeltas, p_deltas);
+            }
+            bindBufferArgs();
         }
 
     protected:
         size_t m_layerId;
         std::shared_ptr<Utils::SharedResources> m_sharedResources;
+        Utils::ExecutionMode m_executionMode = Utils::ExecutionMode::Training;
         size_t m_batchSize;
         Utils::Dimensions m_outputDimensions;
         cl::Buffer m_outputs;
         cl::Buffer m_deltas;
+        bool m_plannedOutputs = false;
+        bool m_plannedDeltas = false;
 
         virtual void setupKernels() = 0;
 
+        virtual void bindBufferArgs() {}
+
         void allocateLayerBuffers(const size_t p_batchSize)
         {
-            m_outputs = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE, p_batchSize * getTotalOutputElements() * sizeof(float));
-            m_deltas = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE, p_batchSize * getTotalOutputElements() * sizeof(float));
+            const std::shared_ptr<Utils::BufferPool> &bufferPool = m_sharedResources->getBufferPool();
+            if (!m_plannedOutputs)
+            {
+                bufferPool->release(m_outputs);
+                m_outputs = bufferPool->acquire(p_batchSize * getTotalOutputElements() * sizeof(float));
+            }
+            if (!m_plannedDeltas && !isInferenceOnly())
+            {
+                bufferPool->release(m_deltas);
+                m_deltas = bufferPool->acquire(p_batchSize * getTotalOutputElements() * sizeof(float));
+            }
             m_batchSize = p_batchSize;
         }
 
+        // The buffer a plan replaces is discarded rather than cached, so planning lowers the device memory
+        // the network holds instead of parking every layer's tensors in the shared pool.
+        void assignPlannedBuffer(cl::Buffer &p_buffer, bool &p_planned, const cl::Buffer &p_plannedBuffer)
+        {
+            if (p_planned || p_plannedBuffer() == nullptr)
+            {
+                releaseLayerBuffer(p_buffer, p_planned);
+            }
+            else
+            {
+                m_sharedResources->getBufferPool()->discard(p_buffer);
+            }
+            p_planned = p_plannedBuffer() != nullptr;
+            p_buffer = p_planned ? p_plannedBuffer : m_sharedResources->getBufferPool()->acquire(m_batchSize * getTotalOutputElements() * sizeof(float));
+        }
+
+        // Planned buffers alias other layers' tensors, so they must never reach the pool's free lists.
+        void releaseLayerBuffer(cl::Buffer &p_buffer, const bool p_planned)
+        {
+            if (p_planned)
+            {
+                p_buffer = cl::Buffer();
+                return;
+            }
+            m_sharedResources->getBufferPool()->release(p_buffer);
+        }
+
         std::vector<float> getLayerSerializedArgs() const { return {static_cast<float>(getType())}; }
 
         void saveLayer(H5::Group &p_layerGroup) const
@@ -112,7 +201,10 @@ namespace Layers
             std::cout << "Layer Type: " << Utils::layerTypeToString(getType()) << "\n";
             std::cout << "Output Dimensions: " << m_outputDimensions.toString() << "\n";
             Utils::printCLBuffer(p_queue, m_outputs, p_batchSize * getTotalOutputElements(), "Outputs");
-            Utils::printCLBuffer(p_queue, m_deltas, p_batchSize * getTotalOutputElements(), "Deltas");
+            if (!isInferenceOnly())
+            {
+                Utils::printCLBuffer(p_queue, m_deltas, p_batchSize * getTotalOutputElements(), "Deltas");
+            }
         }
     };
 }
@@ -5,6 +5,7 @@
 #include "Utils/StrideDimensions.hpp"
 #include "Utils/PaddingValues.hpp"
 #include "Utils/PaddingType.hpp"
+#include <algorithm>
 namespace Layers::Trainable
 {
     class ConvolutionalLayer : public TrainableLayer
@@ -17,11 +18,14 @@ namespace Layers::Trainable
                            const Utils::StrideDimensions &p_strideDimensions,
                            const Utils::PaddingType p_paddingType,
                            const size_t p_batchSize,
-                           std::mt19937 &p_rng);
+                           std::mt19937 &p_rng,
+                           const bool p_specializeKernels = false,
+                           const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training);
 
         ConvolutionalLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                            const H5::Group &p_layerGroup,
-                           const size_t p_batchSize);
+                           const size_t p_batchSize,
+                           const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training);
 
         ~ConvolutionalLayer() = default;
 
@@ -33,6 +37,42 @@ namespace Layers::Trainable
 
         size_t getWeightsSize() const final override { return getOutputChannels() * getInputChannels() * m_filterDimensions.getHeight() * m_filterDimensions.getWidth(); }
         size_t getBiasesSize() const final override { return getOutputChannels(); }
+
+        std::vector<Utils::BlasShape> getBlasShapes(const size_t p_batchSize) const final override
+        {
+            std::vector<Utils::BlasShape> shapes = {Utils::BlasShape::convgemm(getOutputHeight() * getOutputWidth(), getOutputChannels(), getPatchSize())};
+            if (!isInferenceOnly())
+            {
+                size_t columns = getGradientChunkSize(p_batchSize) * getOutputHeight() * getOutputWidth();
+                for (bool direct : {false, true})
+                {
+                    shapes.push_back(Utils::BlasShape::rowMajorGemm(getOutputChannels(), getPatchSize(), columns, direct));
+                }
+            }
+            return shapes;
+        }
+
+        void reserveBlasScratch(const cl::CommandQueue &p_queue, Utils::BlasScratch &p_scratch, const size_t p_batchSize, const Utils::ExecutionMode p_mode) const final override;
+
+        // A null scratch hands the layer back a private one, which only holds the im2col columns and is
+        // allocated on the first computeGradients(); CLBlast then allocates its temporary buffers itself.
+        void assignBlasScratch(const std::shared_ptr<Utils::BlasScratch> &p_scratch) final override
+        {
+            m_sharedBlasScratch = p_scratch != nullptr;
+            m_blasScratch = p_scratch;
+        }
+
+        const std::shared_ptr<Utils::BlasScratch> &getBlasScratch() const { return m_blasScratch; }
+
+        void reportMemory(Utils::MemoryTracker &p_tracker) const final override
+        {
+            TrainableLayer::reportMemory(p_tracker);
+            if (m_blasScratch && !m_sharedBlasScratch)
+            {
+                p_tracker.record(m_layerId, Utils::MemoryRole::Workspace, m_blasScratch->getAllocatedBytes());
+            }
+        }
+
         const std::vector<float> getSerializedArgs() const final override
         {
             std::vector<float> layerArgs = getLayerSerializedArgs();
@@ -53,7 +93,12 @@ namespace Layers::Trainable
         void setBatchSize(const size_t p_batchSize) final override
         {
             allocateLayerBuffers(p_batchSize);
-            Utils::setKernelArgs(1, m_biasKernel, getOutputs());
+            bindBufferArgs();
+
+            if (m_blasScratch && !m_sharedBlasScratch)
+            {
+                allocateGradientScratch(p_batchSize);
+            }
         }
 
         size_t getInputChannels() const { return m_inputDimensions.getDimensions()[0]; }
@@ -64,26 +109,54 @@ namespace Layers::Trainable
         size_t getOutputHeight() const { return m_outputDimensions.getDimensions()[1]; }
         size_t getOutputWidth() const { return m_outputDimensions.getDimensions()[2]; }
 
+        size_t getPatchSize() const { return getInputChannels() * m_filterDimensions.getHeight() * m_filterDimensions.getWidth(); }
+
+        // Samples whose im2col columns and gathered deltas fit the column budget together, at least one.
+        size_t getGradientChunkSize(const size_t p_batchSize) const
+        {
+            size_t sampleBytes = (getPatchSize() + getOutputChannels()) * getOutputHeight() * getOutputWidth() * sizeof(float);
+            return std::clamp(m_gradientColumnsBudget / sampleBytes, size_t(1), std::max(p_batchSize, size_t(1)));
+        }
+
+        // Defaults to a quarter of the smallest CL_DEVICE_MAX_MEM_ALLOC_SIZE of the context's devices, and
+        // never exceeds that allocation limit. Inside a network, set it before the memory is planned.
+        void setGradientColumnsBudget(const size_t p_bytes);
+        size_t getGradientColumnsBudget() const { return m_gradientColumnsBudget; }
+
         Utils::PaddingValues getPaddingValues() const { return m_paddingValues; }
         Utils::StrideDimensions getStrideDimensions() const { return m_strideDimensions; }
         Utils::FilterDimensions getFilterDimensions() const { return m_filterDimensions; }
+        bool getSpecializeKernels() const { return m_specializeKernels; }
 
     private:
+        cl::Program m_shapeProgram;
         cl::Kernel m_backpropDeltasKernel;
-        cl::Kernel m_computeWeightsGradientsKernel;
         cl::Kernel m_computeBiasesGradientsKernel;
+        // One im2col and one gather kernel per chunk of the batch, so that recorded steps keep each chunk's arguments.
+        std::vector<cl::Kernel> m_im2colKernels;
+        std::vector<cl::Kernel> m_gatherDeltasKernels;
+        std::shared_ptr<Utils::BlasScratch> m_blasScratch;
+        bool m_sharedBlasScratch = false;
+        size_t m_gradientColumnsBudget = 0;
 
         Utils::FilterDimensions m_filterDimensions;
         Utils::StrideDimensions m_strideDimensions;
         Utils::PaddingValues m_paddingValues;
         Utils::PaddingType m_paddingType;
+        bool m_specializeKernels = false;
 
         void allocateConvolutionalLayerBuffers();
+        void allocateGradientScratch(const size_t p_batchSize);
+        size_t getMaxAllocationSize() const;
+        void ensureGradientChunkKernels(const size_t p_chunks);
+        std::string getSpecializationDefines() const;
         Utils::Dimensions calculateOutputDimensions(const Utils::Dimensions &p_inputDimensions, const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions, Utils::PaddingType p_paddingType) const;
         Utils::Dimensions calculateOutputDimensions() const;
         Utils::PaddingValues calculatePaddingValues(const Utils::Dimensions &p_inputDimensions, const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions, const Utils::PaddingType p_paddingType) const;
         void initializeWeightsAndBiases(std::mt19937 &p_rng) final override;
         void setupKernels() final override;
+        void bindBufferArgs() final override;
+        void bindParameterArgs() final override;
         Utils::Dimensions validateInputDimensions(const Utils::Dimensions &p_inputDimensions, const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions) const;
 
         void saveConvolutionalLayer(const cl::CommandQueue &p_queue, H5::Group &p_layerGroup) const
@@ -93,6 +166,7 @@ namespace Layers::Trainable
             Utils::writeVectorToHDF5<size_t>(p_layerGroup, "strideDimensions", m_strideDimensions.getDimensions());
             Utils::writeVectorToHDF5<size_t>(p_layerGroup, "paddingValues", m_paddingValues.getDimensions());
             Utils::writeValueToHDF5<unsigned int>(p_layerGroup, "paddingType", static_cast<unsigned int>(m_paddingType));
+            Utils::writeValueToHDF5<bool>(p_layerGroup, "specializeKernels", m_specializeKernels);
         }
 
         bool convolutionalLayerEquals(const cl::CommandQueue &p_queue, const Layer &p_other) const
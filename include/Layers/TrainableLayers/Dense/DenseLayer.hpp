@@ -11,13 +11,13 @@ namespace Layers::Trainable
                    const Utils::Dimensions &p_inputDimensions,
                    const Utils::Dimensions &p_outputDimensions,
                    const size_t p_batchSize,
-                   std::mt19937 &p_rng);
+                   std::mt19937 &p_rng,
+                   const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training);
 
         DenseLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                    const H5::Group &p_layerGroup,
-                   const size_t p_batchSize);
-
-        ~DenseLayer() = default;
+                   const size_t p_batchSize,
+                   const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training);
 
         cl::Event runForward(const cl::CommandQueue &p_forwardBackpropQueue, const cl::Buffer &p_inputs, const size_t p_batchSize) final override;
         cl::Event backpropDeltas(const cl::CommandQueue &p_forwardBackpropQueue, const cl::Buffer &p_previousLayerDeltas, const size_t p_batchSize) final override;
@@ -28,10 +28,45 @@ namespace Layers::Trainable
         size_t getWeightsSize() const final override { return getTotalInputElements() * getTotalOutputElements(); };
         size_t getBiasesSize() const final override { return getTotalOutputElements(); }
 
-        cl::Buffer &getOnesBuffer() { return m_onesBuffer; }
+        std::vector<Utils::BlasShape> getBlasShapes(const size_t p_batchSize) const final override
+        {
+            size_t flatInputSize = getTotalInputElements();
+            size_t flatOutputSize = getTotalOutputElements();
+            std::vector<Utils::BlasShape> shapes;
+            for (bool direct : {false, true})
+            {
+                shapes.push_back(Utils::BlasShape::rowMajorGemm(p_batchSize, flatOutputSize, flatInputSize, direct));
+                shapes.push_back(Utils::BlasShape::rowMajorGemm(p_batchSize, flatInputSize, flatOutputSize, direct));
+                shapes.push_back(Utils::BlasShape::rowMajorGemm(flatOutputSize, flatInputSize, p_batchSize, direct));
+            }
+            shapes.push_back(Utils::BlasShape::rowMajorGemv(p_batchSize, flatOutputSize));
+            return shapes;
+        }
+
+        void reserveBlasScratch(const cl::CommandQueue &p_queue, Utils::BlasScratch &p_scratch, const size_t p_batchSize, const Utils::ExecutionMode p_mode) const final override;
 
-        cl::Buffer &getclblastWorkspace() { return m_clblastWorkspace; }
-        cl::Buffer &getclblastDeltaWorkspace() { return m_clblastDeltaWorkspace; }
+        // A null scratch hands the layer back its private one, which only holds the ones vector; CLBlast
+        // then allocates its temporary buffers itself.
+        void assignBlasScratch(const std::shared_ptr<Utils::BlasScratch> &p_scratch) final override
+        {
+            m_sharedBlasScratch = p_scratch != nullptr;
+            m_blasScratch = p_scratch;
+            if (!m_sharedBlasScratch)
+            {
+                allocateDenseBatchBuffers(m_batchSize);
+            }
+        }
+
+        const std::shared_ptr<Utils::BlasScratch> &getBlasScratch() const { return m_blasScratch; }
+
+        void reportMemory(Utils::MemoryTracker &p_tracker) const final override
+        {
+            TrainableLayer::reportMemory(p_tracker);
+            if (m_blasScratch && !m_sharedBlasScratch)
+            {
+                p_tracker.record(m_layerId, Utils::MemoryRole::Workspace, m_blasScratch->getAllocatedBytes());
+            }
+        }
 
         const std::vector<float> getSerializedArgs() const final override
         {
@@ -43,32 +78,31 @@ namespace Layers::Trainable
         void setBatchSize(const size_t p_batchSize) final override
         {
             allocateLayerBuffers(p_batchSize);
-            Utils::setKernelArgs(1, m_biasKernel, getOutputs());
-
-            m_onesBuffer = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, p_batchSize * sizeof(float), std::vector<float>(p_batchSize, 1.0f).data());
-
-            size_t flatInputSize = m_inputDimensions.getTotalElements();
-            size_t flatOutputSize = m_outputDimensions.getTotalElements();
+            bindBufferArgs();
 
-            m_clblastWorkspace = cl::Buffer(
-                m_sharedResources->getContext(),
-                CL_MEM_READ_WRITE,
-                std::max({p_batchSize * flatOutputSize, flatOutputSize * flatInputSize}) * sizeof(float));
-
-            m_clblastDeltaWorkspace = cl::Buffer(
-                m_sharedResources->getContext(),
-                CL_MEM_READ_WRITE,
-                std::max({p_batchSize * flatInputSize, flatInputSize * flatOutputSize}) * sizeof(float));
+            allocateDenseBatchBuffers(p_batchSize);
         }
 
     private:
-        cl::Buffer m_onesBuffer;
-        cl::Buffer m_clblastWorkspace;
-        cl::Buffer m_clblastDeltaWorkspace;
+        std::shared_ptr<Utils::BlasScratch> m_blasScratch;
+        bool m_sharedBlasScratch = false;
 
         void allocateDenseLayerBuffers(const size_t p_batchSize);
+        void allocateDenseBatchBuffers(const size_t p_batchSize);
+        cl_mem getForwardBackpropWorkspace() const;
         void initializeWeightsAndBiases(std::mt19937 &p_rng) final override;
         void setupKernels() final override;
+        void bindBufferArgs() final override
+        {
+            Utils::setKernelArgs(1, m_biasKernel, getOutputs());
+            Utils::setKernelArgs(1, m_fusedBiasKernel, getOutputs());
+        }
+
+        void bindParameterArgs() final override
+        {
+            Utils::setKernelArgs(m_biasKernel, getBiases());
+            Utils::setKernelArgs(m_fusedBiasKernel, getBiases());
+        }
 
         void saveDenseLayer(const cl::CommandQueue &p_queue, H5::Group &p_layerGroup) const { saveTrainableLayer(p_queue, p_layerGroup); }
         bool denseLayerEquals(const cl::CommandQueue &p_queue, const Layer &p_other) const { return trainableLayerEquals(p_queue, p_other); }
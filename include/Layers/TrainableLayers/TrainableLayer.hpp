@@ -13,21 +13,26 @@ namespace Layers::Trainable
                        std::shared_ptr<Utils::SharedResources> p_sharedResources,
                        const Utils::Dimensions &p_inputDimensions,
                        const Utils::Dimensions &p_outputDimensions,
-                       const size_t p_batchSize)
-            : Layer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize),
+                       const size_t p_batchSize,
+                       const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : Layer(p_layerId, p_sharedResources, p_outputDimensions, p_batchSize, p_mode),
               m_inputDimensions(p_inputDimensions)
         {
         }
 
         TrainableLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                        const H5::Group &p_layerGroup,
-                       const size_t p_batchSize)
-            : Layer(p_sharedResources, p_layerGroup, p_batchSize)
+                       const size_t p_batchSize,
+                       const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training)
+            : Layer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
         {
             m_inputDimensions = Utils::Dimensions(Utils::readVectorFromHDF5<size_t>(p_layerGroup, "inputDimensions"));
         }
 
-        virtual ~TrainableLayer() = default;
+        virtual ~TrainableLayer()
+        {
+            releaseParameterBuffers();
+        }
 
         virtual std::pair<cl::Event, cl::Event> computeGradients(const cl::CommandQueue &p_deltaToGradientQueue, cl::Event p_backpropEvent, const cl::Buffer &p_inputs, const size_t p_batchSize) = 0;
 
@@ -100,6 +105,46 @@ namespace Layers::Trainable
         cl::Buffer &getWeightsGradients() { return m_weightsGradients; }
         cl::Buffer &getBiasesGradients() { return m_biasesGradients; }
 
+        // Moves the parameters into regions of a network-owned parameter arena, copying their current values.
+        void assignParameterRegions(const cl::CommandQueue &p_queue,
+                                    const cl::Buffer &p_weights, const cl::Buffer &p_biases,
+                                    const cl::Buffer &p_weightsGradients, const cl::Buffer &p_biasesGradients)
+        {
+            p_queue.enqueueCopyBuffer(m_weights, p_weights, NO_OFFSET, NO_OFFSET, getWeightsSize() * sizeof(float));
+            p_queue.enqueueCopyBuffer(m_biases, p_biases, NO_OFFSET, NO_OFFSET, getBiasesSize() * sizeof(float));
+            p_queue.finish();
+            releaseParameterBuffers();
+            m_weights = p_weights;
+            m_biases = p_biases;
+            m_weightsGradients = p_weightsGradients;
+            m_biasesGradients = p_biasesGradients;
+            m_packedParameters = true;
+            bindParameterArgs();
+        }
+
+        bool hasPackedParameters() const { return m_packedParameters; }
+
+        // Folds the elementwise activation that follows this layer into its bias kernel, which then writes the
+        // activated values into p_activatedOutputs. The layer's own outputs only hold the product without biases.
+        void fuseActivation(const Utils::LayerType p_activation, const float p_alpha, const cl::Buffer &p_activatedOutputs)
+        {
+            Utils::setKernelArgs(m_fusedBiasKernel, getBiases(), getOutputs(), p_activatedOutputs, static_cast<cl_uint>(p_activation), p_alpha);
+            m_activationFused = true;
+        }
+
+        void clearFusedActivation() { m_activationFused = false; }
+
+        bool hasFusedActivation() const { return m_activationFused; }
+
+        void reportMemory(Utils::MemoryTracker &p_tracker) const override
+        {
+            Layer::reportMemory(p_tracker);
+            p_tracker.record(m_layerId, Utils::MemoryRole::Weights, m_weights, m_packedParameters);
+            p_tracker.record(m_layerId, Utils::MemoryRole::Weights, m_biases, m_packedParameters);
+            p_tracker.record(m_layerId, Utils::MemoryRole::Gradients, m_weightsGradients, m_packedParameters);
+            p_tracker.record(m_layerId, Utils::MemoryRole::Gradients, m_biasesGradients, m_packedParameters);
+        }
+
         virtual size_t getWeightsSize() const = 0;
         virtual size_t getBiasesSize() const = 0;
 
@@ -114,13 +159,39 @@ namespace Layers::Trainable
         cl::Buffer m_biases;
         cl::Buffer m_weightsGradients;
         cl::Buffer m_biasesGradients;
+        bool m_packedParameters = false;
 
         cl::Kernel m_biasKernel;
+        cl::Kernel m_fusedBiasKernel;
+        bool m_activationFused = false;
 
         virtual void initializeWeightsAndBiases(std::mt19937 &p_rng) = 0;
 
         void setupTrainableKernels() {}
 
+        const cl::Kernel &getBiasKernel() const { return m_activationFused ? m_fusedBiasKernel : m_biasKernel; }
+
+        virtual void bindParameterArgs() {}
+
+        // Packed parameters are views into the arena and must never reach the pool's free lists.
+        void releaseParameterBuffers()
+        {
+            if (m_packedParameters)
+            {
+                m_weights = cl::Buffer();
+                m_biases = cl::Buffer();
+                m_weightsGradients = cl::Buffer();
+                m_biasesGradients = cl::Buffer();
+                m_packedParameters = false;
+                return;
+            }
+            const std::shared_ptr<Utils::BufferPool> &bufferPool = m_sharedResources->getBufferPool();
+            bufferPool->release(m_weights);
+            bufferPool->release(m_biases);
+            bufferPool->release(m_weightsGradients);
+            bufferPool->release(m_biasesGradients);
+        }
+
         void saveTrainableLayer(const cl::CommandQueue &p_queue, H5::Group &p_layerGroup) const
         {
             saveLayer(p_layerGroup);
@@ -147,8 +218,11 @@ namespace Layers::Trainable
             std::cout << "Biases Size: " << getBiasesSize() << "\n";
             Utils::printCLBuffer(p_queue, m_weights, getWeightsSize(), "Weights");
             Utils::printCLBuffer(p_queue, m_biases, getBiasesSize(), "Biases");
-            Utils::printCLBuffer(p_queue, m_weightsGradients, getWeightsSize(), "Weight Gradients");
-            Utils::printCLBuffer(p_queue, m_biasesGradients, getBiasesSize(), "Bias Gradients");
+            if (!isInferenceOnly())
+            {
+                Utils::printCLBuffer(p_queue, m_weightsGradients, getWeightsSize(), "Weight Gradients");
+                Utils::printCLBuffer(p_queue, m_biasesGradients, getBiasesSize(), "Bias Gradients");
+            }
         }
     };
 }
\ No newline at end of file
@@ -62,6 +62,48 @@ namespace LossFunctions
                                               size_t outputElements,
                                               size_t batchSize) = 0;
 
+        // Adds the loss of one batch to a device scalar, so reporting reads back one float per interval
+        // instead of the predictions of every step.
+        virtual cl::Event accumulateLoss(const cl::CommandQueue &p_queue,
+                                         const cl::Buffer &p_predictions,
+                                         const cl::Buffer &p_targets,
+                                         size_t p_outputElements,
+                                         size_t p_batchSize) = 0;
+
+        // computeLossGradient followed by accumulateLoss on the same in-order queue. Losses whose gradient pass
+        // already sees every sample's loss override it to skip the second read of the predictions.
+        virtual cl::Event computeLossGradientAndAccumulateLoss(const cl::CommandQueue &p_queue,
+                                                               const cl::Buffer &p_predictions,
+                                                               const cl::Buffer &p_targets,
+                                                               cl::Buffer &p_outputGradients,
+                                                               size_t p_outputElements,
+                                                               size_t p_batchSize)
+        {
+            cl::Event gradientEvent = computeLossGradient(p_queue, p_predictions, p_targets, p_outputGradients, p_outputElements, p_batchSize);
+            accumulateLoss(p_queue, p_predictions, p_targets, p_outputElements, p_batchSize);
+            return gradientEvent;
+        }
+
+        void resetLossSum(const cl::CommandQueue &p_queue)
+        {
+            if (m_lossSum() == nullptr)
+            {
+                m_lossSum = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE, sizeof(float));
+            }
+            p_queue.enqueueFillBuffer(m_lossSum, 0.0f, NO_OFFSET, sizeof(float));
+        }
+
+        // Blocks until every accumulation enqueued on p_queue so far is done.
+        float readLossSum(const cl::CommandQueue &p_queue) const
+        {
+            float lossSum = 0.0f;
+            if (m_lossSum() != nullptr)
+            {
+                p_queue.enqueueReadBuffer(m_lossSum, BLOCKING_READ, NO_OFFSET, sizeof(float), &lossSum);
+            }
+            return lossSum;
+        }
+
         virtual bool equals(const LossFunction &other) const
         {
             return getType() == other.getType();
@@ -78,9 +120,71 @@ namespace LossFunctions
     protected:
         std::shared_ptr<Utils::SharedResources> m_sharedResources;
         cl::Kernel m_gradientKernel;
+        cl::Kernel m_lossKernel;
+        cl::Buffer m_lossSum;
+
+        // Work-items of one accumulation launch; each sums a strided share of the units.
+        static constexpr size_t LOSS_WORK_ITEMS = 1024;
+        // Must match LOSS_GROUP_SIZE in HelperFunctions.clh.
+        static constexpr size_t LOSS_GROUP_SIZE = 256;
+        size_t m_lossLocalSize = 0;
 
         virtual void setupKernel() = 0;
 
+        cl::Event enqueueLossKernel(const cl::CommandQueue &p_queue,
+                                    const cl::Buffer &p_predictions,
+                                    const cl::Buffer &p_targets,
+                                    size_t p_units,
+                                    size_t p_outputElements,
+                                    float p_scale)
+        {
+            ensureLossSum(p_queue);
+            Utils::setKernelArgs(m_lossKernel, p_predictions, p_targets, m_lossSum, (cl_uint)p_units, (cl_uint)p_outputElements, p_scale);
+            return launchLossKernel(p_queue, p_units);
+        }
+
+        void ensureLossSum(const cl::CommandQueue &p_queue)
+        {
+            if (m_lossSum() == nullptr)
+            {
+                resetLossSum(p_queue);
+            }
+        }
+
+        // Enqueues m_lossKernel with its arguments already set, over p_units grid-strided units.
+        cl::Event launchLossKernel(const cl::CommandQueue &p_queue, size_t p_units, const std::vector<cl::Event> *p_waitList = nullptr)
+        {
+            size_t localSize = getLossLocalSize();
+            size_t globalSize = (std::min(p_units, LOSS_WORK_ITEMS) + localSize - 1) / localSize * localSize;
+            cl::Event kernelEvent;
+            cl_int err = m_sharedResources->enqueueKernel(p_queue, m_lossKernel, cl::NDRange(globalSize), cl::NDRange(localSize), p_waitList, &kernelEvent);
+            if (err != CL_SUCCESS)
+            {
+                std::cerr << "Error: Failed to enqueue " << Utils::lossFunctionTypeToString(getType()) << " loss kernel. Error code: " << err << std::endl;
+                throw std::runtime_error("Failed to enqueue loss accumulation kernel. Error code: " + std::to_string(err));
+            }
+            return kernelEvent;
+        }
+
+        // The largest power of two the reduction's local array and every device allow.
+        size_t getLossLocalSize()
+        {
+            if (m_lossLocalSize == 0)
+            {
+                size_t limit = LOSS_GROUP_SIZE;
+                for (const cl::Device &device : m_sharedResources->getDevices())
+                {
+                    limit = std::min(limit, m_lossKernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device));
+                }
+                m_lossLocalSize = 1;
+                while (m_lossLocalSize * 2 <= limit)
+                {
+                    m_lossLocalSize *= 2;
+                }
+            }
+            return m_lossLocalSize;
+        }
+
         virtual float computeLoss(const std::vector<float> &predictions,
                                   const std::vector<float> &targets,
                                   size_t outputElements,
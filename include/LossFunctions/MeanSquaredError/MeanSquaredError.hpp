@@ -22,6 +22,12 @@ namespace LossFunctions
                                       const size_t p_outputElements,
                                       const size_t p_batchSize) override;
 
+        cl::Event accumulateLoss(const cl::CommandQueue &p_queue,
+                                 const cl::Buffer &p_predictions,
+                                 const cl::Buffer &p_targets,
+                                 size_t p_outputElements,
+                                 size_t p_batchSize) override;
+
     private:
         void setupKernel() override;
         float computeLoss(const std::vector<float> &p_predictions,
@@ -10,6 +10,8 @@ namespace LossFunctions
         SoftmaxCrossEntropy(std::shared_ptr<Utils::SharedResources> p_sharedResources)
             : LossFunction(p_sharedResources) { setupKernel(); }
 
+        ~SoftmaxCrossEntropy() override { m_sharedResources->getBufferPool()->release(m_sampleLosses); }
+
         Utils::LossFunctionType getType() const override
         {
             return Utils::LossFunctionType::SoftmaxCrossEntropy;
@@ -22,8 +24,50 @@ namespace LossFunctions
                                       const size_t p_outputElements,
                                       const size_t p_batchSize) override;
 
+        // Same single pass as computeLossGradient, which also writes the cross-entropy of each sample's
+        // softmax to p_sampleLosses (p_batchSize floats).
+        cl::Event computeLossGradientAndSampleLosses(const cl::CommandQueue &p_queue,
+                                                     const cl::Buffer &p_logits,
+                                                     const cl::Buffer &p_targets,
+                                                     cl::Buffer &p_outputGradients,
+                                                     cl::Buffer &p_sampleLosses,
+                                                     const size_t p_outputElements,
+                                                     const size_t p_batchSize);
+
+        // Both run the row kernel into a batch-sized scratch of per-sample losses and reduce that scratch.
+        cl::Event accumulateLoss(const cl::CommandQueue &p_queue,
+                                 const cl::Buffer &p_predictions,
+                                 const cl::Buffer &p_targets,
+                                 size_t p_outputElements,
+                                 size_t p_batchSize) override;
+
+        cl::Event computeLossGradientAndAccumulateLoss(const cl::CommandQueue &p_queue,
+                                                       const cl::Buffer &p_predictions,
+                                                       const cl::Buffer &p_targets,
+                                                       cl::Buffer &p_outputGradients,
+                                                       size_t p_outputElements,
+                                                       size_t p_batchSize) override;
+
     private:
+        // Must match SOFTMAX_ROW_GROUP_SIZE in HelperFunctions.clh.
+        static constexpr size_t ROW_GROUP_SIZE = 256;
+        size_t m_maxRowLocalSize = 0;
+        cl::Buffer m_sampleLosses;
+        size_t m_sampleLossCapacity = 0;
+
         void setupKernel() override;
+        cl::Event enqueueGradientKernel(const cl::CommandQueue &p_queue,
+                                        const cl::Buffer &p_logits,
+                                        const cl::Buffer &p_targets,
+                                        cl::Buffer &p_outputGradients,
+                                        const cl::Buffer &p_sampleLosses,
+                                        bool p_writeLosses,
+                                        bool p_writeGradients,
+                                        size_t p_outputElements,
+                                        size_t p_batchSize);
+        const cl::Buffer &getSampleLosses(size_t p_batchSize);
+        cl::Event accumulateSampleLosses(const cl::CommandQueue &p_queue, const cl::Event &p_lossesEvent, size_t p_batchSize);
+        size_t getRowLocalSize(const cl::CommandQueue &p_queue, size_t p_outputElements);
         float computeLoss(const std::vector<float> &p_predictions,
                           const std::vector<float> &p_targets,
                           size_t p_outputElements,
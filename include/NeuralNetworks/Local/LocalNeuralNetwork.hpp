@@ -1,6 +1,8 @@
 #pragma once
 
 #include "NeuralNetworks/NeuralNetwork.hpp"
+#include "Utils/MemoryPlanner.hpp"
+#include <deque>
 
 namespace NeuralNetworks::Local
 {
@@ -12,20 +14,85 @@ namespace NeuralNetworks::Local
         LocalNeuralNetwork(Utils::OpenCLResources &&p_oclResources,
                            const Utils::NetworkArgs &p_networkArgs,
                            const size_t p_seed,
-                           const size_t p_batchSize);
+                           const size_t p_batchSize,
+                           const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training);
+
+        LocalNeuralNetwork(LocalNeuralNetwork &&) = default;
+        LocalNeuralNetwork &operator=(LocalNeuralNetwork &&) = default;
+        ~LocalNeuralNetwork();
 
         std::vector<float> predict(const cl::Buffer &p_inputBatch, size_t p_batchSize);
         double trainStep(const Utils::Batch &p_batch, bool p_lossReporting = false);
         void train(DataLoaders::DataLoader &p_dataLoader, int p_epochs, bool p_lossReporting = false);
         cl::Event forward(const cl::Buffer &p_batchInputs, size_t p_batchSize);
-        double computeLossAsync(cl::Event p_forwardEvent, const std::vector<float> &p_batchTargets, const size_t p_batchSize);
         cl::Event computeLossGradients(const cl::Buffer &p_batchTargets, const size_t p_batchSize);
         void uploadOutputDeltas(const std::vector<float> &p_hostGradients);
         void copyOutputDeltasFromBuffer(const cl::Buffer &p_deviceGradients, const size_t p_batchSize);
         void backward(cl::Event p_deltaEvent, const cl::Buffer &p_batchInputs, const size_t p_batchSize);
 
+        std::vector<Utils::BlasShape> getBlasShapes() const;
+        void tuneBlasKernels(double p_fraction = 1.0);
+
+        void planMemory(Utils::ExecutionMode p_mode);
+        Utils::ExecutionMode getExecutionMode() const { return m_executionMode; }
+        bool isInferenceOnly() const { return m_inferenceOnly; }
+        size_t getActivationArenaSize() const { return m_activationArenaSize; }
+        size_t getUnplannedActivationSize() const { return m_unplannedActivationSize; }
+        const std::shared_ptr<Utils::BlasScratch> &getBlasScratch() const { return m_blasScratch; }
+        const Utils::ParameterArena *getParameterArena() const { return m_parameterArena.get(); }
+
+        // Re-measures every buffer the network holds; planning memory and new batch sizes do this automatically.
+        void refreshMemoryUsage();
+        const Utils::MemoryTracker &getMemoryTracker() const { return m_memoryTracker; }
+
+        // Keeps only every p_segmentLength-th output (ceil(sqrt(L)) when 0) through backpropagation and
+        // recomputes the outputs between those checkpoints segment by segment during backward().
+        void setGradientCheckpointing(const bool p_enabled, const size_t p_segmentLength = 0)
+        {
+            m_gradientCheckpointing = p_enabled;
+            m_checkpointSegmentLength = p_segmentLength;
+            m_memoryPlanStale = true;
+        }
+
+        bool isGradientCheckpointing() const { return m_gradientCheckpointing; }
+
+        // Folds every ReLU, LeakyReLU (alpha >= 0), Sigmoid or Tanh that directly follows a dense or
+        // convolutional layer into that layer's bias kernel. The activation's forward pass is skipped, and its
+        // backward pass runs in place on the deltas it shares with the layer. On by default.
+        void setActivationFusion(const bool p_enabled)
+        {
+            m_activationFusion = p_enabled;
+            m_memoryPlanStale = true;
+        }
+
+        bool isActivationFusion() const { return m_activationFusion; }
+        bool isActivationFused(const size_t p_layer) const { return p_layer < m_fusedActivations.size() && m_fusedActivations[p_layer]; }
+        std::vector<std::pair<size_t, size_t>> getCheckpointSegments() const;
+
+        // Records the commands of one training step and replays them for later steps with the same batch
+        // size. Batches are copied into network-owned step buffers so the recorded commands stay valid.
+        void setCompiledSteps(const bool p_enabled)
+        {
+            m_compiledSteps = p_enabled;
+            m_stepRecording.clear();
+        }
+
+        bool isCompiledSteps() const { return m_compiledSteps; }
+        size_t getRecordedCommandCount() const { return m_stepRecording.getCommandCount(); }
+
+        // Number of training steps train() keeps in flight. With a depth above 1 the forward pass of a
+        // step waits for the previous optimizer update on the device instead of the host draining the
+        // queues. 1 runs the steps one after another.
+        void setPipelineDepth(const size_t p_depth);
+        size_t getPipelineDepth() const { return m_pipelineDepth; }
+
+        // train() accumulates the loss on the device and reads it back every p_steps steps, or only at the
+        // end of each epoch when 0.
+        void setLossReadbackInterval(const size_t p_steps) { m_lossReadbackInterval = p_steps; }
+        size_t getLossReadbackInterval() const { return m_lossReadbackInterval; }
+
         LocalNeuralNetwork &addDense(const size_t p_numOutputNeurons);
-        LocalNeuralNetwork &addConvolutional(const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions, const Utils::PaddingType p_paddingType);
+        LocalNeuralNetwork &addConvolutional(const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions, const Utils::PaddingType p_paddingType, const bool p_specializeKernels = false);
         LocalNeuralNetwork &addLeakyReLU(float p_alpha);
         LocalNeuralNetwork &addReLU();
         LocalNeuralNetwork &addSigmoid();
@@ -33,7 +100,8 @@ namespace NeuralNetworks::Local
         LocalNeuralNetwork &addSoftmax();
 
         void save(const std::string &p_fileName) const;
-        static LocalNeuralNetwork load(std::shared_ptr<Utils::SharedResources> p_sharedResources, const std::string &p_fileName, const size_t p_batchSize);
+        static LocalNeuralNetwork load(std::shared_ptr<Utils::SharedResources> p_sharedResources, const std::string &p_fileName, const size_t p_batchSize,
+                                       const Utils::ExecutionMode p_mode = Utils::ExecutionMode::Training);
         bool equals(const LocalNeuralNetwork &p_other) const;
         void print() const;
 
@@ -44,11 +112,13 @@ namespace NeuralNetworks::Local
 
         void setBatchSize(const size_t p_batchSize) override
         {
+            finishQueues();
             m_batchSize = p_batchSize;
             for (auto &layer : m_layers)
             {
                 layer->setBatchSize(p_batchSize);
             }
+            planMemory(m_executionMode);
         }
 
         Utils::NetworkType getType() const final override { return Utils::NetworkType::Local; }
@@ -56,7 +126,80 @@ namespace NeuralNetworks::Local
     private:
         std::unique_ptr<Optimizers::Optimizer> m_optimizer;
         std::mt19937 m_rng;
+        Utils::ExecutionMode m_executionMode = Utils::ExecutionMode::Training;
+        bool m_inferenceOnly = false;
+        cl::Buffer m_activationArena;
+        size_t m_activationArenaSize = 0;
+        size_t m_unplannedActivationSize = 0;
+        bool m_memoryPlanStale = true;
+        std::shared_ptr<Utils::BlasScratch> m_blasScratch;
+        bool m_gradientCheckpointing = false;
+        size_t m_checkpointSegmentLength = 0;
+        std::unique_ptr<Utils::ParameterArena> m_parameterArena;
+        Utils::MemoryTracker m_memoryTracker;
+        size_t m_batchBytes = 0;
+        bool m_compiledSteps = false;
+        bool m_recordingStep = false;
+        Utils::CommandRecorder m_stepRecording;
+        size_t m_recordedBatchSize = 0;
+        cl::Buffer m_stepInputs;
+        cl::Buffer m_stepTargets;
+        size_t m_stepBufferBatchSize = 0;
+        size_t m_pipelineDepth = 1;
+        bool m_pipelining = false;
+        size_t m_lossReadbackInterval = 0;
+        bool m_activationFusion = true;
+        std::vector<bool> m_fusedActivations;
+
+        struct PendingStep
+        {
+            Utils::Batch m_batch;
+            cl::Event m_completion;
+        };
+
+        void finishQueues() const;
+        void packParameters();
+        void applyOptimizerStep(std::vector<cl::Event> &p_waitList, const cl::Event &p_lastBackpropEvent);
+        void finishOptimizerStep();
+        void launchTrainStep(const Utils::Batch &p_batch, bool p_accumulateLoss);
+        cl::Event computeLossGradients(const cl::Buffer &p_batchTargets, const size_t p_batchSize, const bool p_accumulateLoss);
+        void runCompiledStep(const Utils::Batch &p_batch);
+        void setPipelining(const bool p_enabled);
+        void recordStep(const size_t p_batchSize);
+        void prepareStepBuffers();
+        void releaseStepBuffers();
+
+        // Passes driven from outside a recording rebind per-call kernel arguments the recording relies on.
+        void discardStepRecording()
+        {
+            if (!m_recordingStep)
+            {
+                m_stepRecording.clear();
+            }
+        }
+
+        static void addGradientEvents(std::vector<cl::Event> &p_events, const std::pair<cl::Event, cl::Event> &p_gradientEvents)
+        {
+            for (const cl::Event *event : {&p_gradientEvents.first, &p_gradientEvents.second})
+            {
+                if ((*event)() != nullptr)
+                {
+                    p_events.push_back(*event);
+                }
+            }
+        }
+        void findFusedActivations(Utils::ExecutionMode p_mode);
+        void bindFusedActivations();
+        void addCheckpointedTensors(Utils::MemoryPlanner &p_planner, std::vector<size_t> &p_outputTensors, std::vector<size_t> &p_deltaTensors) const;
+        void backwardCheckpointed(cl::Event p_deltaEvent, const cl::Buffer &p_batchInputs, const size_t p_batchSize);
+        void ensureMemoryPlan();
+        void checkTrainingPlan() const;
+
+        Utils::ExecutionMode getLayerExecutionMode() const
+        {
+            return m_inferenceOnly ? Utils::ExecutionMode::Inference : Utils::ExecutionMode::Training;
+        }
 
-        LocalNeuralNetwork(Utils::OpenCLResources &&p_oclResources, const H5::H5File &p_file, const size_t p_batchSize);
+        LocalNeuralNetwork(Utils::OpenCLResources &&p_oclResources, const H5::H5File &p_file, const size_t p_batchSize, const Utils::ExecutionMode p_mode);
     };
 }
\ No newline at end of file
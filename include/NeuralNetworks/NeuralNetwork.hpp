@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DataLoaders/AllDataLoaders.hpp"
+#include "Utils/BatchCapacity.hpp"
 #include "Utils/NetworkArgs.hpp"
 #include "Utils/NetworkType.hpp"
 #include <algorithm>
@@ -42,6 +43,16 @@ public:
 
     virtual void setBatchSize(const size_t p_batchSize) = 0;
 
+    void ensureBatchCapacity(const size_t p_batchSize)
+    {
+        if (m_batchSize < p_batchSize)
+        {
+            setBatchSize(Utils::growBatchCapacity(m_batchSize, p_batchSize));
+        }
+    }
+
+    size_t getBatchCapacity() const { return m_batchSize; }
+
     virtual Utils::NetworkType getType() const = 0;
 
 protected:
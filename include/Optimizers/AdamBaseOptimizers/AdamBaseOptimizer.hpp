@@ -29,59 +29,88 @@ namespace Optimizers
             loadMomentBuffers(p_optimizerGroup);
         }
 
-        ~AdamBaseOptimizer() = default;
-
-        cl::Event updateParameters(const cl::CommandQueue &p_concurrentQueue,
-                                   const cl::Event p_lastEvent,
-                                   const std::string &p_parametersId,
-                                   cl::Buffer &p_parameters,
-                                   cl::Buffer &p_gradients,
-                                   size_t p_numElements) final override
+        ~AdamBaseOptimizer()
         {
-            auto foundBuffers = m_momentBuffers.find(p_parametersId);
-            cl::Buffer mBuffer;
-            cl::Buffer vBuffer;
+            releaseMomentBuffers();
+        }
 
-            if (foundBuffers == m_momentBuffers.end())
+        // The moments of all parameters live in two arena-shaped buffers; the per-layer entries of
+        // m_momentBuffers are views into them used for saving, loading and comparison.
+        void bindParameterArena(const cl::CommandQueue &p_queue, const Utils::ParameterArena &p_arena) final override
+        {
+            cl::Buffer firstMoments = p_arena.createBuffer(p_queue);
+            cl::Buffer secondMoments = p_arena.createBuffer(p_queue);
+            std::map<std::string, std::pair<cl::Buffer, cl::Buffer>> momentBuffers;
+            for (size_t i = 0; i < p_arena.getRangeCount(); ++i)
             {
-                std::vector<float> zeroData(p_numElements, 0.0f);
-
-                mBuffer = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
-                                     p_numElements * sizeof(float), zeroData.data());
-
-                vBuffer = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
-                                     p_numElements * sizeof(float), zeroData.data());
-
-                m_momentBuffers[p_parametersId] = {mBuffer, vBuffer};
+                const Utils::ParameterArena::Range &range = p_arena.getRanges()[i];
+                std::pair<cl::Buffer, cl::Buffer> regions = {p_arena.createRegion(firstMoments, i), p_arena.createRegion(secondMoments, i)};
+                auto foundBuffers = m_momentBuffers.find(range.m_id);
+                if (foundBuffers != m_momentBuffers.end())
+                {
+                    p_queue.enqueueCopyBuffer(foundBuffers->second.first, regions.first, NO_OFFSET, NO_OFFSET, range.m_elements * sizeof(float));
+                    p_queue.enqueueCopyBuffer(foundBuffers->second.second, regions.second, NO_OFFSET, NO_OFFSET, range.m_elements * sizeof(float));
+                }
+                momentBuffers[range.m_id] = regions;
             }
-            else
+            p_queue.finish();
+            releaseMomentBuffers();
+            m_momentBuffers = std::move(momentBuffers);
+            m_firstMoments = firstMoments;
+            m_secondMoments = secondMoments;
+        }
+
+        cl::Event updateParameters(const cl::CommandQueue &p_concurrentQueue,
+                                   const std::vector<cl::Event> &p_waitList,
+                                   const cl::Buffer &p_parameters,
+                                   const cl::Buffer &p_gradients,
+                                   size_t p_numElements) final override
+        {
+            if (m_firstMoments() == nullptr)
             {
-                mBuffer = foundBuffers->second.first;
-                vBuffer = foundBuffers->second.second;
+                std::cerr << "Error: Adam update requested before a parameter arena was bound." << std::endl;
+                throw std::runtime_error("Optimizer has no parameter arena bound.");
             }
 
             Utils::setKernelArgs(
                 m_updateKernel,
                 p_parameters,
                 p_gradients,
-                mBuffer,
-                vBuffer);
-            Utils::setKernelArgs(9, m_updateKernel, pow(m_beta1, (float)m_t), pow(m_beta2, (float)m_t));
+                m_firstMoments,
+                m_secondMoments);
+            bindBiasCorrection();
 
             cl::Event kernelEvent;
-            std::vector<cl::Event> eventList = {p_lastEvent};
-
-            p_concurrentQueue.enqueueNDRangeKernel(m_updateKernel, cl::NullRange,
-                                                   cl::NDRange(p_numElements), cl::NullRange, &eventList, &kernelEvent);
+            m_sharedResources->enqueueKernel(p_concurrentQueue, m_updateKernel, cl::NDRange(p_numElements), &p_waitList, &kernelEvent);
 
             return kernelEvent;
         }
 
+        // Moment keys are "<layerId>Weights" / "<layerId>Biases".
+        void reportMemory(Utils::MemoryTracker &p_tracker) const final override
+        {
+            const bool packed = m_firstMoments() != nullptr;
+            p_tracker.record(Utils::MemoryTracker::NETWORK_OWNER, Utils::MemoryRole::Moments, m_firstMoments);
+            p_tracker.record(Utils::MemoryTracker::NETWORK_OWNER, Utils::MemoryRole::Moments, m_secondMoments);
+            for (const auto &[parametersId, buffers] : m_momentBuffers)
+            {
+                size_t layerId = std::stoul(parametersId);
+                p_tracker.record(layerId, Utils::MemoryRole::Moments, buffers.first, packed);
+                p_tracker.record(layerId, Utils::MemoryRole::Moments, buffers.second, packed);
+            }
+        }
+
         void save(const cl::CommandQueue &p_queue, H5::Group &p_optimizerGroup, const std::map<size_t, std::pair<size_t, size_t>> &p_parameterSizes) const override { saveAdamBaseOptimizer(p_queue, p_optimizerGroup, p_parameterSizes); }
         bool equals(const cl::CommandQueue &p_queue, const Optimizer &p_other, std::map<size_t, std::pair<size_t, size_t>> &p_parameterSizes) const override { return adamBaseOptimizerEquals(p_queue, p_other, p_parameterSizes); }
         void print() const override { printAdamBaseOptimizer(); }
 
-        void step() final override { m_t++; }
+        // Recorded training steps replay the update kernel with the arguments it holds, so the bias
+        // correction of the next step is bound as soon as the step counter advances.
+        void step() final override
+        {
+            m_t++;
+            bindBiasCorrection();
+        }
 
     protected:
         float m_beta1;
@@ -90,6 +119,32 @@ namespace Optimizers
         unsigned int m_t;
 
         std::map<std::string, std::pair<cl::Buffer, cl::Buffer>> m_momentBuffers;
+        cl::Buffer m_firstMoments;
+        cl::Buffer m_secondMoments;
+
+        void bindBiasCorrection()
+        {
+            if (m_updateKernel() != nullptr)
+            {
+                Utils::setKernelArgs(9, m_updateKernel, pow(m_beta1, (float)m_t), pow(m_beta2, (float)m_t));
+            }
+        }
+
+        // Loaded moments come from the pool; views into the arena-shaped buffers are simply dropped.
+        void releaseMomentBuffers()
+        {
+            if (m_firstMoments() == nullptr)
+            {
+                for (auto &[parametersId, buffers] : m_momentBuffers)
+                {
+                    m_sharedResources->getBufferPool()->release(buffers.first);
+                    m_sharedResources->getBufferPool()->release(buffers.second);
+                }
+            }
+            m_momentBuffers.clear();
+            m_firstMoments = cl::Buffer();
+            m_secondMoments = cl::Buffer();
+        }
 
         void saveAdamBaseOptimizer(const cl::CommandQueue &p_queue, H5::Group &p_optimizerGroup,
                                    const std::map<size_t, std::pair<size_t, size_t>> &p_momentSizes) const
@@ -178,8 +233,8 @@ namespace Optimizers
                     layerGroup.nameExists("weightsSecondMomentBuffer"))
                 {
                     std::string weightKey = layerIdStr + "Weights";
-                    cl::Buffer mBuffer = Utils::loadBuffer(m_sharedResources->getContext(), layerGroup, "weightsFirstMomentBuffer", weightsSize);
-                    cl::Buffer vBuffer = Utils::loadBuffer(m_sharedResources->getContext(), layerGroup, "weightsSecondMomentBuffer", weightsSize);
+                    cl::Buffer mBuffer = Utils::loadBuffer(m_sharedResources->getBufferPool(), layerGroup, "weightsFirstMomentBuffer", weightsSize);
+                    cl::Buffer vBuffer = Utils::loadBuffer(m_sharedResources->getBufferPool(), layerGroup, "weightsSecondMomentBuffer", weightsSize);
                     m_momentBuffers[weightKey] = {mBuffer, vBuffer};
                 }
 
@@ -187,8 +242,8 @@ namespace Optimizers
                     layerGroup.nameExists("biasesSecondMomentBuffer"))
                 {
                     std::string biasKey = layerIdStr + "Biases";
-                    cl::Buffer mBuffer = Utils::loadBuffer(m_sharedResources->getContext(), layerGroup, "biasesFirstMomentBuffer", biasesSize);
-                    cl::Buffer vBuffer = Utils::loadBuffer(m_sharedResources->getContext(), layerGroup, "biasesSecondMomentBuffer", biasesSize);
+                    cl::Buffer mBuffer = Utils::loadBuffer(m_sharedResources->getBufferPool(), layerGroup, "biasesFirstMomentBuffer", biasesSize);
+                    cl::Buffer vBuffer = Utils::loadBuffer(m_sharedResources->getBufferPool(), layerGroup, "biasesSecondMomentBuffer", biasesSize);
                     m_momentBuffers[biasKey] = {mBuffer, vBuffer};
                 }
             }
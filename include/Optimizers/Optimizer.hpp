@@ -30,40 +30,27 @@ namespace Optimizers
 
         virtual ~Optimizer() = default;
 
-        std::pair<cl::Event, cl::Event> updateTrainableLayer(
-            const cl::CommandQueue &p_concurrentQueue,
-            const std::pair<cl::Event, cl::Event> &p_prevEvents,
-            Layers::Trainable::TrainableLayer &p_layer)
+        // Updates every parameter of the model with one launch once the events in p_waitList have completed.
+        cl::Event updateParameterArena(const cl::CommandQueue &p_concurrentQueue,
+                                       const std::vector<cl::Event> &p_waitList,
+                                       const Utils::ParameterArena &p_arena)
         {
-            const size_t layerId = p_layer.getLayerId();
-            cl::Event weightEvent = updateParameters(
-                p_concurrentQueue,
-                p_prevEvents.first,
-                std::to_string(layerId) + "Weights",
-                p_layer.getWeights(),
-                p_layer.getWeightsGradients(),
-                p_layer.getWeightsSize());
-
-            cl::Event biasEvent = updateParameters(
-                p_concurrentQueue,
-                p_prevEvents.second,
-                std::to_string(layerId) + "Biases",
-                p_layer.getBiases(),
-                p_layer.getBiasesGradients(),
-                p_layer.getBiasesSize());
-
-            return {weightEvent, biasEvent};
+            return updateParameters(p_concurrentQueue, p_waitList, p_arena.getParameters(), p_arena.getGradients(), p_arena.getTotalElements());
         }
 
+        // Called whenever the network repacks its parameters; optimizer state moves to the new layout.
+        virtual void bindParameterArena(const cl::CommandQueue &, const Utils::ParameterArena &) {}
+
         virtual cl::Event updateParameters(const cl::CommandQueue &p_concurrentQueue,
-                                           const cl::Event p_lastEvent,
-                                           const std::string &p_parametersId,
-                                           cl::Buffer &p_parameters,
-                                           cl::Buffer &p_gradients,
+                                           const std::vector<cl::Event> &p_waitList,
+                                           const cl::Buffer &p_parameters,
+                                           const cl::Buffer &p_gradients,
                                            size_t p_numElements) = 0;
 
         virtual Utils::OptimizerType getType() const = 0;
 
+        virtual void reportMemory(Utils::MemoryTracker &) const {}
+
         virtual void save(const cl::CommandQueue &, H5::Group &p_optimizerGroup, const std::map<size_t, std::pair<size_t, size_t>> &) const { saveOptimizer(p_optimizerGroup); }
         virtual bool equals(const cl::CommandQueue &, const Optimizer &p_other, std::map<size_t, std::pair<size_t, size_t>> &) const { return optimizerEquals(p_other); }
         virtual void print() const { printOptimizer(); }
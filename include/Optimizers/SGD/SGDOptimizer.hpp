@@ -18,10 +18,9 @@ namespace Optimizers
         ~SGDOptimizer() = default;
 
         cl::Event updateParameters(const cl::CommandQueue &p_concurrentQueue,
-                                   const cl::Event p_lastEvent,
-                                   const std::string &p_parametersId,
-                                   cl::Buffer &p_parameters,
-                                   cl::Buffer &p_gradients,
+                                   const std::vector<cl::Event> &p_waitList,
+                                   const cl::Buffer &p_parameters,
+                                   const cl::Buffer &p_gradients,
                                    size_t p_numElements) final override;
 
         Utils::OptimizerType getType() const final override { return Utils::OptimizerType::SGD; }
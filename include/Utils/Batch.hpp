@@ -1,8 +1,10 @@
 #pragma once
 
 #include <CL/opencl.hpp>
+#include <memory>
 #include <vector>
 #include <Utils/Dimensions.hpp>
+#include <Utils/BufferPool.hpp>
 namespace Utils
 {
     struct Batch
@@ -14,7 +16,9 @@ namespace Utils
               std::vector<float> p_targetVec,
               size_t p_size,
               const Utils::Dimensions &p_inputDimensions,
-              const Utils::Dimensions &p_targetDimensions)
+              const Utils::Dimensions &p_targetDimensions,
+              std::shared_ptr<BufferPool> p_bufferPool = nullptr,
+              std::vector<cl::Event> p_uploadEvents = {})
             : m_inputs(std::move(p_inputs)),
               m_targets(std::move(p_targets)),
               m_inputsVec(std::move(p_inputVec)),
@@ -22,7 +26,9 @@ namespace Utils
               m_size(p_size),
               m_inputDimensions(p_inputDimensions),
               m_targetDimensions(p_targetDimensions),
-              m_hasTargets(true) {}
+              m_hasTargets(true),
+              m_bufferPool(std::move(p_bufferPool)),
+              m_uploadEvents(std::move(p_uploadEvents)) {}
 
         Batch(std::vector<float> p_inputVec,
               std::vector<float> p_targetVec,
@@ -36,6 +42,21 @@ namespace Utils
               m_targetDimensions(p_targetDimensions),
               m_hasTargets(true) {}
 
+        Batch(const Batch &) = delete;
+        Batch &operator=(const Batch &) = delete;
+        Batch(Batch &&) = default;
+        Batch &operator=(Batch &&) = default;
+
+        ~Batch()
+        {
+            if (m_bufferPool)
+            {
+                cl::Event lastUpload = m_uploadEvents.empty() ? cl::Event() : m_uploadEvents.back();
+                m_bufferPool->release(m_inputs, lastUpload);
+                m_bufferPool->release(m_targets, lastUpload);
+            }
+        }
+
         const cl::Buffer &getInputs() const
         {
             return m_inputs;
@@ -76,6 +97,12 @@ namespace Utils
             return m_hasTargets;
         }
 
+        // Non-blocking uploads of the device buffers still in flight; empty when the buffers were written synchronously.
+        const std::vector<cl::Event> &getUploadEvents() const
+        {
+            return m_uploadEvents;
+        }
+
     private:
         cl::Buffer m_inputs;
         cl::Buffer m_targets;
@@ -85,5 +112,7 @@ namespace Utils
         Utils::Dimensions m_inputDimensions;
         Utils::Dimensions m_targetDimensions;
         bool m_hasTargets;
+        std::shared_ptr<BufferPool> m_bufferPool;
+        std::vector<cl::Event> m_uploadEvents;
     };
 }
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+namespace Utils
+{
+    // Batch buffers grow geometrically, so a stream of slowly increasing batch sizes reallocates and
+    // re-binds a logarithmic number of times. Batches up to the capacity run in the existing buffers:
+    // every kernel and CLBlast call takes the live batch through its global size or matrix dimension.
+    inline size_t growBatchCapacity(const size_t p_capacity, const size_t p_batchSize)
+    {
+        return std::max(p_batchSize, 2 * p_capacity);
+    }
+}
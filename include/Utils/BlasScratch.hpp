@@ -0,0 +1,72 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <clblast.h>
+#include "Utils/BufferPool.hpp"
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <iostream>
+
+namespace Utils
+{
+    // CLBlast temporary buffers and the GEMV ones vector, shared by every layer of a network. There is one
+    // workspace per queue, sized to the largest routine enqueued on it: routines on the in-order
+    // forward/backprop queue never overlap, and on the out-of-order delta-to-gradient queue each user waits
+    // for the previous one through getDeltaToGradientWaitList(). The im2col columns that convolutional weight
+    // gradients multiply against are a delta-to-gradient workspace as well.
+    class BlasScratch
+    {
+    public:
+        explicit BlasScratch(std::shared_ptr<BufferPool> p_bufferPool);
+
+        BlasScratch(const BlasScratch &) = delete;
+        BlasScratch &operator=(const BlasScratch &) = delete;
+
+        ~BlasScratch();
+
+        void clearRequirements();
+
+        void requireForwardBackprop(size_t p_bytes) { m_forwardBackpropBytes = std::max(m_forwardBackpropBytes, p_bytes); }
+
+        void requireDeltaToGradient(size_t p_bytes) { m_deltaToGradientBytes = std::max(m_deltaToGradientBytes, p_bytes); }
+
+        void requireOnes(size_t p_elements) { m_onesElements = std::max(m_onesElements, p_elements); }
+
+        void requireColumns(size_t p_bytes) { m_columnsBytes = std::max(m_columnsBytes, p_bytes); }
+
+        void allocate();
+
+        const cl::Buffer &getForwardBackpropWorkspace() const { return m_forwardBackpropWorkspace; }
+
+        const cl::Buffer &getDeltaToGradientWorkspace() const { return m_deltaToGradientWorkspace; }
+
+        const cl::Buffer &getOnes() const { return m_ones; }
+
+        const cl::Buffer &getColumns() const { return m_columns; }
+
+        size_t getAllocatedBytes() const;
+
+        std::vector<cl::Event> getDeltaToGradientWaitList(const cl::Event &p_event) const;
+
+        void setDeltaToGradientLastUse(const cl::Event &p_event) { m_deltaToGradientLastUse = p_event; }
+
+        static size_t getGemmBytes(const cl::CommandQueue &p_queue,
+                                   clblast::Transpose p_transposeA, clblast::Transpose p_transposeB,
+                                   size_t p_m, size_t p_n, size_t p_k);
+
+    private:
+        std::shared_ptr<BufferPool> m_bufferPool;
+        size_t m_forwardBackpropBytes = 0;
+        size_t m_deltaToGradientBytes = 0;
+        size_t m_onesElements = 0;
+        size_t m_columnsBytes = 0;
+        cl::Buffer m_forwardBackpropWorkspace;
+        cl::Buffer m_deltaToGradientWorkspace;
+        cl::Buffer m_ones;
+        cl::Buffer m_columns;
+        cl::Event m_deltaToGradientLastUse;
+
+        void resize(cl::Buffer &p_buffer, size_t p_bytes);
+    };
+}
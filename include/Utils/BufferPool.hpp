@@ -0,0 +1,130 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include "Utils/DeviceDiscovery.hpp"
+#include "Utils/HostMemory.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <iostream>
+
+namespace Utils
+{
+    // Size-class pool of read/write device buffers. Requests are rounded up to a class (powers of two
+    // split in quarter steps, so at most 25% slack), released buffers are kept per class and handed out
+    // again, so a steady-state training loop creates and frees no device memory. Small classes can
+    // optionally be carved as sub-buffers out of larger arenas to bound fragmentation.
+    //
+    // When every device of the context shares memory with the host, buffers are allocated host-resident
+    // (CL_MEM_ALLOC_HOST_PTR) and host transfers map them instead of copying.
+    //
+    // A buffer must only be released once the work queued on it has completed, or together with the
+    // event of its last use; it is not handed out again before that event has finished.
+    class BufferPool
+    {
+    public:
+        explicit BufferPool(const cl::Context &p_context, size_t p_arenaSize = 0);
+
+        BufferPool(const BufferPool &) = delete;
+        BufferPool &operator=(const BufferPool &) = delete;
+
+        cl::Buffer acquire(size_t p_bytes);
+
+        cl::Buffer acquire(size_t p_bytes, const void *p_data);
+
+        cl::Buffer acquireFilled(size_t p_bytes, float p_value);
+
+        void release(cl::Buffer &p_buffer, const cl::Event &p_lastUse = cl::Event());
+
+        // Gives a buffer up for good instead of caching it: a standalone buffer is dropped, so the device frees
+        // it once its queued work is done. Arena sub-buffers cannot be freed on their own and are released.
+        void discard(cl::Buffer &p_buffer, const cl::Event &p_lastUse = cl::Event());
+
+        void trim();
+
+        void enableArenas(size_t p_arenaSize);
+
+        size_t getArenaSize() const
+        {
+            return m_arenaSize;
+        }
+
+        size_t getAlignment() const
+        {
+            return m_alignment;
+        }
+
+        bool isZeroCopy() const
+        {
+            return m_zeroCopy;
+        }
+
+        void setZeroCopy(bool p_zeroCopy);
+
+        cl_mem_flags getMemFlags() const
+        {
+            return m_zeroCopy ? CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR : CL_MEM_READ_WRITE;
+        }
+
+        const cl::CommandQueue &getUploadQueue() const
+        {
+            return m_uploadQueue;
+        }
+
+        size_t getCreatedCount() const
+        {
+            return m_created.load();
+        }
+
+        size_t getReusedCount() const
+        {
+            return m_reused.load();
+        }
+
+        size_t getCreatedBytes() const
+        {
+            return m_createdBytes.load();
+        }
+
+        size_t getFreeBytes() const;
+
+        void printStats() const;
+
+        static size_t getSizeClass(size_t p_bytes);
+
+    private:
+        struct FreeBuffer
+        {
+            cl::Buffer m_buffer;
+            cl::Event m_lastUse;
+        };
+
+        struct Arena
+        {
+            cl::Buffer m_buffer;
+            size_t m_used = 0;
+        };
+
+        cl::Context m_context;
+        cl::CommandQueue m_uploadQueue;
+        size_t m_arenaSize;
+        size_t m_alignment = 1;
+        bool m_zeroCopy = true;
+        std::map<size_t, std::vector<FreeBuffer>> m_freeBuffers;
+        std::vector<Arena> m_arenas;
+        mutable std::mutex m_mutex;
+        std::atomic<size_t> m_created{0};
+        std::atomic<size_t> m_reused{0};
+        std::atomic<size_t> m_createdBytes{0};
+
+        static const size_t MIN_SIZE_CLASS = 256;
+
+        cl::Buffer createBuffer(size_t p_sizeClass);
+
+        size_t getArenaThreshold() const
+        {
+            return m_arenaSize / 16;
+        }
+    };
+}
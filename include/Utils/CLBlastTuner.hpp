@@ -0,0 +1,96 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <clblast.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+
+namespace Utils
+{
+    // One CLBlast kernel invocation shape, in the column-major terms the kernel itself sees.
+    struct BlasShape
+    {
+        std::string m_kernel;
+        size_t m_m = 0;
+        size_t m_n = 0;
+        size_t m_k = 0;
+
+        static BlasShape rowMajorGemm(size_t p_m, size_t p_n, size_t p_k, bool p_direct = false)
+        {
+            return {p_direct ? "XgemmDirect" : "Xgemm", p_n, p_m, p_k};
+        }
+
+        static BlasShape rowMajorGemv(size_t p_m, size_t p_n)
+        {
+            return {"Xgemv", p_n, p_m, 0};
+        }
+
+        static BlasShape convgemm(size_t p_patches, size_t p_kernels, size_t p_patchSize)
+        {
+            return {"Xconvgemm", p_patches, p_kernels, p_patchSize};
+        }
+
+        double getWork() const
+        {
+            return static_cast<double>(m_m) * static_cast<double>(m_n) * static_cast<double>(m_k == 0 ? 1 : m_k);
+        }
+
+        std::string toString() const
+        {
+            return m_kernel + "\t" + std::to_string(m_m) + "x" + std::to_string(m_n) + "x" + std::to_string(m_k);
+        }
+
+        bool operator<(const BlasShape &p_other) const
+        {
+            return toString() < p_other.toString();
+        }
+    };
+
+    // Stores CLBlast tuner results per (device, kernel, shape) and installs them through
+    // clblast::OverrideParameters. CLBlast keeps a single parameter set per device and kernel,
+    // so when several shapes were tuned the one doing the most work wins.
+    class CLBlastTuner
+    {
+    public:
+        explicit CLBlastTuner(const std::string &p_databaseFile = "");
+
+        void tune(const cl::CommandQueue &p_queue, const std::vector<BlasShape> &p_shapes, double p_fraction = 1.0);
+
+        void apply(const cl::Device &p_device, const std::vector<BlasShape> &p_shapes = {}) const;
+
+        bool isTuned(const cl::Device &p_device, const BlasShape &p_shape) const;
+
+        size_t getEntryCount() const;
+
+        const std::string &getDatabaseFile() const
+        {
+            return m_databaseFile;
+        }
+
+    private:
+        struct TunedParameters
+        {
+            BlasShape m_shape;
+            std::unordered_map<std::string, size_t> m_parameters;
+        };
+
+        std::string m_databaseFile;
+        std::map<std::string, TunedParameters> m_entries;
+        mutable std::mutex m_mutex;
+
+        static std::string getDeviceKey(const cl::Device &p_device);
+
+        static clblast::StatusCode runTuner(cl_command_queue p_queue, const BlasShape &p_shape, double p_fraction,
+                                            std::unordered_map<std::string, size_t> &p_parameters);
+
+        void load();
+
+        void saveLocked() const;
+    };
+}
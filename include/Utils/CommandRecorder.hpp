@@ -0,0 +1,76 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <functional>
+#include <map>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+namespace Utils
+{
+    // Records the commands one training step enqueues so later steps of the same shape can replay them
+    // without re-running the host logic that produced them: kernels keep the arguments they had when
+    // they were recorded and are launched with their resolved global and local sizes, and dependencies
+    // between recorded commands are rebuilt from the events of the current replay. Routines (CLBlast
+    // calls) are replayed through the closure that enqueued them.
+    //
+    // Events a recorded command waited on that were not produced inside the recording are assumed to
+    // have completed by the time the recording is replayed.
+    class CommandRecorder
+    {
+    public:
+        using Routine = std::function<cl_event(cl_command_queue)>;
+
+        void clear();
+
+        void recordKernel(const cl::CommandQueue &p_queue, const cl::Kernel &p_kernel,
+                          const cl::NDRange &p_global, const cl::NDRange &p_local,
+                          const std::vector<cl::Event> *p_waitList, const cl::Event &p_event);
+
+        void recordBarrier(const cl::CommandQueue &p_queue, const std::vector<cl::Event> *p_waitList, const cl::Event &p_event);
+
+        void recordRoutine(const cl::CommandQueue &p_queue, Routine p_routine, const cl::Event &p_event);
+
+        void replay();
+
+        size_t getCommandCount() const { return m_commands.size(); }
+
+        bool empty() const { return m_commands.empty(); }
+
+        // Set when a kernel was recorded with a local size the work-size tuner has not settled yet; the owner
+        // should record again rather than replay a launch that would never be tuned.
+        void markProvisional() { m_provisional = true; }
+
+        bool isProvisional() const { return m_provisional; }
+
+    private:
+        enum class CommandType
+        {
+            Kernel,
+            Barrier,
+            Routine
+        };
+
+        struct Command
+        {
+            CommandType m_type;
+            cl::CommandQueue m_queue;
+            cl::Kernel m_kernel;
+            cl_uint m_dimensions = 0;
+            size_t m_global[3] = {0, 0, 0};
+            size_t m_local[3] = {0, 0, 0};
+            bool m_hasLocal = false;
+            Routine m_routine;
+            std::vector<size_t> m_dependencies;
+            std::vector<cl_event> m_waitList;
+            cl::Event m_event;
+        };
+
+        std::vector<Command> m_commands;
+        std::map<cl_event, size_t> m_producers;
+        bool m_provisional = false;
+
+        void addCommand(Command &&p_command, const std::vector<cl::Event> *p_waitList, const cl::Event &p_event);
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace Utils
+{
+    struct DeviceCapabilities
+    {
+        cl::Platform m_platform;
+        cl::Device m_device;
+        size_t m_platformIndex = 0;
+        size_t m_deviceIndex = 0;
+        std::string m_platformName;
+        std::string m_name;
+        std::string m_vendor;
+        cl_device_type m_type = CL_DEVICE_TYPE_DEFAULT;
+        cl_uint m_computeUnits = 0;
+        cl_uint m_maxClockFrequency = 0;
+        cl_ulong m_globalMemory = 0;
+        cl_ulong m_localMemory = 0;
+        cl_ulong m_maxAllocation = 0;
+        bool m_fp16 = false;
+        bool m_hostUnifiedMemory = false;
+        double m_score = 0.0;
+
+        std::string getTypeName() const;
+        std::string toString() const;
+    };
+
+    class DeviceDiscovery
+    {
+    public:
+        static std::vector<DeviceCapabilities> enumerateDevices(cl_device_type p_deviceType = CL_DEVICE_TYPE_ALL);
+
+        static DeviceCapabilities selectBestDevice(cl_device_type p_deviceType = CL_DEVICE_TYPE_ALL);
+
+        static std::vector<DeviceCapabilities> selectBestPlatformDevices(cl_device_type p_deviceType = CL_DEVICE_TYPE_ALL);
+
+        static DeviceCapabilities queryCapabilities(const cl::Platform &p_platform, const cl::Device &p_device,
+                                                    size_t p_platformIndex, size_t p_deviceIndex);
+
+        static double scoreDevice(const DeviceCapabilities &p_capabilities);
+
+        static bool hasHostUnifiedMemory(const cl::Device &p_device);
+
+        static void printDevices(const std::vector<DeviceCapabilities> &p_devices);
+    };
+}
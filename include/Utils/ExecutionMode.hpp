@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Utils
+{
+    enum class ExecutionMode
+    {
+        Inference,
+        Training
+    };
+}
@@ -0,0 +1,22 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <functional>
+#include <vector>
+
+namespace Utils
+{
+    // True for buffers (or sub-buffers of buffers) created with CL_MEM_ALLOC_HOST_PTR or CL_MEM_USE_HOST_PTR,
+    // which devices sharing memory with the host can map without a copy.
+    bool isHostResident(const cl::Buffer &p_buffer);
+
+    // Runs p_access on host memory holding the first p_bytes of the buffer. Host-resident buffers are
+    // mapped in place; others go through a staging copy that is read before (CL_MAP_READ) and written
+    // back after (CL_MAP_WRITE, CL_MAP_WRITE_INVALIDATE_REGION) the access.
+    void accessHostMemory(const cl::CommandQueue &p_queue,
+                          const cl::Buffer &p_buffer,
+                          size_t p_bytes,
+                          cl_map_flags p_flags,
+                          const std::function<void(void *)> &p_access,
+                          const std::vector<cl::Event> *p_waitList = nullptr);
+}
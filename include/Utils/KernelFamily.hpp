@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Utils/LayerType.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Utils
+{
+    enum class KernelFamily : unsigned int
+    {
+        Activation = 0,
+        Dense = 1,
+        Convolutional = 2,
+        LossFunction = 3,
+        Optimizer = 4
+    };
+
+    inline std::string kernelFamilyToString(KernelFamily p_family)
+    {
+        switch (p_family)
+        {
+        case KernelFamily::Activation:
+            return "Activation";
+        case KernelFamily::Dense:
+            return "Dense";
+        case KernelFamily::Convolutional:
+            return "Convolutional";
+        case KernelFamily::LossFunction:
+            return "LossFunction";
+        case KernelFamily::Optimizer:
+            return "Optimizer";
+        default:
+            throw std::invalid_argument("Invalid KernelFamily value");
+        }
+    }
+
+    inline std::vector<std::string> kernelFamilySources(KernelFamily p_family)
+    {
+        switch (p_family)
+        {
+        case KernelFamily::Activation:
+            return {"Layers/Activation"};
+        case KernelFamily::Dense:
+            return {"Layers/Trainable/BiasKernels.cl"};
+        case KernelFamily::Convolutional:
+            return {"Layers/Trainable/ConvolutionalLayerKernels.cl"};
+        case KernelFamily::LossFunction:
+            return {"LossFunctions"};
+        case KernelFamily::Optimizer:
+            return {"Optimizers"};
+        default:
+            throw std::invalid_argument("Invalid KernelFamily value");
+        }
+    }
+
+    inline KernelFamily kernelFamilyFromLayerType(LayerType p_type)
+    {
+        switch (p_type)
+        {
+        case LayerType::Dense:
+            return KernelFamily::Dense;
+        case LayerType::Convolutional:
+            return KernelFamily::Convolutional;
+        case LayerType::ReLU:
+        case LayerType::LeakyReLU:
+        case LayerType::Sigmoid:
+        case LayerType::Tanh:
+        case LayerType::Softmax:
+            return KernelFamily::Activation;
+        default:
+            throw std::invalid_argument("Invalid LayerType value");
+        }
+    }
+}
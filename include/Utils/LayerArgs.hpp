@@ -16,7 +16,8 @@ namespace Utils
             std::shared_ptr<Utils::SharedResources> p_sharedResources,
             const Dimensions &p_inputDimensions,
             const size_t p_batchSize,
-            std::mt19937 &p_rng) const = 0;
+            std::mt19937 &p_rng,
+            const ExecutionMode p_mode = ExecutionMode::Training) const = 0;
     };
 
     struct DenseLayerArgs : public LayerArgs
@@ -28,9 +29,9 @@ namespace Utils
         DenseLayerArgs(Dimensions p_outputDimensions)
             : m_outputDimensions(p_outputDimensions) {}
 
-        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &p_rng) const final override
+        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &p_rng, const ExecutionMode p_mode = ExecutionMode::Training) const final override
         {
-            return std::make_unique<Layers::Trainable::DenseLayer>(p_layerId, p_sharedResources, p_inputDimensions, m_outputDimensions, p_batchSize, p_rng);
+            return std::make_unique<Layers::Trainable::DenseLayer>(p_layerId, p_sharedResources, p_inputDimensions, m_outputDimensions, p_batchSize, p_rng, p_mode);
         }
 
         Dimensions getOutputDimensions() const
@@ -50,14 +51,16 @@ namespace Utils
         FilterDimensions m_filterDimensions;
         StrideDimensions m_strideDimensions;
         PaddingType m_paddingType;
+        bool m_specializeKernels;
 
     public:
-        ConvolutionalLayerArgs(FilterDimensions p_filterDimensions, StrideDimensions p_strideDimensions, PaddingType p_paddingType)
+        ConvolutionalLayerArgs(FilterDimensions p_filterDimensions, StrideDimensions p_strideDimensions, PaddingType p_paddingType, bool p_specializeKernels = false)
             : m_filterDimensions(p_filterDimensions),
               m_strideDimensions(p_strideDimensions),
-              m_paddingType(p_paddingType) {}
+              m_paddingType(p_paddingType),
+              m_specializeKernels(p_specializeKernels) {}
 
-        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &p_rng) const final override
+        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &p_rng, const ExecutionMode p_mode = ExecutionMode::Training) const final override
         {
             if (p_inputDimensions.getDimensions()[0] != m_filterDimensions.getInputChannels())
             {
@@ -65,7 +68,7 @@ namespace Utils
                           << ") do not match the channels of input dimensions (" << p_inputDimensions.getDimensions()[0] << ")." << std::endl;
                 throw std::invalid_argument("Input dimensions' channels do not match filter's input channels.");
             }
-            return std::make_unique<Layers::Trainable::ConvolutionalLayer>(p_layerId, p_sharedResources, p_inputDimensions, m_filterDimensions, m_strideDimensions, m_paddingType, p_batchSize, p_rng);
+            return std::make_unique<Layers::Trainable::ConvolutionalLayer>(p_layerId, p_sharedResources, p_inputDimensions, m_filterDimensions, m_strideDimensions, m_paddingType, p_batchSize, p_rng, m_specializeKernels, p_mode);
         }
 
         FilterDimensions getFilterDimensions() const
@@ -83,6 +86,11 @@ namespace Utils
             return m_paddingType;
         }
 
+        bool getSpecializeKernels() const
+        {
+            return m_specializeKernels;
+        }
+
         LayerType getLayerType() const override
         {
             return LayerType::Convolutional;
@@ -97,9 +105,9 @@ namespace Utils
     public:
         LeakyReLULayerArgs(float p_alpha) : m_alpha(p_alpha) {}
 
-        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &) const final override
+        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &, const ExecutionMode p_mode = ExecutionMode::Training) const final override
         {
-            return std::make_unique<Layers::Activation::LeakyReLULayer>(p_layerId, p_sharedResources, p_inputDimensions, m_alpha, p_batchSize);
+            return std::make_unique<Layers::Activation::LeakyReLULayer>(p_layerId, p_sharedResources, p_inputDimensions, m_alpha, p_batchSize, p_mode);
         }
         LayerType getLayerType() const override
         {
@@ -112,9 +120,9 @@ namespace Utils
     public:
         ReLULayerArgs() = default;
 
-        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &) const final override
+        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &, const ExecutionMode p_mode = ExecutionMode::Training) const final override
         {
-            return std::make_unique<Layers::Activation::ReLULayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize);
+            return std::make_unique<Layers::Activation::ReLULayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize, p_mode);
         }
         LayerType getLayerType() const override
         {
@@ -127,9 +135,9 @@ namespace Utils
     public:
         SigmoidLayerArgs() = default;
 
-        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &) const final override
+        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &, const ExecutionMode p_mode = ExecutionMode::Training) const final override
         {
-            return std::make_unique<Layers::Activation::SigmoidLayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize);
+            return std::make_unique<Layers::Activation::SigmoidLayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize, p_mode);
         }
         LayerType getLayerType() const override
         {
@@ -142,9 +150,9 @@ namespace Utils
     public:
         TanhLayerArgs() = default;
 
-        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &) const final override
+        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &, const ExecutionMode p_mode = ExecutionMode::Training) const final override
         {
-            return std::make_unique<Layers::Activation::TanhLayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize);
+            return std::make_unique<Layers::Activation::TanhLayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize, p_mode);
         }
 
         LayerType getLayerType() const override
@@ -158,9 +166,9 @@ namespace Utils
     public:
         SoftmaxLayerArgs() = default;
 
-        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &) const final override
+        std::unique_ptr<Layers::Layer> createLayer(const size_t p_layerId, std::shared_ptr<Utils::SharedResources> p_sharedResources, const Dimensions &p_inputDimensions, const size_t p_batchSize, std::mt19937 &, const ExecutionMode p_mode = ExecutionMode::Training) const final override
         {
-            return std::make_unique<Layers::Activation::SoftmaxLayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize);
+            return std::make_unique<Layers::Activation::SoftmaxLayer>(p_layerId, p_sharedResources, p_inputDimensions, p_batchSize, p_mode);
         }
 
         LayerType getLayerType() const override
@@ -170,12 +178,12 @@ namespace Utils
     };
 
     std::unique_ptr<LayerArgs> makeDenseLayerArgs(const Dimensions &p_outputDimensions);
-    std::unique_ptr<LayerArgs> makeConvolutionalLayerArgs(const FilterDimensions &p_filterDimensions, const StrideDimensions &p_strideDimensions, PaddingType p_paddingType);
+    std::unique_ptr<LayerArgs> makeConvolutionalLayerArgs(const FilterDimensions &p_filterDimensions, const StrideDimensions &p_strideDimensions, PaddingType p_paddingType, bool p_specializeKernels = false);
     std::unique_ptr<LayerArgs> makeReLULayerArgs();
     std::unique_ptr<LayerArgs> makeLeakyReLULayerArgs(float p_alpha);
     std::unique_ptr<LayerArgs> makeSigmoidLayerArgs();
     std::unique_ptr<LayerArgs> makeTanhLayerArgs();
     std::unique_ptr<LayerArgs> makeSoftmaxLayerArgs();
 
-    std::unique_ptr<Layers::Layer> loadLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources, const H5::Group &p_layerGroup, const size_t p_batchSize);
+    std::unique_ptr<Layers::Layer> loadLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources, const H5::Group &p_layerGroup, const size_t p_batchSize, const ExecutionMode p_mode = ExecutionMode::Training);
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include "Utils/ExecutionMode.hpp"
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+namespace Utils
+{
+    // Assigns offsets in one shared arena to tensors whose lifetimes over a linear schedule of steps are
+    // known up front. Tensors that are live at the same step never share bytes; everything else may.
+    // Placement is greedy first-fit, largest tensor first, with every offset aligned for sub-buffers.
+    // A tensor may be live over several disjoint step ranges, e.g. when it is recomputed later on.
+    class MemoryPlanner
+    {
+    public:
+        explicit MemoryPlanner(size_t p_alignment = 1);
+
+        size_t addTensor(size_t p_bytes, size_t p_firstStep, size_t p_lastStep);
+
+        void extendLifetime(size_t p_tensor, size_t p_step);
+
+        void addLiveRange(size_t p_tensor, size_t p_firstStep, size_t p_lastStep);
+
+        void plan();
+
+        size_t getOffset(size_t p_tensor) const;
+
+        size_t getBytes(size_t p_tensor) const { return getTensor(p_tensor).m_bytes; }
+
+        size_t getTensorCount() const { return m_tensors.size(); }
+
+        size_t getArenaSize() const { return m_arenaSize; }
+
+        size_t getUnplannedSize() const;
+
+        size_t alignUp(size_t p_bytes) const { return ((p_bytes + m_alignment - 1) / m_alignment) * m_alignment; }
+
+    private:
+        struct Tensor
+        {
+            size_t m_bytes;
+            std::vector<std::pair<size_t, size_t>> m_ranges;
+            size_t m_offset;
+        };
+
+        size_t m_alignment;
+        std::vector<Tensor> m_tensors;
+        size_t m_arenaSize = 0;
+        bool m_planned = false;
+
+        const Tensor &getTensor(size_t p_tensor) const;
+
+        static bool liveTogether(const Tensor &p_first, const Tensor &p_second);
+    };
+}
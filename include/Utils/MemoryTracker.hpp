@@ -0,0 +1,97 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <iostream>
+
+namespace Utils
+{
+    enum class MemoryRole : unsigned int
+    {
+        Activations,
+        Outputs,
+        Deltas,
+        SignMasks,
+        Weights,
+        Gradients,
+        Workspace,
+        Moments,
+        Batch
+    };
+
+    inline std::string memoryRoleToString(MemoryRole p_role)
+    {
+        switch (p_role)
+        {
+        case MemoryRole::Activations:
+            return "activations";
+        case MemoryRole::Outputs:
+            return "outputs";
+        case MemoryRole::Deltas:
+            return "deltas";
+        case MemoryRole::SignMasks:
+            return "signMasks";
+        case MemoryRole::Weights:
+            return "weights";
+        case MemoryRole::Gradients:
+            return "gradients";
+        case MemoryRole::Workspace:
+            return "workspace";
+        case MemoryRole::Moments:
+            return "moments";
+        case MemoryRole::Batch:
+            return "batch";
+        default:
+            return "unknown";
+        }
+    }
+
+    // Device memory of one network, by owner (a layer ID, or NETWORK_OWNER for network-wide buffers) and
+    // role. Usage is rebuilt from a snapshot of every live buffer between beginSnapshot() and
+    // endSnapshot(); peaks are the largest values seen across snapshots. Aliased entries are views into
+    // another recorded buffer (planned activations, packed parameters): they count towards their owner
+    // but not towards the network total, so the total is what the device actually holds.
+    class MemoryTracker
+    {
+    public:
+        static constexpr size_t NETWORK_OWNER = SIZE_MAX;
+
+        struct Usage
+        {
+            size_t m_currentBytes = 0;
+            size_t m_peakBytes = 0;
+            bool m_aliased = false;
+        };
+
+        void beginSnapshot();
+
+        void record(size_t p_owner, MemoryRole p_role, const cl::Buffer &p_buffer, bool p_aliased = false);
+
+        void record(size_t p_owner, MemoryRole p_role, size_t p_bytes, bool p_aliased = false);
+
+        void endSnapshot();
+
+        Usage getUsage(size_t p_owner, MemoryRole p_role) const;
+
+        size_t getCurrentBytes(size_t p_owner) const;
+
+        size_t getPeakBytes(size_t p_owner) const;
+
+        size_t getCurrentBytes() const { return m_currentBytes; }
+
+        size_t getPeakBytes() const { return m_peakBytes; }
+
+        const std::map<std::pair<size_t, MemoryRole>, Usage> &getUsages() const { return m_usages; }
+
+        void printReport() const;
+
+    private:
+        std::map<std::pair<size_t, MemoryRole>, Usage> m_usages;
+        std::map<size_t, std::pair<size_t, size_t>> m_ownerBytes;
+        size_t m_currentBytes = 0;
+        size_t m_peakBytes = 0;
+    };
+}
@@ -2,6 +2,17 @@
 #define CL_HPP_ENABLE_EXCEPTIONS
 #include <CL/opencl.hpp>
 #include <H5Cpp.h>
+#include "Utils/ProgramCache.hpp"
+#include "Utils/KernelFamily.hpp"
+#include "Utils/DeviceDiscovery.hpp"
+#include "Utils/WorkSizeTuner.hpp"
+#include "Utils/CLBlastTuner.hpp"
+#include "Utils/BufferPool.hpp"
+#include "Utils/BlasScratch.hpp"
+#include "Utils/StagingRing.hpp"
+#include "Utils/ParameterArena.hpp"
+#include "Utils/MemoryTracker.hpp"
+#include "Utils/CommandRecorder.hpp"
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
@@ -9,6 +20,9 @@
 #include <algorithm>
 #include <vector>
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <future>
 
 #ifndef NEURAL_NETWORK_CONSTANTS_HPP
 #define NEURAL_NETWORK_CONSTANTS_HPP
@@ -27,21 +41,153 @@ namespace Utils
     struct SharedResources
     {
     public:
-        SharedResources(cl::Context &&p_context, cl::Program &&p_program)
-            : m_context(std::move(p_context)), m_program(std::move(p_program)) {}
+        SharedResources(cl::Context &&p_context, std::shared_ptr<ProgramCache> p_programCache,
+                        const std::string &p_kernelsPath, const std::string &p_buildOptions,
+                        std::shared_ptr<WorkSizeTuner> p_workSizeTuner = nullptr,
+                        std::shared_ptr<CLBlastTuner> p_blasTuner = nullptr)
+            : m_context(std::move(p_context)), m_devices(m_context.getInfo<CL_CONTEXT_DEVICES>()), m_programCache(std::move(p_programCache)),
+              m_workSizeTuner(p_workSizeTuner ? std::move(p_workSizeTuner) : std::make_shared<WorkSizeTuner>()),
+              m_blasTuner(p_blasTuner ? std::move(p_blasTuner) : std::make_shared<CLBlastTuner>()),
+              m_bufferPool(std::make_shared<BufferPool>(m_context)),
+              m_stagingRing(std::make_shared<StagingRing>(m_context)),
+              m_kernelsPath(p_kernelsPath), m_buildOptions(p_buildOptions) {}
         const cl::Context &getContext() const
         {
             return m_context;
         }
 
-        const cl::Program &getProgram() const
+        const std::vector<cl::Device> &getDevices() const
         {
-            return m_program;
+            return m_devices;
+        }
+
+        const cl::Program &getProgram(KernelFamily p_family);
+
+        void buildPrograms(const std::vector<KernelFamily> &p_families);
+
+        bool isProgramBuilt(KernelFamily p_family) const;
+
+        const cl::Program &getSpecializedProgram(const std::string &p_kernelFile, const std::string &p_defines);
+
+        std::shared_ptr<ProgramCache> getProgramCache() const
+        {
+            return m_programCache;
+        }
+
+        std::shared_ptr<WorkSizeTuner> getWorkSizeTuner() const
+        {
+            return m_workSizeTuner;
+        }
+
+        std::shared_ptr<CLBlastTuner> getBlasTuner() const
+        {
+            return m_blasTuner;
+        }
+
+        const std::shared_ptr<BufferPool> &getBufferPool() const
+        {
+            return m_bufferPool;
+        }
+
+        const std::shared_ptr<StagingRing> &getStagingRing() const
+        {
+            return m_stagingRing;
+        }
+
+        cl_int enqueueKernel(const cl::CommandQueue &p_queue,
+                             const cl::Kernel &p_kernel,
+                             const cl::NDRange &p_global,
+                             const std::vector<cl::Event> *p_waitList = nullptr,
+                             cl::Event *p_event = nullptr) const
+        {
+            cl::Event event;
+            cl_int err = m_workSizeTuner->enqueue(p_queue, p_kernel, p_global, p_waitList, p_event ? p_event : (m_recorder ? &event : nullptr));
+            if (m_recorder)
+            {
+                cl::NDRange local = m_workSizeTuner->getLocalSize(p_queue.getInfo<CL_QUEUE_DEVICE>(), p_kernel, p_global);
+                m_recorder->recordKernel(p_queue, p_kernel, p_global, local, p_waitList, p_event ? *p_event : event);
+                if (!m_workSizeTuner->isSettled(p_queue, p_kernel, p_global))
+                {
+                    m_recorder->markProvisional();
+                }
+            }
+            return err;
+        }
+
+        // Kernels whose work-items cooperate through local memory fix their own local size instead of
+        // leaving it to the tuner.
+        cl_int enqueueKernel(const cl::CommandQueue &p_queue,
+                             const cl::Kernel &p_kernel,
+                             const cl::NDRange &p_global,
+                             const cl::NDRange &p_local,
+                             const std::vector<cl::Event> *p_waitList = nullptr,
+                             cl::Event *p_event = nullptr) const
+        {
+            cl::Event event;
+            cl_int err = p_queue.enqueueNDRangeKernel(p_kernel, cl::NullRange, p_global, p_local, p_waitList, p_event ? p_event : (m_recorder ? &event : nullptr));
+            if (m_recorder)
+            {
+                m_recorder->recordKernel(p_queue, p_kernel, p_global, p_local, p_waitList, p_event ? *p_event : event);
+            }
+            return err;
+        }
+
+        cl_int enqueueBarrier(const cl::CommandQueue &p_queue,
+                              const std::vector<cl::Event> *p_waitList = nullptr,
+                              cl::Event *p_event = nullptr) const
+        {
+            cl::Event event;
+            cl_int err = p_queue.enqueueBarrierWithWaitList(p_waitList, p_event ? p_event : (m_recorder ? &event : nullptr));
+            if (m_recorder)
+            {
+                m_recorder->recordBarrier(p_queue, p_waitList, p_event ? *p_event : event);
+            }
+            return err;
+        }
+
+        // Enqueues work that does not go through a cl::Kernel (CLBlast routines). The routine is run once
+        // now and, while a step is being recorded, again on every replay.
+        cl::Event enqueueRoutine(const cl::CommandQueue &p_queue, const CommandRecorder::Routine &p_routine) const
+        {
+            cl::Event event(p_routine(p_queue()));
+            if (m_recorder)
+            {
+                m_recorder->recordRoutine(p_queue, p_routine, event);
+            }
+            return event;
+        }
+
+        // Commands enqueued through the helpers above are also recorded while a recorder is set.
+        void setCommandRecorder(CommandRecorder *p_recorder)
+        {
+            m_recorder = p_recorder;
+        }
+
+        bool isRecording() const { return m_recorder != nullptr; }
+
+        size_t getSpecializedProgramCount() const;
+
+        const std::string &getKernelsPath() const
+        {
+            return m_kernelsPath;
         }
 
     private:
         cl::Context m_context;
-        cl::Program m_program;
+        std::vector<cl::Device> m_devices;
+        std::shared_ptr<ProgramCache> m_programCache;
+        std::shared_ptr<WorkSizeTuner> m_workSizeTuner;
+        std::shared_ptr<CLBlastTuner> m_blasTuner;
+        std::shared_ptr<BufferPool> m_bufferPool;
+        std::shared_ptr<StagingRing> m_stagingRing;
+        CommandRecorder *m_recorder = nullptr;
+        std::string m_kernelsPath;
+        std::string m_buildOptions;
+        std::map<std::string, std::shared_future<cl::Program>> m_programs;
+        mutable std::mutex m_programsMutex;
+
+        std::shared_future<cl::Program> requestProgram(const std::string &p_key, const std::vector<std::string> &p_kernelSources, const std::string &p_defines);
+        cl::Program buildProgram(const std::vector<std::string> &p_kernelSources, const std::string &p_defines) const;
     };
 
     struct OpenCLResources
@@ -63,9 +209,14 @@ namespace Utils
             return m_sharedResources->getContext();
         }
 
-        const cl::Program &getProgram() const
+        const cl::Program &getProgram(KernelFamily p_family) const
         {
-            return m_sharedResources->getProgram();
+            return m_sharedResources->getProgram(p_family);
+        }
+
+        const cl::Device &getDevice() const
+        {
+            return m_device;
         }
 
         const cl::CommandQueue &getForwardBackpropQueue() const
@@ -81,9 +232,21 @@ namespace Utils
             return m_concurrentQueue;
         }
 
-        static OpenCLResources createOpenCLResources(const std::string &p_kernelsPath = KERNELS_DIR, size_t p_platformIndex = 0, size_t p_deviceIndex = 0);
+        static OpenCLResources createOpenCLResources(const std::string &p_kernelsPath = KERNELS_DIR, size_t p_platformIndex = 0, size_t p_deviceIndex = 0,
+                                                     const std::string &p_programCacheDirectory = KERNELS_CACHE_DIR);
+
+        static OpenCLResources createOpenCLResources(const DeviceCapabilities &p_device,
+                                                     const std::string &p_kernelsPath = KERNELS_DIR,
+                                                     const std::string &p_programCacheDirectory = KERNELS_CACHE_DIR);
+
+        static OpenCLResources createOpenCLResources(const std::vector<DeviceCapabilities> &p_devices,
+                                                     const std::string &p_kernelsPath = KERNELS_DIR,
+                                                     const std::string &p_programCacheDirectory = KERNELS_CACHE_DIR);
 
-        static OpenCLResources createOpenCLResources(std::shared_ptr<SharedResources> p_sharedResources);
+        static OpenCLResources createBestOpenCLResources(const std::string &p_kernelsPath = KERNELS_DIR,
+                                                         const std::string &p_programCacheDirectory = KERNELS_CACHE_DIR);
+
+        static OpenCLResources createOpenCLResources(std::shared_ptr<SharedResources> p_sharedResources, size_t p_deviceIndex = 0);
 
         void print() const;
 
@@ -91,27 +254,23 @@ namespace Utils
 
     private:
         std::shared_ptr<SharedResources> m_sharedResources;
+        cl::Device m_device;
         cl::CommandQueue m_forwardBackpropQueue;
         cl::CommandQueue m_deltaToGradientQueue;
         cl::CommandQueue m_concurrentQueue;
 
-        OpenCLResources(cl::Context &&p_context, cl::Program &&p_program,
-                        cl::CommandQueue &&p_forwardBackpropQueue, cl::CommandQueue &&p_deltaToGradientQueue,
-                        cl::CommandQueue &&p_concurrentQueue)
-            : m_sharedResources(std::make_shared<SharedResources>(std::move(p_context), std::move(p_program))),
-              m_forwardBackpropQueue(std::move(p_forwardBackpropQueue)),
-              m_deltaToGradientQueue(std::move(p_deltaToGradientQueue)),
-              m_concurrentQueue(std::move(p_concurrentQueue)) {}
-
-        OpenCLResources(std::shared_ptr<SharedResources> p_sharedResources,
+        OpenCLResources(std::shared_ptr<SharedResources> p_sharedResources, cl::Device &&p_device,
                         cl::CommandQueue &&p_forwardBackpropQueue, cl::CommandQueue &&p_deltaToGradientQueue,
                         cl::CommandQueue &&p_concurrentQueue)
             : m_sharedResources(std::move(p_sharedResources)),
+              m_device(std::move(p_device)),
               m_forwardBackpropQueue(std::move(p_forwardBackpropQueue)),
               m_deltaToGradientQueue(std::move(p_deltaToGradientQueue)),
               m_concurrentQueue(std::move(p_concurrentQueue)) {}
 
-        static std::vector<std::string> getAllKernelFiles(const std::string &p_folderPath);
+        static std::shared_ptr<SharedResources> createSharedResources(cl::Context &&p_context,
+                                                                      const std::string &p_kernelsPath,
+                                                                      const std::string &p_programCacheDirectory);
     };
 
     void saveBuffer(const cl::CommandQueue &p_queue, const cl::Buffer &p_buffer, H5::Group &p_group, const std::string &p_name, size_t p_size);
@@ -264,7 +423,7 @@ namespace Utils
         attr.write(h5Type, &value);
     }
 
-    cl::Buffer loadBuffer(const cl::Context &p_context,
+    cl::Buffer loadBuffer(const std::shared_ptr<BufferPool> &p_bufferPool,
                           const H5::Group &p_layerGroup,
                           const std::string &p_bufferName,
                           size_t p_size);
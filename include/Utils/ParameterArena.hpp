@@ -0,0 +1,55 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+namespace Utils
+{
+    // Weights and biases of every trainable layer as aligned ranges of one parameter buffer, with their
+    // gradients at the same offsets of one gradient buffer. Optimizers keep their state in buffers of the
+    // same layout, so a whole model is updated with a single launch over getTotalElements() elements.
+    // Padding between ranges is zeroed and never read back.
+    class ParameterArena
+    {
+    public:
+        struct Range
+        {
+            std::string m_id;
+            size_t m_offset;
+            size_t m_elements;
+        };
+
+        ParameterArena(const cl::Context &p_context, cl_mem_flags p_memFlags, size_t p_alignment);
+
+        size_t addRange(const std::string &p_id, size_t p_elements);
+
+        void allocate(const cl::CommandQueue &p_queue);
+
+        cl::Buffer createBuffer(const cl::CommandQueue &p_queue) const;
+
+        cl::Buffer createRegion(const cl::Buffer &p_buffer, size_t p_range) const;
+
+        const cl::Buffer &getParameters() const { return m_parameters; }
+
+        const cl::Buffer &getGradients() const { return m_gradients; }
+
+        const std::vector<Range> &getRanges() const { return m_ranges; }
+
+        size_t getRangeCount() const { return m_ranges.size(); }
+
+        size_t getTotalElements() const { return m_totalElements; }
+
+    private:
+        cl::Context m_context;
+        cl_mem_flags m_memFlags;
+        size_t m_alignmentElements;
+        std::vector<Range> m_ranges;
+        size_t m_totalElements = 0;
+        cl::Buffer m_parameters;
+        cl::Buffer m_gradients;
+    };
+}
@@ -0,0 +1,72 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+
+namespace Utils
+{
+    class ProgramCache
+    {
+    public:
+        explicit ProgramCache(const std::string &p_cacheDirectory, const std::string &p_includeDirectory = "");
+
+        cl::Program buildProgram(const cl::Context &p_context,
+                                 const std::vector<cl::Device> &p_devices,
+                                 const cl::Program::Sources &p_sources,
+                                 const std::string &p_buildOptions);
+
+        bool enabled() const
+        {
+            return !m_cacheDirectory.empty();
+        }
+
+        const std::string &getCacheDirectory() const
+        {
+            return m_cacheDirectory;
+        }
+
+        size_t getHits() const
+        {
+            return m_hits.load();
+        }
+
+        size_t getMisses() const
+        {
+            return m_misses.load();
+        }
+
+        double getBuildMilliseconds() const
+        {
+            return m_buildMicroseconds.load() * 1e-3;
+        }
+
+        void printStats() const;
+
+    private:
+        std::string m_cacheDirectory;
+        uint64_t m_includeHash = 0;
+        std::atomic<size_t> m_hits{0};
+        std::atomic<size_t> m_misses{0};
+        std::atomic<uint64_t> m_buildMicroseconds{0};
+
+        std::string computeKey(const std::vector<cl::Device> &p_devices,
+                               const cl::Program::Sources &p_sources,
+                               const std::string &p_buildOptions) const;
+
+        bool loadBinaries(const std::string &p_key, size_t p_deviceCount, cl::Program::Binaries &p_binaries) const;
+
+        void storeBinaries(const std::string &p_key, const cl::Program::Binaries &p_binaries) const;
+
+        static uint64_t hashBytes(const void *p_data, size_t p_size, uint64_t p_seed);
+
+        static uint64_t hashString(const std::string &p_value, uint64_t p_seed);
+
+        static void printBuildLog(const cl::Program &p_program, const std::vector<cl::Device> &p_devices);
+    };
+}
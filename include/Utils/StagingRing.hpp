@@ -0,0 +1,57 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include <mutex>
+#include <vector>
+#include <iostream>
+
+namespace Utils
+{
+    // Ring of pinned (CL_MEM_ALLOC_HOST_PTR, persistently mapped) staging buffers feeding non-blocking
+    // writes on a dedicated transfer queue. upload() returns as soon as the data is staged, so the copy
+    // to the device overlaps whatever the compute queues are running; consumers wait on the returned
+    // event. A slot is only refilled once the transfer that last read it has completed.
+    class StagingRing
+    {
+    public:
+        explicit StagingRing(const cl::Context &p_context, size_t p_slotCount = 4);
+
+        StagingRing(const StagingRing &) = delete;
+        StagingRing &operator=(const StagingRing &) = delete;
+
+        ~StagingRing();
+
+        cl::Event upload(const cl::Buffer &p_buffer, const void *p_data, size_t p_bytes);
+
+        const cl::CommandQueue &getTransferQueue() const
+        {
+            return m_transferQueue;
+        }
+
+        size_t getSlotCount() const
+        {
+            return m_slots.size();
+        }
+
+        size_t getPinnedBytes() const;
+
+    private:
+        struct Slot
+        {
+            cl::Buffer m_pinned;
+            void *m_host = nullptr;
+            size_t m_bytes = 0;
+            cl::Event m_lastUse;
+        };
+
+        cl::Context m_context;
+        cl::CommandQueue m_transferQueue;
+        std::vector<Slot> m_slots;
+        size_t m_next = 0;
+        mutable std::mutex m_mutex;
+
+        void reserve(Slot &p_slot, size_t p_bytes);
+
+        void unmap(Slot &p_slot);
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+#define CL_HPP_ENABLE_EXCEPTIONS
+#include <CL/opencl.hpp>
+#include "Utils/EventProfiler.hpp"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+
+namespace Utils
+{
+    // Picks the local work size of each kernel launch. Untuned (device, kernel, global size) combinations
+    // are benchmarked online: every real launch on a profiling queue tries the next candidate local size and
+    // its event is timed once it has completed, so tuning never adds launches or synchronization.
+    class WorkSizeTuner
+    {
+    public:
+        explicit WorkSizeTuner(const std::string &p_tuningFile = "", size_t p_samplesPerCandidate = 3);
+
+        cl_int enqueue(const cl::CommandQueue &p_queue,
+                       const cl::Kernel &p_kernel,
+                       const cl::NDRange &p_global,
+                       const std::vector<cl::Event> *p_waitList = nullptr,
+                       cl::Event *p_event = nullptr);
+
+        cl::NDRange getLocalSize(const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global);
+
+        // True once getLocalSize() will no longer change for this launch: it is tuned, or it will never be tuned on this queue.
+        bool isSettled(const cl::CommandQueue &p_queue, const cl::Kernel &p_kernel, const cl::NDRange &p_global);
+
+        void setTuningEnabled(bool p_enabled)
+        {
+            m_tuningEnabled = p_enabled;
+        }
+
+        bool isTuningEnabled() const
+        {
+            return m_tuningEnabled;
+        }
+
+        // Prints every local size picked by online tuning. Off by default; printStats() summarizes instead.
+        void setVerbose(bool p_verbose)
+        {
+            m_verbose = p_verbose;
+        }
+
+        bool isVerbose() const
+        {
+            return m_verbose;
+        }
+
+        const std::string &getTuningFile() const
+        {
+            return m_tuningFile;
+        }
+
+        size_t getTunedCount() const;
+
+        size_t getTuningCount() const;
+
+        void collect();
+
+        void save() const;
+
+        void printStats() const;
+
+    private:
+        struct TuningEntry
+        {
+            std::vector<std::vector<size_t>> m_candidates;
+            std::vector<cl_ulong> m_bestNanoseconds;
+            std::vector<size_t> m_samples;
+            std::vector<size_t> m_inFlight;
+            std::vector<size_t> m_winner;
+            cl_ulong m_winnerNanoseconds = 0;
+            bool m_tuned = false;
+        };
+
+        struct PendingLaunch
+        {
+            std::string m_key;
+            size_t m_candidate;
+            cl::Event m_event;
+        };
+
+        std::string m_tuningFile;
+        size_t m_samplesPerCandidate;
+        bool m_tuningEnabled = true;
+        bool m_verbose = false;
+        std::map<std::string, TuningEntry> m_entries;
+        std::map<cl_device_id, std::string> m_deviceNames;
+        std::vector<PendingLaunch> m_pending;
+        mutable std::mutex m_mutex;
+
+        static const size_t MAX_PENDING_LAUNCHES = 256;
+        static const size_t MAX_CANDIDATES = 10;
+
+        std::string makeKey(const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global);
+
+        TuningEntry &getEntry(const std::string &p_key, const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global);
+
+        size_t nextCandidate(const TuningEntry &p_entry) const;
+
+        void collectLocked();
+
+        void finishTuning(const std::string &p_key, TuningEntry &p_entry);
+
+        void load();
+
+        void saveLocked() const;
+
+        static std::vector<std::vector<size_t>> generateCandidates(const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global);
+
+        static cl::NDRange toNDRange(const std::vector<size_t> &p_sizes);
+
+        static std::string sizesToString(const std::vector<size_t> &p_sizes);
+
+        static std::vector<size_t> sizesFromString(const std::string &p_value);
+    };
+}
@@ -1,48 +1,73 @@
+#include "HelperFunctions.clh"
+
+// Outputs keep the sign of the inputs for alpha >= 0, so they stand in for the pre-activations. Like the
+// forward kernels, the unmasked ones stride over p_count elements.
 __kernel void leakyReLUBackward(
     __global float* p_previousDeltas,
     __global const float* p_deltas,
-    __global const float* p_preActivations,
+    __global const float* p_outputs,
+    const float p_alpha,
+    const unsigned int p_count
+    )
+{
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        const float delta = p_deltas[idx];
+        p_previousDeltas[idx] = (p_outputs[idx] > 0.0f) ? delta : p_alpha * delta;
+    }
+}
+
+__kernel void leakyReLUBackwardMasked(
+    __global float* p_previousDeltas,
+    __global const float* p_deltas,
+    __global const uint* p_signMask,
     const float p_alpha
     )
 {
     const unsigned int idx = get_global_id(0);
-    const float x = p_preActivations[idx];
+    const uint positive = (p_signMask[idx >> 5] >> (idx & 31)) & 1u;
     const float delta = p_deltas[idx];
-    p_previousDeltas[idx] = (x > 0.0f) * delta + (x <= 0.0f) * (p_alpha * delta);
+    p_previousDeltas[idx] = positive ? delta : p_alpha * delta;
 }
 
 __kernel void reLUBackward(
     __global float* p_previousDeltas,
     __global const float* p_deltas,
-    __global const float* p_preActivations
+    __global const float* p_outputs,
+    const float p_alpha,
+    const unsigned int p_count
     )
 {
-    const unsigned int idx = get_global_id(0);
-    const float x = p_preActivations[idx];
-    const float delta = p_deltas[idx];
-    p_previousDeltas[idx] = (x > 0.0f) ? delta : 0.0f;
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        p_previousDeltas[idx] = (p_outputs[idx] > 0.0f) ? p_deltas[idx] : 0.0f;
+    }
 }
 
 __kernel void sigmoidBackward(
     __global float* p_previousDeltas,
     __global const float* p_deltas,
-    __global const float* p_outputs
+    __global const float* p_outputs,
+    const float p_alpha,
+    const unsigned int p_count
     )
 {
-    const unsigned int idx = get_global_id(0);
-    const float y = p_outputs[idx];
-    p_previousDeltas[idx] = p_deltas[idx] * y * (1.0f - y);
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        const float y = p_outputs[idx];
+        p_previousDeltas[idx] = p_deltas[idx] * y * (1.0f - y);
+    }
 }
 
 __kernel void tanhBackward(
     __global float* p_previousDeltas,
     __global const float* p_deltas,
-    __global const float* p_outputs
+    __global const float* p_outputs,
+    const float p_alpha,
+    const unsigned int p_count
     )
 {
-    const unsigned int idx = get_global_id(0);
-    const float y = p_outputs[idx];
-    p_previousDeltas[idx] = p_deltas[idx] * (1.0f - y * y);
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        const float y = p_outputs[idx];
+        p_previousDeltas[idx] = p_deltas[idx] * (1.0f - y * y);
+    }
 }
 
 __kernel void softmaxBackward(
@@ -64,3 +89,44 @@ __kernel void softmaxBackward(
         p_previousDeltas[offset + i] = y * (p_deltas[offset + i] - dot);
     }
 }
+
+// Work-group counterpart of softmaxBackward with the same launch rules as softmaxForwardRows.
+__kernel void softmaxBackwardRows(
+    __global float* p_previousDeltas,
+    __global const float* p_deltas,
+    __global const float* p_outputs,
+    const unsigned int p_numClasses
+    )
+{
+    __local float dots[SOFTMAX_ROW_GROUP_SIZE];
+
+    const unsigned int lid = get_local_id(0);
+    const unsigned int localSize = get_local_size(0);
+    const unsigned int offset = get_group_id(0) * p_numClasses;
+    __global float* previousDeltas = p_previousDeltas + offset;
+    __global const float* deltas = p_deltas + offset;
+    __global const float* outputs = p_outputs + offset;
+    const unsigned int chunks = p_numClasses / 4;
+
+    float partial = 0.0f;
+    for (unsigned int i = lid; i < chunks; i += localSize)
+        partial += dot(vload4(i, outputs), vload4(i, deltas));
+    for (unsigned int i = chunks * 4 + lid; i < p_numClasses; i += localSize)
+        partial += outputs[i] * deltas[i];
+    dots[lid] = partial;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (unsigned int stride = localSize / 2; stride > 0; stride >>= 1) {
+        if (lid < stride)
+            dots[lid] += dots[lid + stride];
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    const float rowDot = dots[0];
+    for (unsigned int i = lid; i < chunks; i += localSize) {
+        const float4 y = vload4(i, outputs);
+        vstore4(y * (vload4(i, deltas) - rowDot), i, previousDeltas);
+    }
+    for (unsigned int i = chunks * 4 + lid; i < p_numClasses; i += localSize)
+        previousDeltas[i] = outputs[i] * (deltas[i] - rowDot);
+}
@@ -1,42 +1,76 @@
+#include "HelperFunctions.clh"
+
+// The scalar elementwise kernels are the width-1 variants of ActivationVectorKernels.cl: the same arguments,
+// and each work-item strides over the p_count elements, so any global size works. Only LeakyReLU reads p_alpha.
 __kernel void leakyReLUForward(
     __global const float* p_inputs,
     __global float* p_outputs,
-    __global float* p_preActivations,
-    const float p_alpha
+    const float p_alpha,
+    const unsigned int p_count
+    )
+{
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        const float x = p_inputs[idx];
+        p_outputs[idx] = (x > 0.0f) ? x : p_alpha * x;
+    }
+}
+
+// For alpha < 0 the outputs no longer carry the sign of the inputs, so each work-item also packs
+// the signs of 32 consecutive inputs into one word of a bit mask.
+__kernel void leakyReLUForwardMasked(
+    __global const float* p_inputs,
+    __global float* p_outputs,
+    __global uint* p_signMask,
+    const float p_alpha,
+    const unsigned int p_count
     )
 {
-    const unsigned int idx = get_global_id(0);
-    const float x = p_inputs[idx];
-    p_preActivations[idx] = x;
-    p_outputs[idx] = (x > 0.0f) * x + (x <= 0.0f) * (p_alpha * x);
+    const unsigned int word = get_global_id(0);
+    const unsigned int first = word * 32;
+    const unsigned int last = min(first + 32, p_count);
+    uint bits = 0;
+    for (unsigned int idx = first; idx < last; ++idx) {
+        const float x = p_inputs[idx];
+        bits |= (uint)(x > 0.0f) << (idx - first);
+        p_outputs[idx] = (x > 0.0f) * x + (x <= 0.0f) * (p_alpha * x);
+    }
+    p_signMask[word] = bits;
 }
 
 __kernel void reLUForward(
     __global const float* p_inputs,
     __global float* p_outputs,
-    __global float* p_preActivations
+    const float p_alpha,
+    const unsigned int p_count
     )
 {
-    const unsigned int idx = get_global_id(0);
-    const float x = p_inputs[idx];
-    p_preActivations[idx] = x;
-    p_outputs[idx] = fmax(x, 0.0f);
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        p_outputs[idx] = fmax(p_inputs[idx], 0.0f);
+    }
 }
 
 __kernel void sigmoidForward(
     __global const float* p_inputs,
-    __global float* p_outputs)
+    __global float* p_outputs,
+    const float p_alpha,
+    const unsigned int p_count
+    )
 {
-    const unsigned int idx = get_global_id(0);
-    p_outputs[idx] = 1.0f / (1.0f + exp(-p_inputs[idx]));
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        p_outputs[idx] = 1.0f / (1.0f + exp(-p_inputs[idx]));
+    }
 }
 
 __kernel void tanhForward(
     __global const float* p_inputs,
-    __global float* p_outputs)
+    __global float* p_outputs,
+    const float p_alpha,
+    const unsigned int p_count
+    )
 {
-    const unsigned int idx = get_global_id(0);
-    p_outputs[idx] = tanh(p_inputs[idx]);
+    for (unsigned int idx = get_global_id(0); idx < p_count; idx += get_global_size(0)) {
+        p_outputs[idx] = tanh(p_inputs[idx]);
+    }
 }
 
 __kernel void softmaxForward(
@@ -59,3 +93,57 @@ __kernel void softmaxForward(
     for (unsigned int i = 0; i < p_numClasses; ++i)
         p_outputs[offset + i] = exp(p_inputs[offset + i] - maxVal) / sumExp;
 }
+
+// One work-group per row; the local size must be a power of two no larger than SOFTMAX_ROW_GROUP_SIZE.
+// Work-items read strided float4 chunks of the row, fold them into a running max and a sum of exponentials
+// rescaled to it, and merge the partials in local memory before writing the outputs with the same stride.
+__kernel void softmaxForwardRows(
+    __global const float* p_inputs,
+    __global float* p_outputs,
+    const unsigned int p_numClasses)
+{
+    __local float maxima[SOFTMAX_ROW_GROUP_SIZE];
+    __local float sums[SOFTMAX_ROW_GROUP_SIZE];
+
+    const unsigned int lid = get_local_id(0);
+    const unsigned int localSize = get_local_size(0);
+    __global const float* inputs = p_inputs + get_group_id(0) * p_numClasses;
+    __global float* outputs = p_outputs + get_group_id(0) * p_numClasses;
+    const unsigned int chunks = p_numClasses / 4;
+
+    float maxVal = -FLT_MAX;
+    float sumExp = 0.0f;
+    for (unsigned int i = lid; i < chunks; i += localSize) {
+        const float4 x = vload4(i, inputs);
+        const float newMax = fmax(maxVal, fmax(fmax(x.s0, x.s1), fmax(x.s2, x.s3)));
+        const float4 e = exp(x - newMax);
+        sumExp = sumExp * exp(maxVal - newMax) + (e.s0 + e.s1) + (e.s2 + e.s3);
+        maxVal = newMax;
+    }
+    for (unsigned int i = chunks * 4 + lid; i < p_numClasses; i += localSize) {
+        const float x = inputs[i];
+        const float newMax = fmax(maxVal, x);
+        sumExp = sumExp * exp(maxVal - newMax) + exp(x - newMax);
+        maxVal = newMax;
+    }
+    maxima[lid] = maxVal;
+    sums[lid] = sumExp;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (unsigned int stride = localSize / 2; stride > 0; stride >>= 1) {
+        if (lid < stride) {
+            const float otherMax = maxima[lid + stride];
+            const float mergedMax = fmax(maxima[lid], otherMax);
+            sums[lid] = sums[lid] * exp(maxima[lid] - mergedMax) + sums[lid + stride] * exp(otherMax - mergedMax);
+            maxima[lid] = mergedMax;
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    maxVal = maxima[0];
+    const float inverseSum = 1.0f / sums[0];
+    for (unsigned int i = lid; i < chunks; i += localSize)
+        vstore4(exp(vload4(i, inputs) - maxVal) * inverseSum, i, outputs);
+    for (unsigned int i = chunks * 4 + lid; i < p_numClasses; i += localSize)
+        outputs[i] = exp(inputs[i] - maxVal) * inverseSum;
+}
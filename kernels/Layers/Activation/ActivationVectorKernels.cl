@@ -0,0 +1,56 @@
+// Grid-stride float4/float8 variants of the elementwise activations. A work-item handles vectors g,
+// g + globalSize, ... of the first p_count / W * W elements and then the same stride over the scalar tail,
+// so any global size works. The expressions use ?: so that they apply to vectors and scalars alike.
+// Every variant takes p_alpha (only LeakyReLU reads it) and the element count as its last arguments.
+
+#define ACTIVATION_FORWARD_VECTOR(NAME, W, EXPR)                                        \
+__kernel void NAME##Vec##W(                                                             \
+    __global const float* p_inputs,                                                     \
+    __global float* p_outputs,                                                          \
+    const float p_alpha,                                                                \
+    const unsigned int p_count)                                                         \
+{                                                                                       \
+    const unsigned int stride = get_global_size(0);                                     \
+    const unsigned int vectors = p_count / W;                                           \
+    for (unsigned int i = get_global_id(0); i < vectors; i += stride) {                 \
+        const float##W x = vload##W(i, p_inputs);                                       \
+        vstore##W(EXPR, i, p_outputs);                                                  \
+    }                                                                                   \
+    for (unsigned int i = vectors * W + get_global_id(0); i < p_count; i += stride) {   \
+        const float x = p_inputs[i];                                                    \
+        p_outputs[i] = EXPR;                                                            \
+    }                                                                                   \
+}
+
+#define ACTIVATION_BACKWARD_VECTOR(NAME, W, EXPR)                                       \
+__kernel void NAME##Vec##W(                                                             \
+    __global float* p_previousDeltas,                                                   \
+    __global const float* p_deltas,                                                     \
+    __global const float* p_outputs,                                                    \
+    const float p_alpha,                                                                \
+    const unsigned int p_count)                                                         \
+{                                                                                       \
+    const unsigned int stride = get_global_size(0);                                     \
+    const unsigned int vectors = p_count / W;                                           \
+    for (unsigned int i = get_global_id(0); i < vectors; i += stride) {                 \
+        const float##W y = vload##W(i, p_outputs);                                      \
+        const float##W delta = vload##W(i, p_deltas);                                   \
+        vstore##W(EXPR, i, p_previousDeltas);                                           \
+    }                                                                                   \
+    for (unsigned int i = vectors * W + get_global_id(0); i < p_count; i += stride) {   \
+        const float y = p_outputs[i];                                                   \
+        const float delta = p_deltas[i];                                                \
+        p_previousDeltas[i] = EXPR;                                                     \
+    }                                                                                   \
+}
+
+#define ACTIVATION_VECTOR_KERNELS(NAME, FORWARD_EXPR, BACKWARD_EXPR)                    \
+    ACTIVATION_FORWARD_VECTOR(NAME##Forward, 4, FORWARD_EXPR)                           \
+    ACTIVATION_FORWARD_VECTOR(NAME##Forward, 8, FORWARD_EXPR)                           \
+    ACTIVATION_BACKWARD_VECTOR(NAME##Backward, 4, BACKWARD_EXPR)                        \
+    ACTIVATION_BACKWARD_VECTOR(NAME##Backward, 8, BACKWARD_EXPR)
+
+ACTIVATION_VECTOR_KERNELS(reLU, fmax(x, 0.0f), (y > 0.0f) ? delta : 0.0f)
+ACTIVATION_VECTOR_KERNELS(leakyReLU, (x > 0.0f) ? x : p_alpha * x, (y > 0.0f) ? delta : p_alpha * delta)
+ACTIVATION_VECTOR_KERNELS(sigmoid, 1.0f / (1.0f + exp(-x)), delta * y * (1.0f - y))
+ACTIVATION_VECTOR_KERNELS(tanh, tanh(x), delta * (1.0f - y * y))
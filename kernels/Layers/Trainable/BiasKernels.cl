@@ -1,3 +1,5 @@
+#include "FusedActivation.clh"
+
 __kernel void denseBias(
     __global const float* p_biases,
     __global float* p_outputs,
@@ -6,3 +8,17 @@ __kernel void denseBias(
     unsigned int idx = get_global_id(1) * p_outputSize + outNeuronIdx;
     p_outputs[idx] += p_biases[outNeuronIdx];
 }
+
+// Bias addition with a following activation folded in: reads the bare product and writes the activated
+// values into the activation layer's outputs, saving that layer's separate pass over the tensor.
+__kernel void denseBiasActivation(
+    __global const float* p_biases,
+    __global const float* p_preActivations,
+    __global float* p_outputs,
+    const unsigned int p_activation,
+    const float p_alpha,
+    const unsigned int p_outputSize) {
+    unsigned int outNeuronIdx = get_global_id(0);
+    unsigned int idx = get_global_id(1) * p_outputSize + outNeuronIdx;
+    p_outputs[idx] = applyFusedActivation(p_preActivations[idx] + p_biases[outNeuronIdx], p_activation, p_alpha);
+}
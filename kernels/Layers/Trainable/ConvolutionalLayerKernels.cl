@@ -1,3 +1,20 @@
+#include "FusedActivation.clh"
+
+#ifndef CONV_IC
+#define CONV_IC p_IC
+#define CONV_IH p_IH
+#define CONV_IW p_IW
+#define CONV_OC p_OC
+#define CONV_OH p_OH
+#define CONV_OW p_OW
+#define CONV_FH p_FH
+#define CONV_FW p_FW
+#define CONV_STRIDE_H p_strideH
+#define CONV_STRIDE_W p_strideW
+#define CONV_PAD_H p_padH
+#define CONV_PAD_W p_padW
+#endif
+
 __kernel void convolutionalBias(
     __global const float* p_biases,
     __global float* p_outputs,
@@ -16,6 +33,27 @@ __kernel void convolutionalBias(
     p_outputs[outputIndex] += p_biases[oc];
 }
 
+__kernel void convolutionalBiasActivation(
+    __global const float* p_biases,
+    __global const float* p_preActivations,
+    __global float* p_outputs,
+    const unsigned int p_activation,
+    const float p_alpha,
+    const int p_OH,
+    const int p_OW,
+    const int p_OC)
+{
+    const int oc = get_global_id(0);
+    const int spatialIdx = get_global_id(1);
+    const int b = get_global_id(2);
+
+    int outputIndex = b * (p_OC * p_OH * p_OW)
+                    + oc * (p_OH * p_OW)
+                    + spatialIdx;
+
+    p_outputs[outputIndex] = applyFusedActivation(p_preActivations[outputIndex] + p_biases[oc], p_activation, p_alpha);
+}
+
 __kernel void convolutionalBackpropDeltas(
     __global const float* p_weights,
     __global const float* p_deltas,
@@ -33,45 +71,45 @@ __kernel void convolutionalBackpropDeltas(
     const int ih = get_global_id(1);
     const int icBatch = get_global_id(2);
 
-    if (ih >= p_IH || iw0 >= p_IW) return;
+    if (ih >= CONV_IH || iw0 >= CONV_IW) return;
 
-    const int ic = icBatch % p_IC;
-    const int b  = icBatch / p_IC;
+    const int ic = icBatch % CONV_IC;
+    const int b  = icBatch / CONV_IC;
 
     float acc0 = 0.0f;
     float acc1 = 0.0f;
 
-    const int filterSize = p_FH * p_FW;
+    const int filterSize = CONV_FH * CONV_FW;
     const int icWeightOffset = ic * filterSize;
-    const int weightStride = p_IC * filterSize;
-    const int deltaStride = p_OH * p_OW;
-    const int batchDeltaOffset = b * p_OC * deltaStride;
+    const int weightStride = CONV_IC * filterSize;
+    const int deltaStride = CONV_OH * CONV_OW;
+    const int batchDeltaOffset = b * CONV_OC * deltaStride;
 
-    const int fhStart = max(0, ih + p_padH - (p_OH - 1) * p_strideH);
-    const int fhEnd = min(p_FH, ih + p_padH + 1);
+    const int fhStart = max(0, ih + CONV_PAD_H - (CONV_OH - 1) * CONV_STRIDE_H);
+    const int fhEnd = min(CONV_FH, ih + CONV_PAD_H + 1);
 
     for (int fh = fhStart; fh < fhEnd; fh++) {
-        int ohIdx = ih + p_padH - fh;
-        if (ohIdx % p_strideH != 0) continue;
-        int oh = ohIdx / p_strideH;
+        int ohIdx = ih + CONV_PAD_H - fh;
+        if (ohIdx % CONV_STRIDE_H != 0) continue;
+        int oh = ohIdx / CONV_STRIDE_H;
 
-        for (int fw = 0; fw < p_FW; fw++) {
-            int owIdx0 = iw0 + p_padW - fw;
-            int owIdx1 = iw1 + p_padW - fw;
+        for (int fw = 0; fw < CONV_FW; fw++) {
+            int owIdx0 = iw0 + CONV_PAD_W - fw;
+            int owIdx1 = iw1 + CONV_PAD_W - fw;
 
-            int ow0 = (owIdx0 >= 0 && owIdx0 % p_strideW == 0) ? owIdx0 / p_strideW : -1;
-            int ow1 = (owIdx1 >= 0 && owIdx1 % p_strideW == 0) ? owIdx1 / p_strideW : -1;
+            int ow0 = (owIdx0 >= 0 && owIdx0 % CONV_STRIDE_W == 0) ? owIdx0 / CONV_STRIDE_W : -1;
+            int ow1 = (owIdx1 >= 0 && owIdx1 % CONV_STRIDE_W == 0) ? owIdx1 / CONV_STRIDE_W : -1;
             
-            if (ow0 >= p_OW) ow0 = -1;
-            if (ow1 >= p_OW) ow1 = -1;
+            if (ow0 >= CONV_OW) ow0 = -1;
+            if (ow1 >= CONV_OW) ow1 = -1;
 
             if (ow0 == -1 && ow1 == -1) continue;
 
-            int weightIdx = icWeightOffset + (fh * p_FW + fw);
-            int deltaBase = batchDeltaOffset + (oh * p_OW);
+            int weightIdx = icWeightOffset + (fh * CONV_FW + fw);
+            int deltaBase = batchDeltaOffset + (oh * CONV_OW);
             
             int oc = 0;
-            for (; oc <= p_OC - 4; oc += 4) {
+            for (; oc <= CONV_OC - 4; oc += 4) {
                 float4 w4 = (float4)(
                     p_weights[(oc + 0) * weightStride + weightIdx],
                     p_weights[(oc + 1) * weightStride + weightIdx],
@@ -100,7 +138,7 @@ __kernel void convolutionalBackpropDeltas(
                 }
             }
             
-            for (; oc < p_OC; oc++) {
+            for (; oc < CONV_OC; oc++) {
                 float w = p_weights[oc * weightStride + weightIdx];
                 if (ow0 != -1) acc0 += w * p_deltas[oc * deltaStride + deltaBase + ow0];
                 if (ow1 != -1) acc1 += w * p_deltas[oc * deltaStride + deltaBase + ow1];
@@ -108,53 +146,70 @@ __kernel void convolutionalBackpropDeltas(
         }
     }
 
-    const int outputIdx = icBatch * (p_IH * p_IW) + ih * p_IW;
+    const int outputIdx = icBatch * (CONV_IH * CONV_IW) + ih * CONV_IW;
     p_prevDeltas[outputIdx + iw0] = acc0;
-    if (iw1 < p_IW) {
+    if (iw1 < CONV_IW) {
         p_prevDeltas[outputIdx + iw1] = acc1;
     }
 }
 
-__kernel void convolutionalComputeWeightsGradients(
-    __global const float* p_deltas,
-    __global float* p_weightGradients,
+// Weight gradients are one GEMM per chunk of samples: deltas (OC x samples*OH*OW) times the transposed
+// im2col columns (IC*FH*FW x samples*OH*OW). Column b*OH*OW + oh*OW + ow holds the input patch that
+// output position saw, with zeros where the filter overlapped the padding.
+__kernel void convolutionalIm2col(
+    __global const float* p_inputs,
+    __global float* p_columns,
     const int p_IC, const int p_IH, const int p_IW,
-    const int p_OC, const int p_OH, const int p_OW,
+    const int p_OH, const int p_OW,
     const int p_FH, const int p_FW,
     const int p_strideH, const int p_strideW,
     const int p_padH, const int p_padW,
-    __global const float* p_inputs,
-    const int p_B
+    const int p_firstSample,
+    const int p_samples
 ) {
-    const int fw = get_global_id(0);
-    const int fh = get_global_id(1);
-    const int icOc = get_global_id(2);
-    
-    const int ic = icOc % p_IC;
-    const int oc = icOc / p_IC;
-
-    if (fw >= p_FW || fh >= p_FH || oc >= p_OC) return;
+    const int column = get_global_id(0);
+    const int row = get_global_id(1);
+    const int spatialSize = CONV_OH * CONV_OW;
+    const int columns = p_samples * spatialSize;
+
+    if (column >= columns || row >= CONV_IC * CONV_FH * CONV_FW) return;
+
+    const int b = column / spatialSize;
+    const int oh = (column % spatialSize) / CONV_OW;
+    const int ow = column % CONV_OW;
+    const int fw = row % CONV_FW;
+    const int fh = (row / CONV_FW) % CONV_FH;
+    const int ic = row / (CONV_FH * CONV_FW);
+
+    const int ih = (oh * CONV_STRIDE_H) - CONV_PAD_H + fh;
+    const int iw = (ow * CONV_STRIDE_W) - CONV_PAD_W + fw;
+
+    float value = 0.0f;
+    if (ih >= 0 && ih < CONV_IH && iw >= 0 && iw < CONV_IW) {
+        value = p_inputs[(p_firstSample + b) * (CONV_IC * CONV_IH * CONV_IW) + ic * (CONV_IH * CONV_IW) + ih * CONV_IW + iw];
+    }
+    p_columns[row * columns + column] = value;
+}
 
-    float gradientSum = 0.0f;
+// Lays the deltas of a chunk of samples out as one OC x samples*OH*OW matrix, p_offset floats into the workspace.
+__kernel void convolutionalGatherDeltas(
+    __global const float* p_deltas,
+    __global float* p_columns,
+    const int p_OC, const int p_OH, const int p_OW,
+    const int p_offset,
+    const int p_firstSample,
+    const int p_samples
+) {
+    const int column = get_global_id(0);
+    const int oc = get_global_id(1);
+    const int spatialSize = CONV_OH * CONV_OW;
+    const int columns = p_samples * spatialSize;
 
-    for (int b = 0; b < p_B; b++) {
-        for (int oh = 0; oh < p_OH; oh++) {
-            for (int ow = 0; ow < p_OW; ow++) {
-                int ih = (oh * p_strideH) - p_padH + fh;
-                int iw = (ow * p_strideW) - p_padW + fw;
-
-                if (ih >= 0 && ih < p_IH && iw >= 0 && iw < p_IW) {
-                    int inputIdx = b * (p_IC * p_IH * p_IW) + ic * (p_IH * p_IW) + ih * p_IW + iw;
-                    int deltaIdx = b * (p_OC * p_OH * p_OW) + oc * (p_OH * p_OW) + oh * p_OW + ow;
-                    
-                    gradientSum += p_inputs[inputIdx] * p_deltas[deltaIdx];
-                }
-            }
-        }
-    }
+    if (column >= columns || oc >= CONV_OC) return;
 
-    const int weightIdx = oc * (p_IC * p_FH * p_FW) + ic * (p_FH * p_FW) + fh * p_FW + fw;
-    p_weightGradients[weightIdx] = gradientSum / (float)p_B;
+    const int b = column / spatialSize;
+    const int spatialIdx = column % spatialSize;
+    p_columns[p_offset + oc * columns + column] = p_deltas[(p_firstSample + b) * (CONV_OC * spatialSize) + oc * spatialSize + spatialIdx];
 }
 
 __kernel void convolutionalComputeBiasesGradients(
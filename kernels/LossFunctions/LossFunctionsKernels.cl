@@ -1,3 +1,5 @@
+#include "HelperFunctions.clh"
+
 __kernel void meanSquaredErrorComputeGradients(
     __global const float* p_predictions,
     __global const float* p_targets,
@@ -41,28 +43,177 @@ __kernel void categoricalCrossEntropyComputeGradients(
 }
 
 
+// One work-group per sample; the local size must be a power of two no larger than SOFTMAX_ROW_GROUP_SIZE.
+// Each work-item keeps a running max and a sum of exponentials rescaled to it over a strided share of the
+// classes, and the partials are merged in local memory. The logits are read once for the row statistics and
+// once for the gradient, so the cost grows linearly with the class count. With p_writeLosses the cross-entropy
+// of each sample's softmax is written to p_sampleLosses as well; without p_writeGradients only the losses are.
 __kernel void softmaxCrossEntropyComputeGradients(
     __global const float* p_logits,
     __global const float* p_targets,
     __global float* p_gradients,
-    const unsigned int p_numClasses
+    __global float* p_sampleLosses,
+    const unsigned int p_numClasses,
+    const unsigned int p_writeLosses,
+    const unsigned int p_writeGradients
 ) {
-    const uint batchIdx = get_global_id(0);
-    const uint classIdx = get_global_id(1);
+    __local float maxima[SOFTMAX_ROW_GROUP_SIZE];
+    __local float sums[SOFTMAX_ROW_GROUP_SIZE];
+    __local float targetDots[SOFTMAX_ROW_GROUP_SIZE];
+    __local float targetSums[SOFTMAX_ROW_GROUP_SIZE];
 
-    const uint base = batchIdx * p_numClasses;
+    const uint row = get_group_id(0);
+    const uint lid = get_local_id(0);
+    const uint localSize = get_local_size(0);
+    const uint base = row * p_numClasses;
 
     float maxLogit = -FLT_MAX;
-    for (uint c = 0; c < p_numClasses; ++c)
-        maxLogit = fmax(maxLogit, p_logits[base + c]);
-
     float sumExp = 0.0f;
-    for (uint c = 0; c < p_numClasses; ++c)
-        sumExp += exp(p_logits[base + c] - maxLogit);
+    float targetDot = 0.0f;
+    float targetSum = 0.0f;
+    for (uint c = lid; c < p_numClasses; c += localSize) {
+        const float z = p_logits[base + c];
+        const float t = p_targets[base + c];
+        if (z > maxLogit) {
+            sumExp = sumExp * exp(maxLogit - z) + 1.0f;
+            maxLogit = z;
+        } else {
+            sumExp += exp(z - maxLogit);
+        }
+        targetDot += t * z;
+        targetSum += t;
+    }
+    maxima[lid] = maxLogit;
+    sums[lid] = sumExp;
+    targetDots[lid] = targetDot;
+    targetSums[lid] = targetSum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint stride = localSize / 2; stride > 0; stride >>= 1) {
+        if (lid < stride) {
+            const float otherMax = maxima[lid + stride];
+            const float mergedMax = fmax(maxima[lid], otherMax);
+            sums[lid] = sums[lid] * exp(maxima[lid] - mergedMax) + sums[lid + stride] * exp(otherMax - mergedMax);
+            maxima[lid] = mergedMax;
+            targetDots[lid] += targetDots[lid + stride];
+            targetSums[lid] += targetSums[lid + stride];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
 
-    float softmax =
-        exp(p_logits[base + classIdx] - maxLogit) / sumExp;
+    maxLogit = maxima[0];
+    const float inverseSum = 1.0f / sums[0];
+    if (p_writeGradients) {
+        for (uint c = lid; c < p_numClasses; c += localSize) {
+            p_gradients[base + c] = exp(p_logits[base + c] - maxLogit) * inverseSum - p_targets[base + c];
+        }
+    }
+
+    // -sum_c t_c * log(softmax_c) = (max + log(sumExp)) * sum_c t_c - sum_c t_c * z_c
+    if (p_writeLosses && lid == 0) {
+        p_sampleLosses[row] = (maxLogit + log(sums[0])) * targetSums[0] - targetDots[0];
+    }
+}
 
-    p_gradients[base + classIdx] =
-        softmax - p_targets[base + classIdx];
-}
\ No newline at end of file
+// OpenCL 1.2 has no float atomics; the sum is updated through its bit pattern.
+inline void atomicAddFloat(volatile __global float* p_target, const float p_value)
+{
+    union { unsigned int u; float f; } expected, desired;
+    do {
+        expected.f = *p_target;
+        desired.f = expected.f + p_value;
+    } while (atomic_cmpxchg((volatile __global unsigned int*)p_target, expected.u, desired.u) != expected.u);
+}
+
+// Sums one partial per work-item in local memory, so each work-group issues a single atomic add.
+// The local size must be a power of two.
+inline void accumulateGroupSum(__local float* p_partials, const float p_sum, volatile __global float* p_lossSum, const float p_scale)
+{
+    const uint lid = get_local_id(0);
+    p_partials[lid] = p_sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (uint stride = get_local_size(0) / 2; stride > 0; stride >>= 1) {
+        if (lid < stride) {
+            p_partials[lid] += p_partials[lid + stride];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (lid == 0) {
+        atomicAddFloat(p_lossSum, p_partials[0] * p_scale);
+    }
+}
+
+// The accumulation kernels add p_scale times the loss of one batch to p_lossSum. Each work-item sums a
+// grid-strided share of the units; the local size must be a power of two no larger than LOSS_GROUP_SIZE.
+__kernel void meanSquaredErrorAccumulateLoss(
+    __global const float* p_predictions,
+    __global const float* p_targets,
+    volatile __global float* p_lossSum,
+    const unsigned int p_units,
+    const unsigned int p_outputElements,
+    const float p_scale
+) {
+    __local float partials[LOSS_GROUP_SIZE];
+    float sum = 0.0f;
+    for (uint i = get_global_id(0); i < p_units; i += get_global_size(0)) {
+        float diff = p_predictions[i] - p_targets[i];
+        sum += diff * diff;
+    }
+    accumulateGroupSum(partials, sum, p_lossSum, p_scale);
+}
+
+__kernel void binaryCrossEntropyAccumulateLoss(
+    __global const float* p_predictions,
+    __global const float* p_targets,
+    volatile __global float* p_lossSum,
+    const unsigned int p_units,
+    const unsigned int p_outputElements,
+    const float p_scale
+) {
+    __local float partials[LOSS_GROUP_SIZE];
+    float sum = 0.0f;
+    for (uint i = get_global_id(0); i < p_units; i += get_global_size(0)) {
+        float pred = fmax(fmin(p_predictions[i], 1.0f - 1e-7f), 1e-7f);
+        float target = p_targets[i];
+        sum -= target * log(pred) + (1.0f - target) * log(1.0f - pred);
+    }
+    accumulateGroupSum(partials, sum, p_lossSum, p_scale);
+}
+
+// One unit per sample: the loss of the first class with a positive target.
+__kernel void categoricalCrossEntropyAccumulateLoss(
+    __global const float* p_predictions,
+    __global const float* p_targets,
+    volatile __global float* p_lossSum,
+    const unsigned int p_units,
+    const unsigned int p_outputElements,
+    const float p_scale
+) {
+    __local float partials[LOSS_GROUP_SIZE];
+    float sum = 0.0f;
+    for (uint b = get_global_id(0); b < p_units; b += get_global_size(0)) {
+        const uint base = b * p_outputElements;
+        for (uint c = 0; c < p_outputElements; ++c) {
+            if (p_targets[base + c] > 0.0f) {
+                sum -= log(fmax(fmin(p_predictions[base + c], 1.0f), 1e-7f));
+                break;
+            }
+        }
+    }
+    accumulateGroupSum(partials, sum, p_lossSum, p_scale);
+}
+
+// Reduces the per-sample losses written by softmaxCrossEntropyComputeGradients.
+__kernel void accumulateSampleLosses(
+    __global const float* p_sampleLosses,
+    volatile __global float* p_lossSum,
+    const unsigned int p_units,
+    const float p_scale
+) {
+    __local float partials[LOSS_GROUP_SIZE];
+    float sum = 0.0f;
+    for (uint i = get_global_id(0); i < p_units; i += get_global_size(0)) {
+        sum += p_sampleLosses[i];
+    }
+    accumulateGroupSum(partials, sum, p_lossSum, p_scale);
+}
@@ -155,13 +155,9 @@ namespace DataLoaders
             }
         }
 
-        cl::Buffer inputBuffer = Utils::createCLBuffer(
-            m_sharedResources->getContext(),
-            inputs);
-
-        cl::Buffer targetBuffer = Utils::createCLBuffer(
-            m_sharedResources->getContext(),
-            targets);
+        std::vector<cl::Event> uploadEvents;
+        cl::Buffer inputBuffer = uploadBatchData(inputs, uploadEvents);
+        cl::Buffer targetBuffer = uploadBatchData(targets, uploadEvents);
 
         return Utils::Batch(
             std::move(inputBuffer),
@@ -170,7 +166,9 @@ namespace DataLoaders
             std::move(targets),
             end - p_batchStart,
             getInputDimensions(m_channels, m_height, m_width, m_inputOrder),
-            Utils::Dimensions({m_hasLabel ? m_numClasses : 0}));
+            Utils::Dimensions({m_hasLabel ? m_numClasses : 0}),
+            m_sharedResources->getBufferPool(),
+            std::move(uploadEvents));
     }
 
     void BinImageDataLoader::splitData(float p_train, float p_val, size_t p_seed)
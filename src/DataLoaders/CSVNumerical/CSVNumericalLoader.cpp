@@ -52,10 +52,12 @@ namespace DataLoaders
             }
         }
 
-        cl::Buffer inputsBuffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(float) * inputs.size(), inputs.data());
-        cl::Buffer targetsBuffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(float) * targets.size(), targets.data());
+        std::vector<cl::Event> uploadEvents;
+        cl::Buffer inputsBuffer = uploadBatchData(inputs, uploadEvents);
+        cl::Buffer targetsBuffer = uploadBatchData(targets, uploadEvents);
 
-        return Utils::Batch(inputsBuffer, targetsBuffer, inputs, targets, batchActualSize, Utils::Dimensions({m_numInputFeatures}), Utils::Dimensions({m_numTargetFeatures}));
+        return Utils::Batch(inputsBuffer, targetsBuffer, inputs, targets, batchActualSize, Utils::Dimensions({m_numInputFeatures}), Utils::Dimensions({m_numTargetFeatures}),
+                            m_sharedResources->getBufferPool(), std::move(uploadEvents));
     }
 
     void CSVNumericalLoader::loadData(const std::string &p_source)
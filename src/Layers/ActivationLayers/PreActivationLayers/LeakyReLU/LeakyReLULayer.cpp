@@ -3,20 +3,30 @@ namespace Layers::Activation
 {
     void LeakyReLULayer::setupKernels()
     {
+        if (!usesSignMask())
+        {
+            createVectorKernels("leakyReLU", "LeakyReLU");
+            Utils::setKernelArgs(2, m_forwardKernel, getAlpha());
+            Utils::setKernelArgs(3, m_backwardKernel, getAlpha());
+            bindBufferArgs();
+            return;
+        }
+
         cl_int err;
 
-        m_forwardKernel = cl::Kernel(m_sharedResources->getProgram(), "leakyReLUForward", &err);
+        m_forwardKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Activation), "leakyReLUForwardMasked", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create ReLU forward kernel");
         }
-        Utils::setKernelArgs(1, m_forwardKernel, getOutputs(), getPreActivations(), getAlpha());
+        Utils::setKernelArgs(3, m_forwardKernel, getAlpha());
 
-        m_backwardKernel = cl::Kernel(m_sharedResources->getProgram(), "leakyReLUBackward", &err);
+        m_backwardKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Activation), "leakyReLUBackwardMasked", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create ReLU backward kernel");
         }
-        Utils::setKernelArgs(1, m_backwardKernel, getDeltas(), getPreActivations(), getAlpha());
+        Utils::setKernelArgs(3, m_backwardKernel, getAlpha());
+        bindBufferArgs();
     }
 }
\ No newline at end of file
@@ -1,22 +1,64 @@
 #include "Layers/ActivationLayers/Softmax/SoftmaxLayer.hpp"
+#include <algorithm>
 namespace Layers::Activation
 {
     void SoftmaxLayer::setupKernels()
     {
         cl_int err;
+        const cl::Program &program = m_sharedResources->getProgram(Utils::KernelFamily::Activation);
 
-        m_forwardKernel = cl::Kernel(m_sharedResources->getProgram(), "softmaxForward", &err);
+        cl::Kernel forwardRowsKernel(program, "softmaxForwardRows", &err);
         if (err != CL_SUCCESS)
         {
-            throw std::runtime_error("Failed to create Softmax forward kernel");
+            throw std::runtime_error("Failed to create Softmax work-group forward kernel");
         }
-        Utils::setKernelArgs(1, m_forwardKernel, getOutputs(), (cl_uint)getTotalOutputElements());
-
-        m_backwardKernel = cl::Kernel(m_sharedResources->getProgram(), "softmaxBackward", &err);
+        cl::Kernel backwardRowsKernel(program, "softmaxBackwardRows", &err);
         if (err != CL_SUCCESS)
         {
-            throw std::runtime_error("Failed to create Softmax backward kernel");
+            throw std::runtime_error("Failed to create Softmax work-group backward kernel");
+        }
+        m_rowLocalSize = getTotalOutputElements() >= WORK_GROUP_CLASS_THRESHOLD ? selectRowLocalSize(forwardRowsKernel, backwardRowsKernel) : 0;
+
+        if (usesWorkGroupKernels())
+        {
+            m_forwardKernel = forwardRowsKernel;
+            m_backwardKernel = backwardRowsKernel;
+        }
+        else
+        {
+            m_forwardKernel = cl::Kernel(program, "softmaxForward", &err);
+            if (err != CL_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create Softmax forward kernel");
+            }
+            m_backwardKernel = cl::Kernel(program, "softmaxBackward", &err);
+            if (err != CL_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create Softmax backward kernel");
+            }
+        }
+        Utils::setKernelArgs(2, m_forwardKernel, (cl_uint)getTotalOutputElements());
+        Utils::setKernelArgs(3, m_backwardKernel, (cl_uint)getTotalOutputElements());
+        bindBufferArgs();
+    }
+
+    // Each work-item covers float4 chunks, so the smallest power of two reaching one chunk per work-item,
+    // capped by the kernels' local arrays and every device's limit for both kernels.
+    size_t SoftmaxLayer::selectRowLocalSize(const cl::Kernel &p_forwardKernel, const cl::Kernel &p_backwardKernel) const
+    {
+        size_t limit = ROW_GROUP_SIZE;
+        for (const cl::Device &device : m_sharedResources->getDevices())
+        {
+            limit = std::min({limit,
+                              p_forwardKernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device),
+                              p_backwardKernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(device)});
+        }
+        size_t chunks = (getTotalOutputElements() + 3) / 4;
+        size_t localSize = 1;
+        while (localSize < chunks && localSize * 2 <= limit)
+        {
+            localSize *= 2;
         }
-        Utils::setKernelArgs(1, m_backwardKernel, getDeltas(), getOutputs(), (cl_uint)getTotalOutputElements());
+        return localSize;
     }
-}
\ No newline at end of file
+}
@@ -1,4 +1,5 @@
 #include "Layers/TrainableLayers/Convolutional/ConvolutionalLayer.hpp"
+#include <limits>
 namespace Layers::Trainable
 {
     ConvolutionalLayer::ConvolutionalLayer(const size_t p_layerId,
@@ -8,12 +9,15 @@ namespace Layers::Trainable
                                            const Utils::StrideDimensions &p_strideDimensions,
                                            const Utils::PaddingType p_paddingType,
                                            const size_t p_batchSize,
-                                           std::mt19937 &p_rng)
-        : TrainableLayer(p_layerId, p_sharedResources, validateInputDimensions(p_inputDimensions, p_filterDimensions, p_strideDimensions), calculateOutputDimensions(validateInputDimensions(p_inputDimensions, p_filterDimensions, p_strideDimensions), p_filterDimensions, p_strideDimensions, p_paddingType), p_batchSize),
+                                           std::mt19937 &p_rng,
+                                           const bool p_specializeKernels,
+                                           const Utils::ExecutionMode p_mode)
+        : TrainableLayer(p_layerId, p_sharedResources, validateInputDimensions(p_inputDimensions, p_filterDimensions, p_strideDimensions), calculateOutputDimensions(validateInputDimensions(p_inputDimensions, p_filterDimensions, p_strideDimensions), p_filterDimensions, p_strideDimensions, p_paddingType), p_batchSize, p_mode),
           m_filterDimensions(p_filterDimensions),
           m_strideDimensions(p_strideDimensions),
           m_paddingValues(calculatePaddingValues(m_inputDimensions, p_filterDimensions, p_strideDimensions, p_paddingType)),
-          m_paddingType(p_paddingType)
+          m_paddingType(p_paddingType),
+          m_specializeKernels(p_specializeKernels)
     {
 
         initializeWeightsAndBiases(p_rng);
@@ -23,15 +27,20 @@ namespace Layers::Trainable
 
     ConvolutionalLayer::ConvolutionalLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                                            const H5::Group &p_layerGroup,
-                                           const size_t p_batchSize)
-        : TrainableLayer(p_sharedResources, p_layerGroup, p_batchSize)
+                                           const size_t p_batchSize,
+                                           const Utils::ExecutionMode p_mode)
+        : TrainableLayer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
     {
         m_filterDimensions = Utils::FilterDimensions(Utils::readVectorFromHDF5<size_t>(p_layerGroup, "filterDimensions"));
         m_strideDimensions = Utils::StrideDimensions(Utils::readVectorFromHDF5<size_t>(p_layerGroup, "strideDimensions"));
         m_paddingValues = Utils::PaddingValues(Utils::readVectorFromHDF5<size_t>(p_layerGroup, "paddingValues"));
         m_paddingType = Utils::paddingTypeFromUint(Utils::readValueFromHDF5<unsigned int>(p_layerGroup, "paddingType"));
-        m_weights = Utils::loadBuffer(p_sharedResources->getContext(), p_layerGroup, "weights", getWeightsSize());
-        m_biases = Utils::loadBuffer(p_sharedResources->getContext(), p_layerGroup, "biases", getBiasesSize());
+        if (p_layerGroup.attrExists("specializeKernels"))
+        {
+            m_specializeKernels = Utils::readValueFromHDF5<bool>(p_layerGroup, "specializeKernels");
+        }
+        m_weights = Utils::loadBuffer(p_sharedResources->getBufferPool(), p_layerGroup, "weights", getWeightsSize());
+        m_biases = Utils::loadBuffer(p_sharedResources->getBufferPool(), p_layerGroup, "biases", getBiasesSize());
         allocateConvolutionalLayerBuffers();
         setupKernels();
     }
@@ -40,37 +49,46 @@ namespace Layers::Trainable
                                              const cl::Buffer &p_inputs,
                                              const size_t p_batchSize)
     {
-        cl_command_queue raw_queue = p_forwardBackpropQueue.get();
-
-        auto status = clblast::Convgemm<float>(
-            clblast::KernelMode::kCrossCorrelation,
-            getInputChannels(), getInputHeight(), getInputWidth(),
-            m_filterDimensions.getHeight(), m_filterDimensions.getWidth(),
-            m_paddingValues.getTop(), m_paddingValues.getLeft(),
-            m_strideDimensions.getHeight(), m_strideDimensions.getWidth(),
-            1, 1,
-            getOutputChannels(),
-            p_batchSize,
-            p_inputs(), 0,
-            getWeights()(), 0,
-            getOutputs()(), 0,
-            &raw_queue, nullptr);
-
-        if (status != clblast::StatusCode::kSuccess)
+        const size_t channels = getInputChannels();
+        const size_t height = getInputHeight();
+        const size_t width = getInputWidth();
+        const size_t outputChannels = getOutputChannels();
+        const Utils::FilterDimensions filter = m_filterDimensions;
+        const Utils::StrideDimensions stride = m_strideDimensions;
+        const size_t paddingTop = m_paddingValues.getTop();
+        const size_t paddingLeft = m_paddingValues.getLeft();
+        cl::Buffer inputs = p_inputs;
+        cl::Buffer weights = getWeights();
+        cl::Buffer outputs = getOutputs();
+        auto forwardConvgemm = [=](cl_command_queue p_queue)
         {
-            throw std::runtime_error("CLBlast Convgemm failed with status: " + std::to_string(static_cast<int>(status)));
-        }
+            cl_event raw_event = nullptr;
+            auto status = clblast::Convgemm<float>(
+                clblast::KernelMode::kCrossCorrelation,
+                channels, height, width,
+                filter.getHeight(), filter.getWidth(),
+                paddingTop, paddingLeft,
+                stride.getHeight(), stride.getWidth(),
+                1, 1,
+                outputChannels,
+                p_batchSize,
+                inputs(), 0,
+                weights(), 0,
+                outputs(), 0,
+                &p_queue, &raw_event);
+
+            if (status != clblast::StatusCode::kSuccess)
+            {
+                throw std::runtime_error("CLBlast Convgemm failed with status: " + std::to_string(static_cast<int>(status)));
+            }
+            return raw_event;
+        };
+        m_sharedResources->enqueueRoutine(p_forwardBackpropQueue, forwardConvgemm);
 
         cl::Event returnEvent;
         cl::NDRange globalSize(getOutputChannels(), getOutputHeight() * getOutputWidth(), p_batchSize);
 
-        cl_int err = p_forwardBackpropQueue.enqueueNDRangeKernel(
-            m_biasKernel,
-            cl::NullRange,
-            globalSize,
-            cl::NullRange,
-            nullptr,
-            &returnEvent);
+        cl_int err = m_sharedResources->enqueueKernel(p_forwardBackpropQueue, getBiasKernel(), globalSize, nullptr, &returnEvent);
 
         if (err != CL_SUCCESS)
         {
@@ -94,13 +112,7 @@ namespace Layers::Trainable
         Utils::setKernelArgs(14, m_backpropDeltasKernel, p_previousLayerDeltas);
 
         cl::Event executionEvent;
-        p_forwardBackpropQueue.enqueueNDRangeKernel(
-            m_backpropDeltasKernel,
-            cl::NullRange,
-            globalSize,
-            cl::NullRange,
-            nullptr,
-            &executionEvent);
+        m_sharedResources->enqueueKernel(p_forwardBackpropQueue, m_backpropDeltasKernel, globalSize, nullptr, &executionEvent);
 
         return executionEvent;
     }
@@ -111,55 +123,190 @@ namespace Layers::Trainable
         const cl::Buffer &p_inputs,
         const size_t p_batchSize)
     {
-        if (m_batchSize < p_batchSize)
-            setBatchSize(p_batchSize);
+        ensureBatchCapacity(p_batchSize);
+        if (!m_blasScratch)
+        {
+            allocateGradientScratch(m_batchSize);
+        }
 
-        std::vector<cl::Event> waitList;
-        if (p_backpropEvent() != nullptr)
+        std::vector<cl::Event> waitList = m_blasScratch->getDeltaToGradientWaitList(p_backpropEvent);
+        if (!waitList.empty())
         {
-            waitList.push_back(p_backpropEvent);
+            m_sharedResources->enqueueBarrier(p_queue, &waitList);
         }
 
-        cl::NDRange globalSize(
-            (size_t)m_filterDimensions.getWidth(),
-            (size_t)m_filterDimensions.getHeight(),
-            (size_t)getInputChannels() * getOutputChannels());
+        const size_t patchSize = getPatchSize();
+        const size_t outputChannels = getOutputChannels();
+        const size_t spatialSize = getOutputHeight() * getOutputWidth();
+        const size_t chunkSize = getGradientChunkSize(p_batchSize);
+        ensureGradientChunkKernels((p_batchSize + chunkSize - 1) / chunkSize);
 
-        Utils::setKernelArgs(14, m_computeWeightsGradientsKernel, p_inputs, (int)p_batchSize);
+        float alpha = 1.0f / static_cast<float>(p_batchSize);
+        cl::Buffer columns = m_blasScratch->getColumns();
+        cl::Buffer workspace = m_blasScratch->getDeltaToGradientWorkspace();
+        cl::Buffer weightsGradients = getWeightsGradients();
+        size_t layerId = m_layerId;
 
         cl::Event weightsEvent;
-        p_queue.enqueueNDRangeKernel(
-            m_computeWeightsGradientsKernel,
-            cl::NullRange,
-            globalSize,
-            cl::NullRange,
-            &waitList,
-            &weightsEvent);
+        for (size_t chunk = 0, firstSample = 0; firstSample < p_batchSize; ++chunk, firstSample += chunkSize)
+        {
+            const size_t samples = std::min(chunkSize, p_batchSize - firstSample);
+            const size_t columnCount = samples * spatialSize;
+            const size_t deltasOffset = patchSize * columnCount;
+
+            // The previous chunk's GEMM still reads the columns this chunk overwrites.
+            std::vector<cl::Event> chunkWaitList;
+            if (weightsEvent() != nullptr)
+            {
+                chunkWaitList.push_back(weightsEvent);
+            }
+
+            cl::Kernel &im2colKernel = m_im2colKernels[chunk];
+            cl::Kernel &gatherDeltasKernel = m_gatherDeltasKernels[chunk];
+            Utils::setKernelArgs(im2colKernel, p_inputs, columns);
+            Utils::setKernelArgs(13, im2colKernel, (cl_int)firstSample, (cl_int)samples);
+            Utils::setKernelArgs(gatherDeltasKernel, getDeltas(), columns);
+            Utils::setKernelArgs(5, gatherDeltasKernel, (cl_int)deltasOffset, (cl_int)firstSample, (cl_int)samples);
+
+            std::vector<cl::Event> gemmWaitList(2);
+            m_sharedResources->enqueueKernel(p_queue, im2colKernel, cl::NDRange(columnCount, patchSize), &chunkWaitList, &gemmWaitList[0]);
+            m_sharedResources->enqueueKernel(p_queue, gatherDeltasKernel, cl::NDRange(columnCount, outputChannels), &chunkWaitList, &gemmWaitList[1]);
+            m_sharedResources->enqueueBarrier(p_queue, &gemmWaitList);
+
+            const float beta = firstSample == 0 ? 0.0f : 1.0f;
+            auto weightsGradientGemm = [=](cl_command_queue p_rawQueue)
+            {
+                cl_event raw_gemm_event = nullptr;
+                auto status = clblast::Gemm<float>(
+                    clblast::Layout::kRowMajor,
+                    clblast::Transpose::kNo,
+                    clblast::Transpose::kYes,
+                    outputChannels, patchSize, columnCount,
+                    alpha,
+                    columns(), deltasOffset, columnCount,
+                    columns(), 0, columnCount,
+                    beta,
+                    weightsGradients(), 0, patchSize,
+                    &p_rawQueue,
+                    &raw_gemm_event,
+                    workspace());
+
+                if (status != clblast::StatusCode::kSuccess)
+                {
+                    std::cerr << "Weight Gradients CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << layerId << std::endl;
+                    throw std::runtime_error("CLBlast GEMM failed");
+                }
+                return raw_gemm_event;
+            };
+            weightsEvent = m_sharedResources->enqueueRoutine(p_queue, weightsGradientGemm);
+        }
+        m_blasScratch->setDeltaToGradientLastUse(weightsEvent);
 
         cl::NDRange biasGlobalSize(getOutputChannels());
         cl::Event biasEvent;
         Utils::setKernelArgs(5, m_computeBiasesGradientsKernel, (cl_int)p_batchSize);
-        p_queue.enqueueNDRangeKernel(
-            m_computeBiasesGradientsKernel,
-            cl::NullRange,
-            biasGlobalSize,
-            cl::NullRange,
-            &waitList,
-            &biasEvent);
+        m_sharedResources->enqueueKernel(p_queue, m_computeBiasesGradientsKernel, biasGlobalSize, nullptr, &biasEvent);
         return {weightsEvent, biasEvent};
     }
 
+    void ConvolutionalLayer::reserveBlasScratch(const cl::CommandQueue &p_queue,
+                                                Utils::BlasScratch &p_scratch,
+                                                const size_t p_batchSize,
+                                                const Utils::ExecutionMode p_mode) const
+    {
+        if (p_mode != Utils::ExecutionMode::Training)
+        {
+            return;
+        }
+        size_t columns = getGradientChunkSize(p_batchSize) * getOutputHeight() * getOutputWidth();
+        p_scratch.requireDeltaToGradient(Utils::BlasScratch::getGemmBytes(p_queue, clblast::Transpose::kNo, clblast::Transpose::kYes, getOutputChannels(), getPatchSize(), columns));
+        p_scratch.requireColumns((getPatchSize() + getOutputChannels()) * columns * sizeof(float));
+    }
+
+    void ConvolutionalLayer::allocateGradientScratch(const size_t p_batchSize)
+    {
+        if (isInferenceOnly() || m_sharedBlasScratch)
+        {
+            return;
+        }
+        if (!m_blasScratch)
+        {
+            m_blasScratch = std::make_shared<Utils::BlasScratch>(m_sharedResources->getBufferPool());
+        }
+        size_t columns = getGradientChunkSize(p_batchSize) * getOutputHeight() * getOutputWidth();
+        m_blasScratch->clearRequirements();
+        m_blasScratch->requireColumns((getPatchSize() + getOutputChannels()) * columns * sizeof(float));
+        m_blasScratch->allocate();
+    }
+
+    void ConvolutionalLayer::setGradientColumnsBudget(const size_t p_bytes)
+    {
+        m_gradientColumnsBudget = std::min(p_bytes, getMaxAllocationSize());
+        if (m_blasScratch && !m_sharedBlasScratch)
+        {
+            allocateGradientScratch(m_batchSize);
+        }
+    }
+
+    size_t ConvolutionalLayer::getMaxAllocationSize() const
+    {
+        size_t maxAllocation = std::numeric_limits<size_t>::max();
+        for (const cl::Device &device : m_sharedResources->getDevices())
+        {
+            maxAllocation = std::min(maxAllocation, static_cast<size_t>(device.getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>()));
+        }
+        return maxAllocation;
+    }
+
+    void ConvolutionalLayer::ensureGradientChunkKernels(const size_t p_chunks)
+    {
+        cl_int err;
+        while (m_im2colKernels.size() < p_chunks)
+        {
+            cl::Kernel im2colKernel(m_shapeProgram, "convolutionalIm2col", &err);
+            if (err != CL_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create im2col kernel.");
+            }
+            Utils::setKernelArgs(2, im2colKernel,
+                                 (cl_int)getInputChannels(),
+                                 (cl_int)getInputHeight(),
+                                 (cl_int)getInputWidth(),
+                                 (cl_int)getOutputHeight(),
+                                 (cl_int)getOutputWidth(),
+                                 (cl_int)m_filterDimensions.getHeight(),
+                                 (cl_int)m_filterDimensions.getWidth(),
+                                 (cl_int)m_strideDimensions.getHeight(),
+                                 (cl_int)m_strideDimensions.getWidth(),
+                                 (cl_int)m_paddingValues.getTop(),
+                                 (cl_int)m_paddingValues.getLeft());
+
+            cl::Kernel gatherDeltasKernel(m_shapeProgram, "convolutionalGatherDeltas", &err);
+            if (err != CL_SUCCESS)
+            {
+                throw std::runtime_error("Failed to create gather deltas kernel.");
+            }
+            Utils::setKernelArgs(2, gatherDeltasKernel,
+                                 (cl_int)getOutputChannels(),
+                                 (cl_int)getOutputHeight(),
+                                 (cl_int)getOutputWidth());
+
+            m_im2colKernels.push_back(im2colKernel);
+            m_gatherDeltasKernels.push_back(gatherDeltasKernel);
+        }
+    }
+
+    // The im2col scratch is left to the first computeGradients(), so layers that a network hands its shared
+    // scratch never allocate one of their own.
     void ConvolutionalLayer::allocateConvolutionalLayerBuffers()
     {
-        m_weightsGradients = cl::Buffer(
-            m_sharedResources->getContext(),
-            CL_MEM_READ_WRITE,
-            (getWeightsSize()) * sizeof(float));
-
-        m_biasesGradients = cl::Buffer(
-            m_sharedResources->getContext(),
-            CL_MEM_READ_WRITE,
-            (getBiasesSize()) * sizeof(float));
+        m_gradientColumnsBudget = getMaxAllocationSize() / 4;
+        if (isInferenceOnly())
+        {
+            return;
+        }
+        m_weightsGradients = m_sharedResources->getBufferPool()->acquire(getWeightsSize() * sizeof(float));
+        m_biasesGradients = m_sharedResources->getBufferPool()->acquire(getBiasesSize() * sizeof(float));
     }
 
     Utils::Dimensions ConvolutionalLayer::calculateOutputDimensions(const Utils::Dimensions &p_inputDimensions, const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions, Utils::PaddingType p_paddingType) const
@@ -300,17 +447,24 @@ namespace Layers::Trainable
             bias = 0.0f;
         }
 
-        m_weights = cl::Buffer(
-            m_sharedResources->getContext(),
-            CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
-            h_weights.size() * sizeof(float),
-            h_weights.data());
+        m_weights = m_sharedResources->getBufferPool()->acquire(h_weights.size() * sizeof(float), h_weights.data());
+        m_biases = m_sharedResources->getBufferPool()->acquire(h_biases.size() * sizeof(float), h_biases.data());
+    }
 
-        m_biases = cl::Buffer(
-            m_sharedResources->getContext(),
-            CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
-            h_biases.size() * sizeof(float),
-            h_biases.data());
+    std::string ConvolutionalLayer::getSpecializationDefines() const
+    {
+        return "-DCONV_IC=" + std::to_string(getInputChannels()) +
+               " -DCONV_IH=" + std::to_string(getInputHeight()) +
+               " -DCONV_IW=" + std::to_string(getInputWidth()) +
+               " -DCONV_OC=" + std::to_string(getOutputChannels()) +
+               " -DCONV_OH=" + std::to_string(getOutputHeight()) +
+               " -DCONV_OW=" + std::to_string(getOutputWidth()) +
+               " -DCONV_FH=" + std::to_string(m_filterDimensions.getHeight()) +
+               " -DCONV_FW=" + std::to_string(m_filterDimensions.getWidth()) +
+               " -DCONV_STRIDE_H=" + std::to_string(m_strideDimensions.getHeight()) +
+               " -DCONV_STRIDE_W=" + std::to_string(m_strideDimensions.getWidth()) +
+               " -DCONV_PAD_H=" + std::to_string(m_paddingValues.getTop()) +
+               " -DCONV_PAD_W=" + std::to_string(m_paddingValues.getLeft());
     }
 
     void ConvolutionalLayer::setupKernels()
@@ -318,7 +472,11 @@ namespace Layers::Trainable
         setupTrainableKernels();
         cl_int err;
 
-        m_biasKernel = cl::Kernel(m_sharedResources->getProgram(), "convolutionalBias", &err);
+        m_shapeProgram = m_specializeKernels
+                             ? m_sharedResources->getSpecializedProgram("Layers/Trainable/ConvolutionalLayerKernels.cl", getSpecializationDefines())
+                             : m_sharedResources->getProgram(Utils::KernelFamily::Convolutional);
+
+        m_biasKernel = cl::Kernel(m_shapeProgram, "convolutionalBias", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create convBias kernel");
@@ -329,41 +487,32 @@ namespace Layers::Trainable
                              (cl_int)getOutputHeight(),
                              (cl_int)getOutputWidth(),
                              (cl_int)getOutputChannels());
-        m_backpropDeltasKernel = cl::Kernel(m_sharedResources->getProgram(), "convolutionalBackpropDeltas", &err);
 
+        m_fusedBiasKernel = cl::Kernel(m_shapeProgram, "convolutionalBiasActivation", &err);
         if (err != CL_SUCCESS)
         {
-            throw std::runtime_error("Failed to create backprop kernel.");
+            throw std::runtime_error("Failed to create convBiasActivation kernel");
         }
-        Utils::setKernelArgs(m_backpropDeltasKernel,
-                             getWeights(),
-                             getDeltas(),
-                             (cl_int)getInputHeight(),
-                             (cl_int)getInputWidth(),
+        Utils::setKernelArgs(m_fusedBiasKernel,
+                             getBiases(),
+                             getOutputs(),
+                             getOutputs(),
+                             (cl_uint)getType(),
+                             0.0f,
                              (cl_int)getOutputHeight(),
                              (cl_int)getOutputWidth(),
-                             (cl_int)m_filterDimensions.getHeight(),
-                             (cl_int)m_filterDimensions.getWidth(),
-                             (cl_int)m_strideDimensions.getHeight(),
-                             (cl_int)m_strideDimensions.getWidth(),
-                             (cl_int)m_paddingValues.getTop(),
-                             (cl_int)m_paddingValues.getLeft(),
-                             (cl_int)getInputChannels(),
                              (cl_int)getOutputChannels());
+        m_backpropDeltasKernel = cl::Kernel(m_shapeProgram, "convolutionalBackpropDeltas", &err);
 
-        m_computeWeightsGradientsKernel = cl::Kernel(m_sharedResources->getProgram(), "convolutionalComputeWeightsGradients", &err);
         if (err != CL_SUCCESS)
         {
-            throw std::runtime_error("Failed to create compute weights gradients kernel.");
+            throw std::runtime_error("Failed to create backprop kernel.");
         }
-
-        Utils::setKernelArgs(m_computeWeightsGradientsKernel,
+        Utils::setKernelArgs(m_backpropDeltasKernel,
+                             getWeights(),
                              getDeltas(),
-                             getWeightsGradients(),
-                             (cl_int)getInputChannels(),
                              (cl_int)getInputHeight(),
                              (cl_int)getInputWidth(),
-                             (cl_int)getOutputChannels(),
                              (cl_int)getOutputHeight(),
                              (cl_int)getOutputWidth(),
                              (cl_int)m_filterDimensions.getHeight(),
@@ -371,9 +520,11 @@ namespace Layers::Trainable
                              (cl_int)m_strideDimensions.getHeight(),
                              (cl_int)m_strideDimensions.getWidth(),
                              (cl_int)m_paddingValues.getTop(),
-                             (cl_int)m_paddingValues.getLeft());
+                             (cl_int)m_paddingValues.getLeft(),
+                             (cl_int)getInputChannels(),
+                             (cl_int)getOutputChannels());
 
-        m_computeBiasesGradientsKernel = cl::Kernel(m_sharedResources->getProgram(), "convolutionalComputeBiasesGradients", &err);
+        m_computeBiasesGradientsKernel = cl::Kernel(m_shapeProgram, "convolutionalComputeBiasesGradients", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create compute biases gradients kernel.");
@@ -388,6 +539,30 @@ namespace Layers::Trainable
             (cl_int)getOutputWidth());
     }
 
+    void ConvolutionalLayer::bindBufferArgs()
+    {
+        Utils::setKernelArgs(1, m_biasKernel, getOutputs());
+        Utils::setKernelArgs(1, m_fusedBiasKernel, getOutputs());
+        if (isInferenceOnly())
+        {
+            return;
+        }
+        Utils::setKernelArgs(1, m_backpropDeltasKernel, getDeltas());
+        Utils::setKernelArgs(m_computeBiasesGradientsKernel, getDeltas());
+    }
+
+    void ConvolutionalLayer::bindParameterArgs()
+    {
+        Utils::setKernelArgs(m_biasKernel, getBiases());
+        Utils::setKernelArgs(m_fusedBiasKernel, getBiases());
+        if (isInferenceOnly())
+        {
+            return;
+        }
+        Utils::setKernelArgs(m_backpropDeltasKernel, getWeights());
+        Utils::setKernelArgs(1, m_computeBiasesGradientsKernel, getBiasesGradients());
+    }
+
     Utils::Dimensions ConvolutionalLayer::validateInputDimensions(
         const Utils::Dimensions &p_inputDimensions,
         const Utils::FilterDimensions &p_filterDimensions,
@@ -6,8 +6,9 @@ namespace Layers::Trainable
                            const Utils::Dimensions &p_inputDimensions,
                            const Utils::Dimensions &p_outputDimensions,
                            const size_t p_batchSize,
-                           std::mt19937 &p_rng)
-        : TrainableLayer(p_layerId, p_sharedResources, p_inputDimensions, Utils::Dimensions::validateDenseDimensions(p_outputDimensions), p_batchSize)
+                           std::mt19937 &p_rng,
+                           const Utils::ExecutionMode p_mode)
+        : TrainableLayer(p_layerId, p_sharedResources, p_inputDimensions, Utils::Dimensions::validateDenseDimensions(p_outputDimensions), p_batchSize, p_mode)
     {
         initializeWeightsAndBiases(p_rng);
         allocateDenseLayerBuffers(p_batchSize);
@@ -16,11 +17,12 @@ namespace Layers::Trainable
 
     DenseLayer::DenseLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                            const H5::Group &p_layerGroup,
-                           const size_t p_batchSize)
-        : TrainableLayer(p_sharedResources, p_layerGroup, p_batchSize)
+                           const size_t p_batchSize,
+                           const Utils::ExecutionMode p_mode)
+        : TrainableLayer(p_sharedResources, p_layerGroup, p_batchSize, p_mode)
     {
-        m_weights = Utils::loadBuffer(p_sharedResources->getContext(), p_layerGroup, "weights", getWeightsSize());
-        m_biases = Utils::loadBuffer(p_sharedResources->getContext(), p_layerGroup, "biases", getBiasesSize());
+        m_weights = Utils::loadBuffer(p_sharedResources->getBufferPool(), p_layerGroup, "weights", getWeightsSize());
+        m_biases = Utils::loadBuffer(p_sharedResources->getBufferPool(), p_layerGroup, "biases", getBiasesSize());
         allocateDenseLayerBuffers(p_batchSize);
         setupKernels();
     }
@@ -29,36 +31,42 @@ namespace Layers::Trainable
                                      const cl::Buffer &p_inputs,
                                      const size_t p_batchSize)
     {
-        if (m_batchSize < p_batchSize)
-            setBatchSize(p_batchSize);
+        ensureBatchCapacity(p_batchSize);
 
         size_t flatInputSize = m_inputDimensions.getTotalElements();
         size_t flatOutputSize = m_outputDimensions.getTotalElements();
 
-        cl_command_queue raw_queue = p_forwardBackpropQueue.get();
-
-        auto status = clblast::Gemm<float>(
-            clblast::Layout::kRowMajor,
-            clblast::Transpose::kNo, clblast::Transpose::kYes,
-            p_batchSize, flatOutputSize, flatInputSize,
-            NO_SCALAR,
-            p_inputs(), NO_OFFSET, flatInputSize,
-            getWeights()(), NO_OFFSET, flatInputSize,
-            CLEAR_C,
-            getOutputs()(), NO_OFFSET, flatOutputSize,
-            &raw_queue, nullptr,
-            m_clblastWorkspace());
-        if (status != clblast::StatusCode::kSuccess)
+        cl::Buffer inputs = p_inputs;
+        cl::Buffer weights = getWeights();
+        cl::Buffer outputs = getOutputs();
+        cl_mem workspace = getForwardBackpropWorkspace();
+        size_t layerId = m_layerId;
+        auto forwardGemm = [=](cl_command_queue p_queue)
         {
-            std::cerr << "Forward CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << m_layerId << std::endl;
-            throw std::runtime_error("CLBlast GEMM failed");
-        }
+            cl_event raw_event = nullptr;
+            auto status = clblast::Gemm<float>(
+                clblast::Layout::kRowMajor,
+                clblast::Transpose::kNo, clblast::Transpose::kYes,
+                p_batchSize, flatOutputSize, flatInputSize,
+                NO_SCALAR,
+                inputs(), NO_OFFSET, flatInputSize,
+                weights(), NO_OFFSET, flatInputSize,
+                CLEAR_C,
+                outputs(), NO_OFFSET, flatOutputSize,
+                &p_queue, &raw_event,
+                workspace);
+            if (status != clblast::StatusCode::kSuccess)
+            {
+                std::cerr << "Forward CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << layerId << std::endl;
+                throw std::runtime_error("CLBlast GEMM failed");
+            }
+            return raw_event;
+        };
+        m_sharedResources->enqueueRoutine(p_forwardBackpropQueue, forwardGemm);
 
         cl::Event returnEvent;
 
-        cl_int err = p_forwardBackpropQueue.enqueueNDRangeKernel(m_biasKernel, cl::NullRange,
-                                                                 cl::NDRange(flatOutputSize, p_batchSize), cl::NullRange,
-                                                                 nullptr, &returnEvent);
+        cl_int err = m_sharedResources->enqueueKernel(p_forwardBackpropQueue, getBiasKernel(), cl::NDRange(flatOutputSize, p_batchSize), nullptr, &returnEvent);
 
         if (err != CL_SUCCESS)
         {
@@ -73,34 +81,39 @@ namespace Layers::Trainable
         const cl::Buffer &p_previousLayerDeltas,
         const size_t p_batchSize)
     {
-        if (m_batchSize < p_batchSize)
-            setBatchSize(p_batchSize);
+        ensureBatchCapacity(p_batchSize);
 
         size_t previousLayerFlatOutputSize = m_inputDimensions.getTotalElements();
         size_t flatOutputSize = m_outputDimensions.getTotalElements();
 
-        cl_command_queue raw_queue = p_forwardBackpropQueue.get();
-        cl_event raw_event = nullptr;
-
-        auto status = clblast::Gemm<float>(
-            clblast::Layout::kRowMajor,
-            clblast::Transpose::kNo, clblast::Transpose::kNo,
-            p_batchSize, previousLayerFlatOutputSize, flatOutputSize,
-            NO_SCALAR,
-            getDeltas()(), NO_OFFSET, flatOutputSize,
-            getWeights()(), NO_OFFSET, previousLayerFlatOutputSize,
-            CLEAR_C,
-            p_previousLayerDeltas.get(), NO_OFFSET, previousLayerFlatOutputSize,
-            &raw_queue, &raw_event,
-            m_clblastDeltaWorkspace());
-
-        if (status != clblast::StatusCode::kSuccess)
+        cl::Buffer deltas = getDeltas();
+        cl::Buffer weights = getWeights();
+        cl::Buffer previousLayerDeltas = p_previousLayerDeltas;
+        cl_mem workspace = getForwardBackpropWorkspace();
+        size_t layerId = m_layerId;
+        auto backpropGemm = [=](cl_command_queue p_queue)
         {
-            std::cerr << "Backprop CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << m_layerId << std::endl;
-            throw std::runtime_error("CLBlast GEMM failed");
-        }
-
-        return cl::Event(raw_event, true);
+            cl_event raw_event = nullptr;
+            auto status = clblast::Gemm<float>(
+                clblast::Layout::kRowMajor,
+                clblast::Transpose::kNo, clblast::Transpose::kNo,
+                p_batchSize, previousLayerFlatOutputSize, flatOutputSize,
+                NO_SCALAR,
+                deltas(), NO_OFFSET, flatOutputSize,
+                weights(), NO_OFFSET, previousLayerFlatOutputSize,
+                CLEAR_C,
+                previousLayerDeltas(), NO_OFFSET, previousLayerFlatOutputSize,
+                &p_queue, &raw_event,
+                workspace);
+
+            if (status != clblast::StatusCode::kSuccess)
+            {
+                std::cerr << "Backprop CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << layerId << std::endl;
+                throw std::runtime_error("CLBlast GEMM failed");
+            }
+            return raw_event;
+        };
+        return m_sharedResources->enqueueRoutine(p_forwardBackpropQueue, backpropGemm);
     }
 
     std::pair<cl::Event, cl::Event> DenseLayer::computeGradients(const cl::CommandQueue &p_deltaToGradientQueue,
@@ -108,84 +121,124 @@ namespace Layers::Trainable
                                                                  const cl::Buffer &p_inputs,
                                                                  const size_t p_batchSize)
     {
-        if (m_batchSize < p_batchSize)
-            setBatchSize(p_batchSize);
-        if (p_backpropEvent() != nullptr)
+        ensureBatchCapacity(p_batchSize);
+        std::vector<cl::Event> deltaBackPropWaitList = m_blasScratch->getDeltaToGradientWaitList(p_backpropEvent);
+        if (!deltaBackPropWaitList.empty())
         {
-            std::vector<cl::Event> deltaBackPropWaitList = {p_backpropEvent};
-            p_deltaToGradientQueue.enqueueBarrierWithWaitList(&deltaBackPropWaitList);
+            m_sharedResources->enqueueBarrier(p_deltaToGradientQueue, &deltaBackPropWaitList);
         }
 
         size_t flatInputSize = m_inputDimensions.getTotalElements();
         size_t flatOutputSize = m_outputDimensions.getTotalElements();
 
-        cl_event raw_gemm_event = nullptr;
-        cl_command_queue raw_queue = p_deltaToGradientQueue.get();
         float alpha = 1.0f / static_cast<float>(p_batchSize);
-        auto status = clblast::Gemm<float>(
-            clblast::Layout::kRowMajor,
-            clblast::Transpose::kYes,
-            clblast::Transpose::kNo,
-            flatOutputSize, flatInputSize, p_batchSize,
-            alpha,
-            getDeltas()(), NO_OFFSET, flatOutputSize,
-            p_inputs(), NO_OFFSET, flatInputSize,
-            CLEAR_C,
-            getWeightsGradients()(), NO_OFFSET, flatInputSize,
-            &raw_queue,
-            &raw_gemm_event,
-            m_clblastWorkspace());
-
-        if (status != clblast::StatusCode::kSuccess)
+        cl::Buffer deltas = getDeltas();
+        cl::Buffer inputs = p_inputs;
+        cl::Buffer weightsGradients = getWeightsGradients();
+        cl::Buffer biasesGradients = getBiasesGradients();
+        cl::Buffer workspace = m_blasScratch->getDeltaToGradientWorkspace();
+        cl::Buffer ones = m_blasScratch->getOnes();
+        size_t layerId = m_layerId;
+        auto weightsGradientGemm = [=](cl_command_queue p_queue)
         {
-            std::cerr << "Weight Gradients CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << m_layerId << std::endl;
-            throw std::runtime_error("CLBlast GEMM failed");
-        }
-
-        cl::Event gemmEvent(raw_gemm_event, true);
-
-        cl_event raw_gemv_event = nullptr;
-
-        status = clblast::Gemv<float>(
-            clblast::Layout::kRowMajor,
-            clblast::Transpose::kYes,
-            p_batchSize, flatOutputSize,
-            alpha,
-            getDeltas()(), NO_OFFSET, flatOutputSize,
-            m_onesBuffer(), NO_OFFSET, 1,
-            CLEAR_C,
-            getBiasesGradients().get(), NO_OFFSET, 1,
-            &raw_queue,
-            &raw_gemv_event);
-
-        if (status != clblast::StatusCode::kSuccess)
+            cl_event raw_gemm_event = nullptr;
+            auto status = clblast::Gemm<float>(
+                clblast::Layout::kRowMajor,
+                clblast::Transpose::kYes,
+                clblast::Transpose::kNo,
+                flatOutputSize, flatInputSize, p_batchSize,
+                alpha,
+                deltas(), NO_OFFSET, flatOutputSize,
+                inputs(), NO_OFFSET, flatInputSize,
+                CLEAR_C,
+                weightsGradients(), NO_OFFSET, flatInputSize,
+                &p_queue,
+                &raw_gemm_event,
+                workspace());
+
+            if (status != clblast::StatusCode::kSuccess)
+            {
+                std::cerr << "Weight Gradients CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << layerId << std::endl;
+                throw std::runtime_error("CLBlast GEMM failed");
+            }
+            return raw_gemm_event;
+        };
+        cl::Event gemmEvent = m_sharedResources->enqueueRoutine(p_deltaToGradientQueue, weightsGradientGemm);
+        m_blasScratch->setDeltaToGradientLastUse(gemmEvent);
+
+        auto biasesGradientGemv = [=](cl_command_queue p_queue)
         {
-            std::cerr << "Bias Gradients CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << m_layerId << std::endl;
-            throw std::runtime_error("CLBlast GEMV failed");
-        }
-
-        cl::Event gemvEvent(raw_gemv_event, true);
+            cl_event raw_gemv_event = nullptr;
+            auto status = clblast::Gemv<float>(
+                clblast::Layout::kRowMajor,
+                clblast::Transpose::kYes,
+                p_batchSize, flatOutputSize,
+                alpha,
+                deltas(), NO_OFFSET, flatOutputSize,
+                ones(), NO_OFFSET, 1,
+                CLEAR_C,
+                biasesGradients(), NO_OFFSET, 1,
+                &p_queue,
+                &raw_gemv_event);
+
+            if (status != clblast::StatusCode::kSuccess)
+            {
+                std::cerr << "Bias Gradients CLBlast GEMM failed: " << static_cast<int>(status) << " for layer " << layerId << std::endl;
+                throw std::runtime_error("CLBlast GEMV failed");
+            }
+            return raw_gemv_event;
+        };
+        cl::Event gemvEvent = m_sharedResources->enqueueRoutine(p_deltaToGradientQueue, biasesGradientGemv);
         return {gemmEvent, gemvEvent};
     }
 
-    void DenseLayer::allocateDenseLayerBuffers(const size_t p_batchSize)
+    cl_mem DenseLayer::getForwardBackpropWorkspace() const
     {
-        m_weightsGradients = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE, getWeightsSize() * sizeof(float));
-        m_biasesGradients = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE, getBiasesSize() * sizeof(float));
-        m_onesBuffer = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, p_batchSize * sizeof(float), std::vector<float>(p_batchSize, 1.0f).data());
+        return m_blasScratch ? m_blasScratch->getForwardBackpropWorkspace()() : nullptr;
+    }
 
-        size_t flatInputSize = m_inputDimensions.getTotalElements();
-        size_t flatOutputSize = m_outputDimensions.getTotalElements();
+    void DenseLayer::allocateDenseLayerBuffers(const size_t p_batchSize)
+    {
+        if (isInferenceOnly())
+        {
+            return;
+        }
+        const std::shared_ptr<Utils::BufferPool> &bufferPool = m_sharedResources->getBufferPool();
+        m_weightsGradients = bufferPool->acquire(getWeightsSize() * sizeof(float));
+        m_biasesGradients = bufferPool->acquire(getBiasesSize() * sizeof(float));
+        allocateDenseBatchBuffers(p_batchSize);
+    }
 
-        m_clblastWorkspace = cl::Buffer(
-            m_sharedResources->getContext(),
-            CL_MEM_READ_WRITE,
-            std::max({p_batchSize * flatOutputSize, flatOutputSize * flatInputSize}) * sizeof(float));
+    void DenseLayer::allocateDenseBatchBuffers(const size_t p_batchSize)
+    {
+        if (isInferenceOnly() || m_sharedBlasScratch)
+        {
+            return;
+        }
+        if (!m_blasScratch)
+        {
+            m_blasScratch = std::make_shared<Utils::BlasScratch>(m_sharedResources->getBufferPool());
+        }
+        m_blasScratch->clearRequirements();
+        m_blasScratch->requireOnes(p_batchSize);
+        m_blasScratch->allocate();
+    }
 
-        m_clblastDeltaWorkspace = cl::Buffer(
-            m_sharedResources->getContext(),
-            CL_MEM_READ_WRITE,
-            std::max({p_batchSize * flatInputSize, flatInputSize * flatOutputSize}) * sizeof(float));
+    void DenseLayer::reserveBlasScratch(const cl::CommandQueue &p_queue,
+                                        Utils::BlasScratch &p_scratch,
+                                        const size_t p_batchSize,
+                                        const Utils::ExecutionMode p_mode) const
+    {
+        size_t flatInputSize = getTotalInputElements();
+        size_t flatOutputSize = getTotalOutputElements();
+        p_scratch.requireForwardBackprop(Utils::BlasScratch::getGemmBytes(p_queue, clblast::Transpose::kNo, clblast::Transpose::kYes, p_batchSize, flatOutputSize, flatInputSize));
+        if (p_mode != Utils::ExecutionMode::Training)
+        {
+            return;
+        }
+        p_scratch.requireForwardBackprop(Utils::BlasScratch::getGemmBytes(p_queue, clblast::Transpose::kNo, clblast::Transpose::kNo, p_batchSize, flatInputSize, flatOutputSize));
+        p_scratch.requireDeltaToGradient(Utils::BlasScratch::getGemmBytes(p_queue, clblast::Transpose::kYes, clblast::Transpose::kNo, flatOutputSize, flatInputSize, p_batchSize));
+        p_scratch.requireOnes(p_batchSize);
     }
 
     void DenseLayer::initializeWeightsAndBiases(std::mt19937 &p_rng)
@@ -207,8 +260,8 @@ namespace Layers::Trainable
             bias = 0.0f;
         }
 
-        m_weights = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, h_weights.size() * sizeof(float), h_weights.data());
-        m_biases = cl::Buffer(m_sharedResources->getContext(), CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, h_biases.size() * sizeof(float), h_biases.data());
+        m_weights = m_sharedResources->getBufferPool()->acquire(h_weights.size() * sizeof(float), h_weights.data());
+        m_biases = m_sharedResources->getBufferPool()->acquire(h_biases.size() * sizeof(float), h_biases.data());
     }
 
     void DenseLayer::setupKernels()
@@ -216,7 +269,7 @@ namespace Layers::Trainable
         setupTrainableKernels();
         cl_int err;
 
-        m_biasKernel = cl::Kernel(m_sharedResources->getProgram(), "denseBias", &err);
+        m_biasKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Dense), "denseBias", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create denseBias kernel");
@@ -226,5 +279,19 @@ namespace Layers::Trainable
                              getBiases(),
                              getOutputs(),
                              (cl_int)getTotalOutputElements());
+
+        m_fusedBiasKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Dense), "denseBiasActivation", &err);
+        if (err != CL_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create denseBiasActivation kernel");
+        }
+
+        Utils::setKernelArgs(m_fusedBiasKernel,
+                             getBiases(),
+                             getOutputs(),
+                             getOutputs(),
+                             (cl_uint)getType(),
+                             0.0f,
+                             (cl_uint)getTotalOutputElements());
     }
 }
\ No newline at end of file
@@ -12,23 +12,32 @@ namespace LossFunctions
         Utils::setKernelArgs(m_gradientKernel, p_predictions, p_targets, p_outputGradients, (cl_uint)p_outputElements);
         cl::NDRange global(p_batchSize, p_outputElements);
         cl::Event kernelEvent;
-        p_queue.enqueueNDRangeKernel(m_gradientKernel,
-                                     cl::NullRange,
-                                     global,
-                                     cl::NullRange,
-                                     nullptr,
-                                     &kernelEvent);
+        m_sharedResources->enqueueKernel(p_queue, m_gradientKernel, global, nullptr, &kernelEvent);
         return kernelEvent;
     }
 
+    cl::Event BinaryCrossEntropy::accumulateLoss(const cl::CommandQueue &p_queue,
+                                                 const cl::Buffer &p_predictions,
+                                                 const cl::Buffer &p_targets,
+                                                 size_t p_outputElements,
+                                                 size_t p_batchSize)
+    {
+        return enqueueLossKernel(p_queue, p_predictions, p_targets, p_outputElements * p_batchSize, p_outputElements, 1.0f / static_cast<float>(p_batchSize));
+    }
+
     void BinaryCrossEntropy::setupKernel()
     {
         cl_int err;
-        m_gradientKernel = cl::Kernel(m_sharedResources->getProgram(), "binaryCrossEntropyComputeGradients", &err);
+        m_gradientKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::LossFunction), "binaryCrossEntropyComputeGradients", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create BinaryCrossEntropy gradient kernel");
         }
+        m_lossKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::LossFunction), "binaryCrossEntropyAccumulateLoss", &err);
+        if (err != CL_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create BinaryCrossEntropy loss kernel");
+        }
     }
 
     float BinaryCrossEntropy::computeLoss(const std::vector<float> &p_predictions,
@@ -12,12 +12,7 @@ namespace LossFunctions
         Utils::setKernelArgs(m_gradientKernel, p_predictions, p_targets, p_outputGradients, (cl_uint)p_outputElements, (cl_uint)p_batchSize);
         cl::NDRange global(p_batchSize, p_outputElements);
         cl::Event kernelEvent;
-        cl_int err = p_queue.enqueueNDRangeKernel(m_gradientKernel,
-                                                  cl::NullRange,
-                                                  global,
-                                                  cl::NullRange,
-                                                  nullptr,
-                                                  &kernelEvent);
+        cl_int err = m_sharedResources->enqueueKernel(p_queue, m_gradientKernel, global, nullptr, &kernelEvent);
         if (err != CL_SUCCESS)
         {
             std::cout << "Error code: " << err << "\n";
@@ -27,14 +22,28 @@ namespace LossFunctions
         return kernelEvent;
     }
 
+    cl::Event CategoricalCrossEntropy::accumulateLoss(const cl::CommandQueue &p_queue,
+                                                      const cl::Buffer &p_predictions,
+                                                      const cl::Buffer &p_targets,
+                                                      size_t p_outputElements,
+                                                      size_t p_batchSize)
+    {
+        return enqueueLossKernel(p_queue, p_predictions, p_targets, p_batchSize, p_outputElements, 1.0f / static_cast<float>(p_batchSize));
+    }
+
     void CategoricalCrossEntropy::setupKernel()
     {
         cl_int err;
-        m_gradientKernel = cl::Kernel(m_sharedResources->getProgram(), "categoricalCrossEntropyComputeGradients", &err);
+        m_gradientKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::LossFunction), "categoricalCrossEntropyComputeGradients", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create CategoricalCrossEntropy gradient kernel");
         }
+        m_lossKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::LossFunction), "categoricalCrossEntropyAccumulateLoss", &err);
+        if (err != CL_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create CategoricalCrossEntropy loss kernel");
+        }
     }
 
     float CategoricalCrossEntropy::computeLoss(
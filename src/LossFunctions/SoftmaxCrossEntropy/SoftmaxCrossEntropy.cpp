@@ -9,26 +9,120 @@ namespace LossFunctions
                                                        const size_t p_outputElements,
                                                        const size_t p_batchSize)
     {
-        Utils::setKernelArgs(m_gradientKernel, p_predictions, p_targets, p_outputGradients, (cl_uint)p_outputElements);
-        cl::NDRange global(p_batchSize, p_outputElements);
+        // The loss output is never written without p_writeLosses; the gradients only stand in for it.
+        return enqueueGradientKernel(p_queue, p_predictions, p_targets, p_outputGradients, p_outputGradients, false, true, p_outputElements, p_batchSize);
+    }
+
+    cl::Event SoftmaxCrossEntropy::computeLossGradientAndSampleLosses(const cl::CommandQueue &p_queue,
+                                                                      const cl::Buffer &p_logits,
+                                                                      const cl::Buffer &p_targets,
+                                                                      cl::Buffer &p_outputGradients,
+                                                                      cl::Buffer &p_sampleLosses,
+                                                                      const size_t p_outputElements,
+                                                                      const size_t p_batchSize)
+    {
+        return enqueueGradientKernel(p_queue, p_logits, p_targets, p_outputGradients, p_sampleLosses, true, true, p_outputElements, p_batchSize);
+    }
+
+    cl::Event SoftmaxCrossEntropy::enqueueGradientKernel(const cl::CommandQueue &p_queue,
+                                                         const cl::Buffer &p_logits,
+                                                         const cl::Buffer &p_targets,
+                                                         cl::Buffer &p_outputGradients,
+                                                         const cl::Buffer &p_sampleLosses,
+                                                         bool p_writeLosses,
+                                                         bool p_writeGradients,
+                                                         size_t p_outputElements,
+                                                         size_t p_batchSize)
+    {
+        Utils::setKernelArgs(m_gradientKernel, p_logits, p_targets, p_outputGradients, p_sampleLosses, (cl_uint)p_outputElements, (cl_uint)p_writeLosses, (cl_uint)p_writeGradients);
+        size_t localSize = getRowLocalSize(p_queue, p_outputElements);
         cl::Event kernelEvent;
-        p_queue.enqueueNDRangeKernel(m_gradientKernel,
-                                     cl::NullRange,
-                                     global,
-                                     cl::NullRange,
-                                     nullptr,
-                                     &kernelEvent);
+        cl_int err = m_sharedResources->enqueueKernel(p_queue, m_gradientKernel, cl::NDRange(p_batchSize * localSize), cl::NDRange(localSize), nullptr, &kernelEvent);
+        if (err != CL_SUCCESS)
+        {
+            std::cerr << "Error: Failed to enqueue SoftmaxCrossEntropy gradient kernel. Error code: " << err << std::endl;
+            throw std::runtime_error("Failed to enqueue SoftmaxCrossEntropy gradient kernel. Error code: " + std::to_string(err));
+        }
         return kernelEvent;
     }
 
+    // The smallest power of two covering the classes, capped by the kernel's local memory arrays and the device.
+    size_t SoftmaxCrossEntropy::getRowLocalSize(const cl::CommandQueue &p_queue, size_t p_outputElements)
+    {
+        if (m_maxRowLocalSize == 0)
+        {
+            size_t kernelLimit = std::min(ROW_GROUP_SIZE, m_gradientKernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(p_queue.getInfo<CL_QUEUE_DEVICE>()));
+            m_maxRowLocalSize = 1;
+            while (m_maxRowLocalSize * 2 <= kernelLimit)
+            {
+                m_maxRowLocalSize *= 2;
+            }
+        }
+        size_t localSize = 1;
+        while (localSize < p_outputElements && localSize < m_maxRowLocalSize)
+        {
+            localSize *= 2;
+        }
+        return localSize;
+    }
+
+    cl::Event SoftmaxCrossEntropy::accumulateLoss(const cl::CommandQueue &p_queue,
+                                                  const cl::Buffer &p_predictions,
+                                                  const cl::Buffer &p_targets,
+                                                  size_t p_outputElements,
+                                                  size_t p_batchSize)
+    {
+        // The gradient output is never written without p_writeGradients; the sample losses only stand in for it.
+        cl::Buffer sampleLosses = getSampleLosses(p_batchSize);
+        cl::Event lossesEvent = enqueueGradientKernel(p_queue, p_predictions, p_targets, sampleLosses, sampleLosses, true, false, p_outputElements, p_batchSize);
+        return accumulateSampleLosses(p_queue, lossesEvent, p_batchSize);
+    }
+
+    cl::Event SoftmaxCrossEntropy::computeLossGradientAndAccumulateLoss(const cl::CommandQueue &p_queue,
+                                                                        const cl::Buffer &p_predictions,
+                                                                        const cl::Buffer &p_targets,
+                                                                        cl::Buffer &p_outputGradients,
+                                                                        size_t p_outputElements,
+                                                                        size_t p_batchSize)
+    {
+        cl::Event gradientEvent = enqueueGradientKernel(p_queue, p_predictions, p_targets, p_outputGradients, getSampleLosses(p_batchSize), true, true, p_outputElements, p_batchSize);
+        accumulateSampleLosses(p_queue, gradientEvent, p_batchSize);
+        return gradientEvent;
+    }
+
+    const cl::Buffer &SoftmaxCrossEntropy::getSampleLosses(size_t p_batchSize)
+    {
+        if (m_sampleLossCapacity < p_batchSize)
+        {
+            const std::shared_ptr<Utils::BufferPool> &bufferPool = m_sharedResources->getBufferPool();
+            bufferPool->release(m_sampleLosses);
+            m_sampleLosses = bufferPool->acquire(p_batchSize * sizeof(float));
+            m_sampleLossCapacity = p_batchSize;
+        }
+        return m_sampleLosses;
+    }
+
+    cl::Event SoftmaxCrossEntropy::accumulateSampleLosses(const cl::CommandQueue &p_queue, const cl::Event &p_lossesEvent, size_t p_batchSize)
+    {
+        ensureLossSum(p_queue);
+        Utils::setKernelArgs(m_lossKernel, m_sampleLosses, m_lossSum, (cl_uint)p_batchSize, 1.0f / static_cast<float>(p_batchSize));
+        std::vector<cl::Event> waitList = {p_lossesEvent};
+        return launchLossKernel(p_queue, p_batchSize, &waitList);
+    }
+
     void SoftmaxCrossEntropy::setupKernel()
     {
         cl_int err;
-        m_gradientKernel = cl::Kernel(m_sharedResources->getProgram(), "softmaxCrossEntropyComputeGradients", &err);
+        m_gradientKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::LossFunction), "softmaxCrossEntropyComputeGradients", &err);
         if (err != CL_SUCCESS)
         {
             throw std::runtime_error("Failed to create SoftmaxCrossEntropy gradient kernel");
         }
+        m_lossKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::LossFunction), "accumulateSampleLosses", &err);
+        if (err != CL_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create SoftmaxCrossEntropy loss kernel");
+        }
     }
 
     float SoftmaxCrossEntropy::computeLoss(
@@ -37,17 +131,24 @@ namespace LossFunctions
         size_t p_outputElements,
         size_t p_batchSize)
     {
+        // The predictions are logits; each sample's loss comes from its log-softmax.
         float totalLoss = 0.0f;
 
         for (size_t b = 0; b < p_batchSize; ++b)
         {
-            float sampleLoss = 0.0f;
             size_t base = b * p_outputElements;
+            float maxLogit = *std::max_element(p_predictions.begin() + base, p_predictions.begin() + base + p_outputElements);
+            float sumExp = 0.0f;
+            for (size_t c = 0; c < p_outputElements; ++c)
+            {
+                sumExp += std::exp(p_predictions[base + c] - maxLogit);
+            }
+            float logSumExp = maxLogit + std::log(sumExp);
 
+            float sampleLoss = 0.0f;
             for (size_t c = 0; c < p_outputElements; ++c)
             {
-                float pred = std::max(p_predictions[base + c], 1e-15f);
-                sampleLoss += -p_targets[base + c] * std::log(pred);
+                sampleLoss -= p_targets[base + c] * (p_predictions[base + c] - logSumExp);
             }
 
             totalLoss += sampleLoss;
@@ -1,27 +1,57 @@
 #include "NeuralNetworks/Local/LocalNeuralNetwork.hpp"
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <optional>
 namespace NeuralNetworks::Local
 {
     LocalNeuralNetwork::LocalNeuralNetwork(Utils::OpenCLResources &&p_oclResources,
                                            const Utils::NetworkArgs &p_networkArgs,
                                            const size_t p_seed,
-                                           const size_t p_batchSize)
-        : NeuralNetwork(std::move(p_oclResources), p_networkArgs.getInitialInputDimensions(), p_batchSize)
+                                           const size_t p_batchSize,
+                                           const Utils::ExecutionMode p_mode)
+        : NeuralNetwork(std::move(p_oclResources), p_networkArgs.getInitialInputDimensions(), p_batchSize),
+          m_executionMode(p_mode),
+          m_inferenceOnly(p_mode == Utils::ExecutionMode::Inference)
     {
         m_rng = std::mt19937(static_cast<unsigned long>(p_seed));
 
+        std::vector<Utils::KernelFamily> kernelFamilies;
+        for (const auto &layerArgs : p_networkArgs.getLayersArguments())
+        {
+            kernelFamilies.push_back(Utils::kernelFamilyFromLayerType(layerArgs->getLayerType()));
+        }
+        if (p_networkArgs.getLossFunctionArguments())
+        {
+            kernelFamilies.push_back(Utils::KernelFamily::LossFunction);
+        }
+        if (p_networkArgs.getOptimizerArguments() && !m_inferenceOnly)
+        {
+            kernelFamilies.push_back(Utils::KernelFamily::Optimizer);
+        }
+        m_oclResources->getSharedResources()->buildPrograms(kernelFamilies);
+
         Utils::Dimensions currentInputDimensions = m_inputDimensions;
         for (const auto &layerArgs : p_networkArgs.getLayersArguments())
         {
-            m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), currentInputDimensions, m_batchSize, m_rng));
+            m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), currentInputDimensions, m_batchSize, m_rng, p_mode));
             currentInputDimensions = m_layers.back()->getOutputDimensions();
         }
         m_lossFunction = p_networkArgs.getLossFunctionArguments()->createLossFunction(m_oclResources->getSharedResources());
-        m_optimizer = p_networkArgs.getOptimizerArguments()->createOptimizer(m_oclResources->getSharedResources());
+        if (!m_inferenceOnly)
+        {
+            m_optimizer = p_networkArgs.getOptimizerArguments()->createOptimizer(m_oclResources->getSharedResources());
+        }
+        m_oclResources->getSharedResources()->getBlasTuner()->apply(m_oclResources->getDevice(), getBlasShapes());
+        planMemory(m_executionMode);
     }
 
     LocalNeuralNetwork::LocalNeuralNetwork(Utils::OpenCLResources &&p_oclResources,
-                                           const H5::H5File &p_file, const size_t p_batchSize)
-        : NeuralNetwork(std::move(p_oclResources), p_file, p_batchSize)
+                                           const H5::H5File &p_file, const size_t p_batchSize,
+                                           const Utils::ExecutionMode p_mode)
+        : NeuralNetwork(std::move(p_oclResources), p_file, p_batchSize),
+          m_executionMode(p_mode),
+          m_inferenceOnly(p_mode == Utils::ExecutionMode::Inference)
     {
 
         H5::DataSet dataset = p_file.openDataSet("rngState");
@@ -43,18 +73,446 @@ namespace NeuralNetworks::Local
         else
             numLayers = 0;
 
+        std::vector<Utils::KernelFamily> kernelFamilies = {Utils::KernelFamily::LossFunction};
+        if (!m_inferenceOnly)
+        {
+            kernelFamilies.push_back(Utils::KernelFamily::Optimizer);
+        }
+        for (size_t i = 0; i < numLayers; ++i)
+        {
+            H5::Group layerGroup = layersGroup.openGroup(std::to_string(i));
+            kernelFamilies.push_back(Utils::kernelFamilyFromLayerType(
+                Utils::layerTypeFromUint(Utils::readValueFromHDF5<unsigned int>(layerGroup, "layerType"))));
+        }
+        m_oclResources->getSharedResources()->buildPrograms(kernelFamilies);
+
         for (size_t i = 0; i < numLayers; ++i)
         {
             std::string layerId = std::to_string(i);
             H5::Group layerGroup = layersGroup.openGroup(layerId);
-            m_layers.emplace_back(Utils::loadLayer(m_oclResources->getSharedResources(), layerGroup, m_batchSize));
+            m_layers.emplace_back(Utils::loadLayer(m_oclResources->getSharedResources(), layerGroup, m_batchSize, p_mode));
         }
 
         H5::Group lossFunctionGroup = p_file.openGroup("lossFunction");
         m_lossFunction = Utils::loadLossFunction(m_oclResources->getSharedResources(), lossFunctionGroup);
 
-        H5::Group optimizerGroup = p_file.openGroup("optimizer");
-        m_optimizer = Utils::loadOptimizer(m_oclResources->getSharedResources(), optimizerGroup);
+        if (!m_inferenceOnly)
+        {
+            H5::Group optimizerGroup = p_file.openGroup("optimizer");
+            m_optimizer = Utils::loadOptimizer(m_oclResources->getSharedResources(), optimizerGroup);
+        }
+        m_oclResources->getSharedResources()->getBlasTuner()->apply(m_oclResources->getDevice(), getBlasShapes());
+        planMemory(m_executionMode);
+    }
+
+    LocalNeuralNetwork::~LocalNeuralNetwork()
+    {
+        // Layer and optimizer buffers go back to the shared pool, so queued work on them must be done.
+        finishQueues();
+        releaseStepBuffers();
+    }
+
+    void LocalNeuralNetwork::finishQueues() const
+    {
+        if (!m_oclResources)
+        {
+            return;
+        }
+        m_oclResources->getForwardBackpropQueue().finish();
+        m_oclResources->getDeltaToGradientQueue().finish();
+        m_oclResources->getConcurrentQueue().finish();
+    }
+
+    void LocalNeuralNetwork::planMemory(Utils::ExecutionMode p_mode)
+    {
+        if (m_inferenceOnly && p_mode == Utils::ExecutionMode::Training)
+        {
+            std::cerr << "Error: Cannot plan training memory for an inference-only network." << std::endl;
+            throw std::invalid_argument("Inference-only networks have no training state to plan.");
+        }
+        finishQueues();
+        m_stepRecording.clear();
+        m_executionMode = p_mode;
+        m_memoryPlanStale = false;
+        if (m_layers.empty())
+        {
+            return;
+        }
+        findFusedActivations(p_mode);
+
+        // Forward of layer i is step i, the loss gradient step L and backprop of layer l step 2L - l. Buffers
+        // read by the gradient and optimizer queues stay live until the concurrent queue is finished. A fused
+        // activation is written by the step of the layer before it and backpropagates in place on the deltas
+        // it shares with that layer.
+        const size_t layerCount = m_layers.size();
+        const size_t lossStep = layerCount;
+        const size_t syncStep = 2 * layerCount + 1;
+        auto backwardStep = [layerCount](size_t p_layer)
+        { return 2 * layerCount - p_layer; };
+        const bool training = p_mode == Utils::ExecutionMode::Training;
+
+        const std::shared_ptr<Utils::BufferPool> &bufferPool = m_oclResources->getSharedResources()->getBufferPool();
+        Utils::MemoryPlanner planner(bufferPool->getAlignment());
+        std::vector<size_t> outputTensors;
+        std::vector<size_t> deltaTensors;
+        if (training && m_gradientCheckpointing)
+        {
+            addCheckpointedTensors(planner, outputTensors, deltaTensors);
+        }
+        else
+        {
+            for (size_t i = 0; i < layerCount; ++i)
+            {
+                const auto &layer = m_layers[i];
+                const bool fused = m_fusedActivations[i];
+                const bool fusedNext = i + 1 < layerCount && m_fusedActivations[i + 1];
+                size_t bytes = m_batchSize * layer->getTotalOutputElements() * sizeof(float);
+                outputTensors.push_back(planner.addTensor(bytes, fused ? i - 1 : i, fusedNext ? i : i + 1));
+                if (!training)
+                {
+                    continue;
+                }
+
+                if (i + 1 == layerCount || m_layers[i + 1]->isTrainable())
+                {
+                    planner.extendLifetime(outputTensors.back(), syncStep);
+                }
+                if (i > 0 && layer->readsOutputsInBackward())
+                {
+                    planner.extendLifetime(outputTensors.back(), backwardStep(i));
+                }
+
+                if (fused)
+                {
+                    deltaTensors.push_back(deltaTensors.back());
+                    continue;
+                }
+                size_t consumer = fusedNext ? i + 2 : i + 1;
+                size_t writeStep = consumer == layerCount ? lossStep : backwardStep(consumer);
+                deltaTensors.push_back(planner.addTensor(bytes, writeStep, writeStep));
+                if (i > 0)
+                {
+                    planner.extendLifetime(deltaTensors.back(), backwardStep(i));
+                }
+                if (layer->isTrainable())
+                {
+                    planner.extendLifetime(deltaTensors.back(), syncStep);
+                }
+            }
+        }
+        planner.plan();
+
+        // Layers sharing a tensor must also share its sub-buffer: overlapping sub-buffers may not be used together.
+        m_activationArena = cl::Buffer(m_oclResources->getContext(), bufferPool->getMemFlags(), planner.getArenaSize());
+        std::map<size_t, cl::Buffer> regions;
+        auto createRegion = [this, &planner, &regions](size_t p_tensor)
+        {
+            auto it = regions.find(p_tensor);
+            if (it != regions.end())
+            {
+                return it->second;
+            }
+            cl_buffer_region region = {planner.getOffset(p_tensor), planner.getBytes(p_tensor)};
+            cl::Buffer buffer = m_activationArena.createSubBuffer(CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region);
+            regions.emplace(p_tensor, buffer);
+            return buffer;
+        };
+        for (size_t i = 0; i < layerCount; ++i)
+        {
+            m_layers[i]->assignPlannedBuffers(createRegion(outputTensors[i]), training ? createRegion(deltaTensors[i]) : cl::Buffer());
+        }
+        bindFusedActivations();
+        m_activationArenaSize = planner.getArenaSize();
+        m_unplannedActivationSize = planner.getUnplannedSize();
+
+        if (!m_blasScratch)
+        {
+            m_blasScratch = std::make_shared<Utils::BlasScratch>(bufferPool);
+        }
+        m_blasScratch->clearRequirements();
+        for (const auto &layer : m_layers)
+        {
+            layer->reserveBlasScratch(m_oclResources->getForwardBackpropQueue(), *m_blasScratch, m_batchSize, p_mode);
+        }
+        m_blasScratch->allocate();
+        for (auto &layer : m_layers)
+        {
+            layer->assignBlasScratch(m_blasScratch);
+        }
+
+        if (training)
+        {
+            packParameters();
+        }
+
+        // The per-layer activations the arena replaces were discarded as it was assigned, so the pool, which other
+        // networks and the data loaders share, is left alone.
+        refreshMemoryUsage();
+    }
+
+    // Gradient checkpointing recomputes each layer's outputs on its own, so it keeps every activation separate.
+    void LocalNeuralNetwork::findFusedActivations(Utils::ExecutionMode p_mode)
+    {
+        m_fusedActivations.assign(m_layers.size(), false);
+        if (!m_activationFusion || (p_mode == Utils::ExecutionMode::Training && m_gradientCheckpointing))
+        {
+            return;
+        }
+        for (size_t i = 1; i < m_layers.size(); ++i)
+        {
+            if (!m_layers[i - 1]->isTrainable() || m_layers[i]->isTrainable())
+            {
+                continue;
+            }
+            const auto &activation = static_cast<const Layers::Activation::ActivationLayer &>(*m_layers[i]);
+            m_fusedActivations[i] = activation.isFusable();
+        }
+    }
+
+    void LocalNeuralNetwork::bindFusedActivations()
+    {
+        for (size_t i = 0; i < m_layers.size(); ++i)
+        {
+            if (!m_layers[i]->isTrainable())
+            {
+                continue;
+            }
+            auto &trainableLayer = static_cast<Layers::Trainable::TrainableLayer &>(*m_layers[i]);
+            if (!isActivationFused(i + 1))
+            {
+                trainableLayer.clearFusedActivation();
+                continue;
+            }
+            auto &activation = static_cast<Layers::Activation::ActivationLayer &>(*m_layers[i + 1]);
+            trainableLayer.fuseActivation(activation.getType(), activation.getFusedAlpha(), activation.getOutputs());
+        }
+    }
+
+    void LocalNeuralNetwork::refreshMemoryUsage()
+    {
+        const size_t network = Utils::MemoryTracker::NETWORK_OWNER;
+        m_memoryTracker.beginSnapshot();
+        m_memoryTracker.record(network, Utils::MemoryRole::Activations, m_activationArena);
+        if (m_parameterArena)
+        {
+            m_memoryTracker.record(network, Utils::MemoryRole::Weights, m_parameterArena->getParameters());
+            m_memoryTracker.record(network, Utils::MemoryRole::Gradients, m_parameterArena->getGradients());
+        }
+        if (m_blasScratch)
+        {
+            m_memoryTracker.record(network, Utils::MemoryRole::Workspace, m_blasScratch->getAllocatedBytes());
+        }
+        m_memoryTracker.record(network, Utils::MemoryRole::Batch, m_batchBytes);
+        m_memoryTracker.record(network, Utils::MemoryRole::Batch, m_stepInputs);
+        m_memoryTracker.record(network, Utils::MemoryRole::Batch, m_stepTargets);
+        for (const auto &layer : m_layers)
+        {
+            layer->reportMemory(m_memoryTracker);
+        }
+        if (m_optimizer)
+        {
+            m_optimizer->reportMemory(m_memoryTracker);
+        }
+        m_memoryTracker.endSnapshot();
+    }
+
+    // Layers are only ever appended, so the arena is rebuilt only when trainable layers were added.
+    void LocalNeuralNetwork::packParameters()
+    {
+        std::vector<Layers::Trainable::TrainableLayer *> trainableLayers;
+        for (auto &layer : m_layers)
+        {
+            if (layer->isTrainable())
+            {
+                trainableLayers.push_back(static_cast<Layers::Trainable::TrainableLayer *>(layer.get()));
+            }
+        }
+        if (trainableLayers.empty() || (m_parameterArena && m_parameterArena->getRangeCount() == 2 * trainableLayers.size()))
+        {
+            return;
+        }
+
+        const std::shared_ptr<Utils::BufferPool> &bufferPool = m_oclResources->getSharedResources()->getBufferPool();
+        const cl::CommandQueue &queue = m_oclResources->getForwardBackpropQueue();
+        auto arena = std::make_unique<Utils::ParameterArena>(m_oclResources->getContext(), bufferPool->getMemFlags(), bufferPool->getAlignment());
+        for (const auto *layer : trainableLayers)
+        {
+            arena->addRange(std::to_string(layer->getLayerId()) + "Weights", layer->getWeightsSize());
+            arena->addRange(std::to_string(layer->getLayerId()) + "Biases", layer->getBiasesSize());
+        }
+        arena->allocate(queue);
+        for (size_t i = 0; i < trainableLayers.size(); ++i)
+        {
+            trainableLayers[i]->assignParameterRegions(queue,
+                                                       arena->createRegion(arena->getParameters(), 2 * i),
+                                                       arena->createRegion(arena->getParameters(), 2 * i + 1),
+                                                       arena->createRegion(arena->getGradients(), 2 * i),
+                                                       arena->createRegion(arena->getGradients(), 2 * i + 1));
+        }
+        if (m_optimizer)
+        {
+            m_optimizer->bindParameterArena(queue, *arena);
+        }
+        m_parameterArena = std::move(arena);
+    }
+
+    // One optimizer launch for the whole model, after every gradient and the last backprop (which still
+    // reads weights) are done.
+    void LocalNeuralNetwork::applyOptimizerStep(std::vector<cl::Event> &p_waitList, const cl::Event &p_lastBackpropEvent)
+    {
+        if (p_lastBackpropEvent() != nullptr)
+        {
+            p_waitList.push_back(p_lastBackpropEvent);
+        }
+        if (m_optimizer && m_parameterArena)
+        {
+            p_waitList = {m_optimizer->updateParameterArena(m_oclResources->getConcurrentQueue(), p_waitList, *m_parameterArena)};
+        }
+        // While pipelining, the next step's forward pass waits for the update on the device instead of the host draining the queues.
+        if (m_pipelining && !p_waitList.empty())
+        {
+            m_oclResources->getSharedResources()->enqueueBarrier(m_oclResources->getForwardBackpropQueue(), &p_waitList);
+        }
+        finishOptimizerStep();
+    }
+
+    void LocalNeuralNetwork::finishOptimizerStep()
+    {
+        if (!m_pipelining)
+        {
+            cl_int err = m_oclResources->getConcurrentQueue().finish();
+            if (err != CL_SUCCESS)
+            {
+                throw std::runtime_error("Failed to finish concurrent queue during backpropagation. Error code: " + std::to_string(err));
+            }
+        }
+        if (m_optimizer)
+        {
+            m_optimizer->step();
+        }
+    }
+
+    std::vector<std::pair<size_t, size_t>> LocalNeuralNetwork::getCheckpointSegments() const
+    {
+        const size_t layerCount = m_layers.size();
+        size_t segmentLength = m_checkpointSegmentLength;
+        if (segmentLength == 0)
+        {
+            segmentLength = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(layerCount))));
+        }
+        std::vector<std::pair<size_t, size_t>> segments;
+        for (size_t first = 0; first < layerCount; first += segmentLength)
+        {
+            segments.push_back({first, std::min(first + segmentLength, layerCount) - 1});
+        }
+        return segments;
+    }
+
+    // Forward of layer i is step i and the loss gradient step L. Backward then visits the segments last to
+    // first: it recomputes the outputs inside the segment, backpropagates through it and waits for the
+    // segment's gradients at a sync step. Only segment ends (the checkpoints) stay live across segments.
+    void LocalNeuralNetwork::addCheckpointedTensors(Utils::MemoryPlanner &p_planner, std::vector<size_t> &p_outputTensors, std::vector<size_t> &p_deltaTensors) const
+    {
+        const size_t layerCount = m_layers.size();
+        const size_t lossStep = layerCount;
+        const std::vector<std::pair<size_t, size_t>> segments = getCheckpointSegments();
+        std::vector<size_t> segmentLast(layerCount);
+        std::vector<size_t> recomputeStep(layerCount);
+        std::vector<size_t> backwardStep(layerCount);
+        std::vector<size_t> segmentSyncStep(layerCount);
+        size_t step = lossStep + 1;
+        for (auto segment = segments.rbegin(); segment != segments.rend(); ++segment)
+        {
+            for (size_t i = segment->first; i < segment->second; ++i)
+            {
+                recomputeStep[i] = step++;
+            }
+            for (size_t l = segment->second + 1; l-- > segment->first;)
+            {
+                backwardStep[l] = step++;
+            }
+            for (size_t l = segment->first; l <= segment->second; ++l)
+            {
+                segmentLast[l] = segment->second;
+                segmentSyncStep[l] = step;
+            }
+            ++step;
+        }
+        const size_t syncStep = step;
+
+        for (size_t i = 0; i < layerCount; ++i)
+        {
+            const auto &layer = m_layers[i];
+            size_t bytes = m_batchSize * layer->getTotalOutputElements() * sizeof(float);
+            p_outputTensors.push_back(p_planner.addTensor(bytes, i, i + 1));
+            if (i + 1 == layerCount)
+            {
+                p_planner.extendLifetime(p_outputTensors.back(), syncStep);
+            }
+            else if (i == segmentLast[i])
+            {
+                p_planner.extendLifetime(p_outputTensors.back(), segmentSyncStep[i]);
+            }
+            else
+            {
+                size_t lastRead = i + 1 == segmentLast[i] ? recomputeStep[i] : recomputeStep[i + 1];
+                if (i > 0 && layer->readsOutputsInBackward())
+                {
+                    lastRead = backwardStep[i];
+                }
+                if (m_layers[i + 1]->isTrainable())
+                {
+                    lastRead = segmentSyncStep[i];
+                }
+                p_planner.addLiveRange(p_outputTensors.back(), recomputeStep[i], lastRead);
+            }
+
+            size_t writeStep = i + 1 == layerCount ? lossStep : backwardStep[i + 1];
+            p_deltaTensors.push_back(p_planner.addTensor(bytes, writeStep, writeStep));
+            if (i > 0)
+            {
+                p_planner.extendLifetime(p_deltaTensors.back(), backwardStep[i]);
+            }
+            if (layer->isTrainable())
+            {
+                p_planner.extendLifetime(p_deltaTensors.back(), segmentSyncStep[i]);
+            }
+        }
+    }
+
+    void LocalNeuralNetwork::checkTrainingPlan() const
+    {
+        if (m_executionMode != Utils::ExecutionMode::Training)
+        {
+            std::cerr << "Error: Backward pass requested on a network planned for inference." << std::endl;
+            throw std::runtime_error("Backward pass requires a training memory plan. Call planMemory(Utils::ExecutionMode::Training) first.");
+        }
+    }
+
+    void LocalNeuralNetwork::ensureMemoryPlan()
+    {
+        if (m_memoryPlanStale)
+        {
+            planMemory(m_executionMode);
+        }
+    }
+
+    std::vector<Utils::BlasShape> LocalNeuralNetwork::getBlasShapes() const
+    {
+        std::vector<Utils::BlasShape> shapes;
+        for (const auto &layer : m_layers)
+        {
+            std::vector<Utils::BlasShape> layerShapes = layer->getBlasShapes(m_batchSize);
+            shapes.insert(shapes.end(), layerShapes.begin(), layerShapes.end());
+        }
+        return shapes;
+    }
+
+    void LocalNeuralNetwork::tuneBlasKernels(double p_fraction)
+    {
+        m_oclResources->getSharedResources()->getBlasTuner()->tune(m_oclResources->getForwardBackpropQueue(), getBlasShapes(), p_fraction);
+        // Overridden tile sizes change the temporary buffers CLBlast needs, so the scratch is re-reserved under them.
+        m_memoryPlanStale = true;
     }
 
     std::vector<float> LocalNeuralNetwork::predict(const cl::Buffer &p_inputBatch,
@@ -66,6 +524,14 @@ namespace NeuralNetworks::Local
         std::vector<float> predictionVec(predictionSize);
 
         std::vector<cl::Event> waitList = {forwardEvent};
+        if (Utils::isHostResident(prediction))
+        {
+            Utils::accessHostMemory(m_oclResources->getForwardBackpropQueue(), prediction, sizeof(float) * predictionSize, CL_MAP_READ,
+                                    [&predictionVec](void *p_mapped)
+                                    { std::memcpy(predictionVec.data(), p_mapped, predictionVec.size() * sizeof(float)); },
+                                    &waitList);
+            return predictionVec;
+        }
         m_oclResources->getForwardBackpropQueue().enqueueReadBuffer(prediction, BLOCKING_READ, NO_OFFSET,
                                                                     sizeof(float) * predictionSize, predictionVec.data(), &waitList);
         return predictionVec;
@@ -73,6 +539,18 @@ namespace NeuralNetworks::Local
 
     double LocalNeuralNetwork::trainStep(const Utils::Batch &p_batch,
                                          bool p_lossReporting)
+    {
+        const cl::CommandQueue &queue = m_oclResources->getForwardBackpropQueue();
+        if (p_lossReporting)
+        {
+            m_lossFunction->resetLossSum(queue);
+        }
+        launchTrainStep(p_batch, p_lossReporting);
+        return p_lossReporting ? m_lossFunction->readLossSum(queue) : -1.0;
+    }
+
+    // The loss is accumulated on the in-order queue after the step; the last outputs stay planned until then.
+    void LocalNeuralNetwork::launchTrainStep(const Utils::Batch &p_batch, bool p_accumulateLoss)
     {
         if (p_batch.getInputDimensions() != m_inputDimensions)
         {
@@ -82,86 +560,278 @@ namespace NeuralNetworks::Local
         {
             throw std::invalid_argument("Batch has no target values.");
         }
+        checkTrainingPlan();
         cl::Buffer inputs = p_batch.getInputs();
         cl::Buffer targets = p_batch.getTargets();
         size_t batchSize = p_batch.getSize();
-        cl::Event forwardEvent = forward(inputs, batchSize);
-        double loss = -1.0;
-        std::future<double> lossFuture;
-        if (p_lossReporting == true)
+        size_t batchBytes = inputs.getInfo<CL_MEM_SIZE>() + targets.getInfo<CL_MEM_SIZE>();
+        if (batchBytes != m_batchBytes)
         {
-            lossFuture = std::async(std::launch::async, &LocalNeuralNetwork::computeLossAsync, this, std::ref(forwardEvent), p_batch.getTargetsVector(), batchSize);
+            m_batchBytes = batchBytes;
+            refreshMemoryUsage();
         }
-        cl::Event deltaEvent = computeLossGradients(targets, batchSize);
-        backward(deltaEvent, inputs, batchSize);
+        if (m_compiledSteps)
+        {
+            runCompiledStep(p_batch);
+            targets = m_stepTargets;
+        }
+        else
+        {
+            if (!p_batch.getUploadEvents().empty())
+            {
+                m_oclResources->getForwardBackpropQueue().enqueueBarrierWithWaitList(&p_batch.getUploadEvents());
+            }
+            forward(inputs, batchSize);
+            cl::Event deltaEvent = computeLossGradients(targets, batchSize, p_accumulateLoss);
+            backward(deltaEvent, inputs, batchSize);
+        }
+        // Recorded steps leave the loss out, so it is accumulated after the replay.
+        if (p_accumulateLoss && m_compiledSteps)
+        {
+            m_lossFunction->accumulateLoss(m_oclResources->getForwardBackpropQueue(), m_layers.back()->getOutputs(), targets,
+                                           m_layers.back()->getTotalOutputElements(), batchSize);
+        }
+    }
 
-        if (p_lossReporting)
+    // The batch is copied into the step buffers on the in-order queue, ahead of the first recorded command.
+    void LocalNeuralNetwork::runCompiledStep(const Utils::Batch &p_batch)
+    {
+        size_t batchSize = p_batch.getSize();
+        ensureBatchCapacity(batchSize);
+        ensureMemoryPlan();
+        prepareStepBuffers();
+
+        const cl::CommandQueue &queue = m_oclResources->getForwardBackpropQueue();
+        const std::vector<cl::Event> *uploadEvents = p_batch.getUploadEvents().empty() ? nullptr : &p_batch.getUploadEvents();
+        queue.enqueueCopyBuffer(p_batch.getInputs(), m_stepInputs, NO_OFFSET, NO_OFFSET,
+                                batchSize * m_inputDimensions.getTotalElements() * sizeof(float), uploadEvents);
+        queue.enqueueCopyBuffer(p_batch.getTargets(), m_stepTargets, NO_OFFSET, NO_OFFSET,
+                                batchSize * m_layers.back()->getTotalOutputElements() * sizeof(float), uploadEvents);
+
+        // A single recording is kept: kernels hold the arguments of the last step that set them, so a
+        // recording for another batch size would see this one's.
+        if (m_stepRecording.empty() || m_recordedBatchSize != batchSize)
         {
-            lossFuture.wait();
-            loss = lossFuture.get();
+            recordStep(batchSize);
         }
+        else
+        {
+            m_stepRecording.replay();
+            finishOptimizerStep();
+        }
+    }
 
-        return loss;
+    // The recorded step also runs, so the first step of a shape costs no more than an uncompiled one.
+    void LocalNeuralNetwork::recordStep(const size_t p_batchSize)
+    {
+        const std::shared_ptr<Utils::SharedResources> &sharedResources = m_oclResources->getSharedResources();
+        m_stepRecording.clear();
+        m_recordingStep = true;
+        sharedResources->setCommandRecorder(&m_stepRecording);
+        try
+        {
+            forward(m_stepInputs, p_batchSize);
+            cl::Event deltaEvent = computeLossGradients(m_stepTargets, p_batchSize);
+            backward(deltaEvent, m_stepInputs, p_batchSize);
+        }
+        catch (...)
+        {
+            sharedResources->setCommandRecorder(nullptr);
+            m_recordingStep = false;
+            m_stepRecording.clear();
+            throw;
+        }
+        sharedResources->setCommandRecorder(nullptr);
+        m_recordingStep = false;
+        m_recordedBatchSize = p_batchSize;
+        // Launches still being tuned were recorded with a NULL local size; replaying them would keep it and
+        // starve the tuner, so steps keep recording until every launch has settled.
+        if (m_stepRecording.isProvisional())
+        {
+            m_stepRecording.clear();
+        }
+    }
+
+    void LocalNeuralNetwork::prepareStepBuffers()
+    {
+        if (m_stepBufferBatchSize == m_batchSize)
+        {
+            return;
+        }
+        releaseStepBuffers();
+        const std::shared_ptr<Utils::BufferPool> &bufferPool = m_oclResources->getSharedResources()->getBufferPool();
+        m_stepInputs = bufferPool->acquire(m_batchSize * m_inputDimensions.getTotalElements() * sizeof(float));
+        m_stepTargets = bufferPool->acquire(m_batchSize * m_layers.back()->getTotalOutputElements() * sizeof(float));
+        m_stepBufferBatchSize = m_batchSize;
+        m_stepRecording.clear();
+        refreshMemoryUsage();
+    }
+
+    void LocalNeuralNetwork::releaseStepBuffers()
+    {
+        if (!m_oclResources)
+        {
+            return;
+        }
+        const std::shared_ptr<Utils::BufferPool> &bufferPool = m_oclResources->getSharedResources()->getBufferPool();
+        bufferPool->release(m_stepInputs);
+        bufferPool->release(m_stepTargets);
+        m_stepBufferBatchSize = 0;
     }
 
+    void LocalNeuralNetwork::setPipelineDepth(const size_t p_depth)
+    {
+        if (p_depth == 0)
+        {
+            std::cerr << "Error: Pipeline depth must be at least 1." << std::endl;
+            throw std::invalid_argument("Pipeline depth must be at least 1.");
+        }
+        m_pipelineDepth = p_depth;
+    }
+
+    // Recordings made with and without pipelining differ by the barrier after the optimizer update.
+    void LocalNeuralNetwork::setPipelining(const bool p_enabled)
+    {
+        if (m_pipelining == p_enabled)
+        {
+            return;
+        }
+        finishQueues();
+        m_pipelining = p_enabled;
+        m_stepRecording.clear();
+    }
+
+    // Up to m_pipelineDepth steps are in flight. Each keeps its batch until it is retired, because the device
+    // may still read the batch buffers. Losses add up in the loss function's device scalar, which is only
+    // read at the readback interval and at the end of each epoch.
     void LocalNeuralNetwork::train(
         DataLoaders::DataLoader &p_dataLoader,
         int p_epochs,
         bool p_lossReporting)
     {
         p_dataLoader.activateTrainPartition();
+        setPipelining(m_pipelineDepth > 1);
+        const cl::CommandQueue &queue = m_oclResources->getForwardBackpropQueue();
 
-        for (int epoch = 0; epoch < p_epochs; ++epoch)
+        std::deque<PendingStep> pending;
+        try
         {
-            p_dataLoader.shuffleCurrentPartition(m_rng);
+            for (int epoch = 0; epoch < p_epochs; ++epoch)
+            {
+                p_dataLoader.shuffleCurrentPartition(m_rng);
 
-            double epochLoss = 0.0;
-            size_t batchCount = 0;
+                size_t batchCount = 0;
+                if (p_lossReporting)
+                {
+                    m_lossFunction->resetLossSum(queue);
+                }
+                auto retireOldest = [&pending]()
+                {
+                    pending.front().m_completion.wait();
+                    pending.pop_front();
+                };
 
-            for (const Utils::Batch &batch : p_dataLoader)
-            {
-                double batchLoss = trainStep(batch, p_lossReporting);
-                epochLoss += batchLoss;
-                batchCount++;
-            }
+                // Batch N + 1 is fetched before batch N is trained, so its upload on the transfer queue
+                // overlaps the compute of batch N.
+                auto batchIt = p_dataLoader.begin();
+                const auto batchEnd = p_dataLoader.end();
+                std::optional<Utils::Batch> current;
+                if (batchIt != batchEnd)
+                {
+                    current.emplace(*batchIt);
+                }
+                while (current)
+                {
+                    std::optional<Utils::Batch> next;
+                    if (++batchIt != batchEnd)
+                    {
+                        next.emplace(*batchIt);
+                    }
+                    pending.push_back({std::move(*current), cl::Event()});
+                    PendingStep &step = pending.back();
+                    launchTrainStep(step.m_batch, p_lossReporting);
+                    queue.enqueueMarkerWithWaitList(nullptr, &step.m_completion);
+                    batchCount++;
+                    if (p_lossReporting && m_lossReadbackInterval > 0 && batchCount % m_lossReadbackInterval == 0)
+                    {
+                        std::cout
+                            << "Epoch " << (epoch + 1)
+                            << " | Step " << batchCount
+                            << " | Loss: " << (m_lossFunction->readLossSum(queue) / batchCount)
+                            << "\n";
+                    }
+                    while (pending.size() >= m_pipelineDepth)
+                    {
+                        retireOldest();
+                    }
+                    current.reset();
+                    if (next)
+                    {
+                        current.emplace(std::move(*next));
+                    }
+                }
+                while (!pending.empty())
+                {
+                    retireOldest();
+                }
 
-            if (p_lossReporting)
-            {
-                std::cout
-                    << "Epoch " << (epoch + 1)
-                    << " | Loss: " << (epochLoss / batchCount)
-                    << "\n";
+                if (p_lossReporting)
+                {
+                    std::cout
+                        << "Epoch " << (epoch + 1)
+                        << " | Loss: " << (m_lossFunction->readLossSum(queue) / batchCount)
+                        << "\n";
+                }
             }
         }
+        catch (...)
+        {
+            finishQueues();
+            pending.clear();
+            setPipelining(false);
+            throw;
+        }
+        setPipelining(false);
     }
 
     cl::Event LocalNeuralNetwork::forward(const cl::Buffer &p_batchInputs, size_t p_batchSize)
     {
-        if (m_batchSize < p_batchSize)
-            setBatchSize(p_batchSize);
+        ensureBatchCapacity(p_batchSize);
+        ensureMemoryPlan();
+        discardStepRecording();
         cl::Buffer currentInput = p_batchInputs;
         cl::Event lastEvent{};
-        for (auto &layer : m_layers)
+        for (size_t i = 0; i < m_layers.size(); ++i)
         {
-            lastEvent = layer->runForward(m_oclResources->getForwardBackpropQueue(), currentInput, p_batchSize);
-            currentInput = layer->getOutputs();
+            if (!isActivationFused(i))
+            {
+                lastEvent = m_layers[i]->runForward(m_oclResources->getForwardBackpropQueue(), currentInput, p_batchSize);
+            }
+            currentInput = m_layers[i]->getOutputs();
         }
         return lastEvent;
     }
 
-    double LocalNeuralNetwork::computeLossAsync(cl::Event p_forwardEvent, const std::vector<float> &p_batchTargets, const size_t p_batchSize)
+    cl::Event LocalNeuralNetwork::computeLossGradients(const cl::Buffer &p_batchTargets, const size_t p_batchSize)
     {
-        std::vector<cl::Event> waitList = {p_forwardEvent};
-        return m_lossFunction->computeLoss(m_oclResources->getConcurrentQueue(),
-                                           waitList,
-                                           m_layers.back()->getOutputs(),
-                                           p_batchTargets,
-                                           m_layers.back()->getTotalOutputElements(),
-                                           p_batchSize);
+        return computeLossGradients(p_batchTargets, p_batchSize, false);
     }
 
-    cl::Event LocalNeuralNetwork::computeLossGradients(const cl::Buffer &p_batchTargets, const size_t p_batchSize)
+    // With p_accumulateLoss the loss is added to the device sum by the same pass, where the loss function allows it.
+    cl::Event LocalNeuralNetwork::computeLossGradients(const cl::Buffer &p_batchTargets, const size_t p_batchSize, const bool p_accumulateLoss)
     {
+        checkTrainingPlan();
+        discardStepRecording();
+        if (p_accumulateLoss)
+        {
+            return m_lossFunction->computeLossGradientAndAccumulateLoss(
+                m_oclResources->getForwardBackpropQueue(),
+                m_layers.back()->getOutputs(),
+                p_batchTargets,
+                m_layers.back()->getDeltas(),
+                m_layers.back()->getTotalOutputElements(),
+                p_batchSize);
+        }
         return m_lossFunction->computeLossGradient(
             m_oclResources->getForwardBackpropQueue(),
             m_layers.back()->getOutputs(),
@@ -173,6 +843,7 @@ namespace NeuralNetworks::Local
 
     void LocalNeuralNetwork::uploadOutputDeltas(const std::vector<float> &p_hostGradients)
     {
+        checkTrainingPlan();
         size_t totalElements = p_hostGradients.size();
         m_oclResources->getForwardBackpropQueue().enqueueWriteBuffer(
             m_layers.back()->getDeltas(),
@@ -184,6 +855,7 @@ namespace NeuralNetworks::Local
 
     void LocalNeuralNetwork::copyOutputDeltasFromBuffer(const cl::Buffer &p_deviceGradients, const size_t p_batchSize)
     {
+        checkTrainingPlan();
         size_t totalElements = m_layers.back()->getTotalOutputElements() * p_batchSize;
         m_oclResources->getForwardBackpropQueue().enqueueCopyBuffer(
             p_deviceGradients,
@@ -197,9 +869,16 @@ namespace NeuralNetworks::Local
     {
         if (m_layers.empty())
             return;
-        if (m_batchSize < p_batchSize)
-            setBatchSize(p_batchSize);
-        std::pair<cl::Event, cl::Event> gradientEvents;
+        checkTrainingPlan();
+        ensureBatchCapacity(p_batchSize);
+        ensureMemoryPlan();
+        discardStepRecording();
+        if (m_gradientCheckpointing)
+        {
+            backwardCheckpointed(p_deltaEvent, p_batchInputs, p_batchSize);
+            return;
+        }
+        std::vector<cl::Event> gradientEvents;
         cl::Event deltaEvent = p_deltaEvent;
         for (int l = static_cast<int>(m_layers.size()) - 1; l >= 1; --l)
         {
@@ -208,8 +887,7 @@ namespace NeuralNetworks::Local
             if (currentLayer->isTrainable())
             {
                 auto &trainableLayer = static_cast<Layers::Trainable::TrainableLayer &>(*currentLayer);
-                gradientEvents = trainableLayer.computeGradients(m_oclResources->getDeltaToGradientQueue(), deltaEvent, previousLayer->getOutputs(), p_batchSize);
-                m_optimizer->updateTrainableLayer(m_oclResources->getConcurrentQueue(), gradientEvents, trainableLayer);
+                addGradientEvents(gradientEvents, trainableLayer.computeGradients(m_oclResources->getDeltaToGradientQueue(), deltaEvent, previousLayer->getOutputs(), p_batchSize));
             }
             deltaEvent = currentLayer->backpropDeltas(m_oclResources->getForwardBackpropQueue(), previousLayer->getDeltas(), p_batchSize);
         }
@@ -217,18 +895,51 @@ namespace NeuralNetworks::Local
         if (firstLayer->isTrainable())
         {
             auto &trainableLayer = static_cast<Layers::Trainable::TrainableLayer &>(*firstLayer);
-            gradientEvents = trainableLayer.computeGradients(m_oclResources->getDeltaToGradientQueue(), deltaEvent, p_batchInputs, p_batchSize);
-
-            if (m_optimizer)
-                m_optimizer->updateTrainableLayer(m_oclResources->getConcurrentQueue(), gradientEvents, trainableLayer);
+            addGradientEvents(gradientEvents, trainableLayer.computeGradients(m_oclResources->getDeltaToGradientQueue(), deltaEvent, p_batchInputs, p_batchSize));
         }
-        cl_int err = m_oclResources->getConcurrentQueue().finish();
+        applyOptimizerStep(gradientEvents, deltaEvent);
+    }
+
+    void LocalNeuralNetwork::backwardCheckpointed(cl::Event p_deltaEvent, const cl::Buffer &p_batchInputs, const size_t p_batchSize)
+    {
+        const cl::CommandQueue &forwardBackpropQueue = m_oclResources->getForwardBackpropQueue();
+        auto inputsOf = [this, &p_batchInputs](size_t p_layer) -> const cl::Buffer &
+        { return p_layer == 0 ? p_batchInputs : m_layers[p_layer - 1]->getOutputs(); };
 
-        if (err != CL_SUCCESS)
+        const std::vector<std::pair<size_t, size_t>> segments = getCheckpointSegments();
+        cl::Event deltaEvent = p_deltaEvent;
+        std::vector<cl::Event> gradientEvents;
+        for (auto segment = segments.rbegin(); segment != segments.rend(); ++segment)
         {
-            throw std::runtime_error("Failed to finish concurrent queue during backpropagation. Error code: " + std::to_string(err));
+            // The in-order queue puts the recomputation after the backprop that produced the segment's last deltas.
+            for (size_t i = segment->first; i < segment->second; ++i)
+            {
+                deltaEvent = m_layers[i]->runForward(forwardBackpropQueue, inputsOf(i), p_batchSize);
+            }
+
+            std::vector<cl::Event> segmentGradientEvents;
+            for (size_t l = segment->second + 1; l-- > segment->first;)
+            {
+                auto &currentLayer = m_layers[l];
+                if (currentLayer->isTrainable())
+                {
+                    auto &trainableLayer = static_cast<Layers::Trainable::TrainableLayer &>(*currentLayer);
+                    addGradientEvents(segmentGradientEvents, trainableLayer.computeGradients(m_oclResources->getDeltaToGradientQueue(), deltaEvent, inputsOf(l), p_batchSize));
+                }
+                if (l > 0)
+                {
+                    deltaEvent = currentLayer->backpropDeltas(forwardBackpropQueue, m_layers[l - 1]->getDeltas(), p_batchSize);
+                }
+            }
+
+            // The next segment recomputes into memory this segment's gradients may still be reading.
+            if (!segmentGradientEvents.empty())
+            {
+                m_oclResources->getSharedResources()->enqueueBarrier(forwardBackpropQueue, &segmentGradientEvents);
+            }
+            gradientEvents.insert(gradientEvents.end(), segmentGradientEvents.begin(), segmentGradientEvents.end());
         }
-        m_optimizer->step();
+        applyOptimizerStep(gradientEvents, deltaEvent);
     }
 
     LocalNeuralNetwork &LocalNeuralNetwork::addDense(const size_t p_numOutputNeurons)
@@ -244,11 +955,12 @@ namespace NeuralNetworks::Local
             inputDimensions = m_layers.back()->getOutputDimensions();
         }
         auto layerArgs = Utils::makeDenseLayerArgs(outputDimensions);
-        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng));
+        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng, getLayerExecutionMode()));
+        m_memoryPlanStale = true;
         return *this;
     }
 
-    LocalNeuralNetwork &LocalNeuralNetwork::addConvolutional(const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions, const Utils::PaddingType p_paddingType)
+    LocalNeuralNetwork &LocalNeuralNetwork::addConvolutional(const Utils::FilterDimensions &p_filterDimensions, const Utils::StrideDimensions &p_strideDimensions, const Utils::PaddingType p_paddingType, const bool p_specializeKernels)
     {
         Utils::Dimensions inputDimensions;
         if (m_layers.empty())
@@ -259,8 +971,9 @@ namespace NeuralNetworks::Local
         {
             inputDimensions = m_layers.back()->getOutputDimensions();
         }
-        auto layerArgs = Utils::makeConvolutionalLayerArgs(p_filterDimensions, p_strideDimensions, p_paddingType);
-        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng));
+        auto layerArgs = Utils::makeConvolutionalLayerArgs(p_filterDimensions, p_strideDimensions, p_paddingType, p_specializeKernels);
+        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng, getLayerExecutionMode()));
+        m_memoryPlanStale = true;
         return *this;
     }
 
@@ -276,7 +989,8 @@ namespace NeuralNetworks::Local
             inputDimensions = m_layers.back()->getOutputDimensions();
         }
         auto layerArgs = Utils::makeLeakyReLULayerArgs(p_alpha);
-        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng));
+        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng, getLayerExecutionMode()));
+        m_memoryPlanStale = true;
         return *this;
     }
 
@@ -292,7 +1006,8 @@ namespace NeuralNetworks::Local
             inputDimensions = m_layers.back()->getOutputDimensions();
         }
         auto layerArgs = Utils::makeReLULayerArgs();
-        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng));
+        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng, getLayerExecutionMode()));
+        m_memoryPlanStale = true;
         return *this;
     }
 
@@ -308,7 +1023,8 @@ namespace NeuralNetworks::Local
             inputDimensions = m_layers.back()->getOutputDimensions();
         }
         auto layerArgs = Utils::makeSigmoidLayerArgs();
-        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng));
+        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng, getLayerExecutionMode()));
+        m_memoryPlanStale = true;
         return *this;
     }
 
@@ -324,7 +1040,8 @@ namespace NeuralNetworks::Local
             inputDimensions = m_layers.back()->getOutputDimensions();
         }
         auto layerArgs = Utils::makeTanhLayerArgs();
-        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng));
+        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng, getLayerExecutionMode()));
+        m_memoryPlanStale = true;
         return *this;
     }
 
@@ -340,7 +1057,8 @@ namespace NeuralNetworks::Local
             inputDimensions = m_layers.back()->getOutputDimensions();
         }
         auto layerArgs = Utils::makeSoftmaxLayerArgs();
-        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng));
+        m_layers.emplace_back(layerArgs->createLayer(m_layers.size(), m_oclResources->getSharedResources(), inputDimensions, m_batchSize, m_rng, getLayerExecutionMode()));
+        m_memoryPlanStale = true;
         return *this;
     }
 
@@ -457,7 +1175,8 @@ namespace NeuralNetworks::Local
         return true;
     }
 
-    LocalNeuralNetwork LocalNeuralNetwork::load(std::shared_ptr<Utils::SharedResources> p_sharedResources, const std::string &p_fileName, const size_t p_batchSize)
+    LocalNeuralNetwork LocalNeuralNetwork::load(std::shared_ptr<Utils::SharedResources> p_sharedResources, const std::string &p_fileName, const size_t p_batchSize,
+                                                const Utils::ExecutionMode p_mode)
     {
         if (!std::filesystem::exists(p_fileName))
         {
@@ -466,7 +1185,7 @@ namespace NeuralNetworks::Local
         }
         Utils::OpenCLResources oclResources = Utils::OpenCLResources::createOpenCLResources(p_sharedResources);
         H5::H5File file(p_fileName, H5F_ACC_RDONLY);
-        LocalNeuralNetwork network(std::move(oclResources), file, p_batchSize);
+        LocalNeuralNetwork network(std::move(oclResources), file, p_batchSize, p_mode);
         file.close();
         return network;
     }
@@ -484,7 +1203,10 @@ namespace NeuralNetworks::Local
             layer->print(m_oclResources->getForwardBackpropQueue(), m_batchSize);
         }
         std::cout << "############################################\n";
-        std::cout << "Optimizer: \n\n";
-        m_optimizer->print();
+        if (m_optimizer)
+        {
+            std::cout << "Optimizer: \n\n";
+            m_optimizer->print();
+        }
     }
 }
\ No newline at end of file
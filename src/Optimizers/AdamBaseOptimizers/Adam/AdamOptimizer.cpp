@@ -3,7 +3,7 @@ namespace Optimizers
 {
     void AdamOptimizer::setupKernels()
     {
-        m_updateKernel = cl::Kernel(m_sharedResources->getProgram(), "adamUpdateParameters");
+        m_updateKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Optimizer), "adamUpdateParameters");
         Utils::setKernelArgs(4, m_updateKernel, m_learningRate, m_beta1, m_beta2, m_epsilon, m_weightDecayRate);
     }
 }
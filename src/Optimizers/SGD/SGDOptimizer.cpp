@@ -3,22 +3,19 @@ namespace Optimizers
 {
     void SGDOptimizer::setupKernels()
     {
-        m_updateKernel = cl::Kernel(m_sharedResources->getProgram(), "sgdUpdateParameters");
+        m_updateKernel = cl::Kernel(m_sharedResources->getProgram(Utils::KernelFamily::Optimizer), "sgdUpdateParameters");
         Utils::setKernelArgs(2, m_updateKernel, m_learningRate, m_weightDecayRate);
     }
 
     cl::Event SGDOptimizer::updateParameters(const cl::CommandQueue &p_concurrentQueue,
-                                             const cl::Event p_lastEvent,
-                                             const std::string &,
-                                             cl::Buffer &p_parameters,
-                                             cl::Buffer &p_gradients,
+                                             const std::vector<cl::Event> &p_waitList,
+                                             const cl::Buffer &p_parameters,
+                                             const cl::Buffer &p_gradients,
                                              size_t p_numElements)
     {
         Utils::setKernelArgs(m_updateKernel, p_parameters, p_gradients);
         cl::Event kernelEvent;
-        std::vector<cl::Event> eventList = {p_lastEvent};
-        p_concurrentQueue.enqueueNDRangeKernel(m_updateKernel, cl::NullRange,
-                                               cl::NDRange(p_numElements), cl::NullRange, &eventList, &kernelEvent);
+        m_sharedResources->enqueueKernel(p_concurrentQueue, m_updateKernel, cl::NDRange(p_numElements), &p_waitList, &kernelEvent);
 
         return kernelEvent;
     }
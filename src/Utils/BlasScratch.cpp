@@ -0,0 +1,102 @@
+#include "Utils/BlasScratch.hpp"
+
+namespace Utils
+{
+    BlasScratch::BlasScratch(std::shared_ptr<BufferPool> p_bufferPool)
+        : m_bufferPool(std::move(p_bufferPool))
+    {
+    }
+
+    BlasScratch::~BlasScratch()
+    {
+        m_bufferPool->release(m_forwardBackpropWorkspace);
+        m_bufferPool->release(m_deltaToGradientWorkspace, m_deltaToGradientLastUse);
+        m_bufferPool->release(m_ones);
+        m_bufferPool->release(m_columns, m_deltaToGradientLastUse);
+    }
+
+    void BlasScratch::clearRequirements()
+    {
+        m_forwardBackpropBytes = 0;
+        m_deltaToGradientBytes = 0;
+        m_onesElements = 0;
+        m_columnsBytes = 0;
+    }
+
+    void BlasScratch::allocate()
+    {
+        resize(m_forwardBackpropWorkspace, m_forwardBackpropBytes);
+        resize(m_deltaToGradientWorkspace, m_deltaToGradientBytes);
+        resize(m_columns, m_columnsBytes);
+        m_deltaToGradientLastUse = cl::Event();
+
+        size_t onesBytes = m_onesElements * sizeof(float);
+        if (m_ones() != nullptr && m_ones.getInfo<CL_MEM_SIZE>() >= onesBytes && onesBytes > 0)
+        {
+            return;
+        }
+        m_bufferPool->release(m_ones);
+        if (onesBytes > 0)
+        {
+            m_ones = m_bufferPool->acquireFilled(onesBytes, 1.0f);
+        }
+    }
+
+    size_t BlasScratch::getAllocatedBytes() const
+    {
+        size_t bytes = 0;
+        for (const cl::Buffer *buffer : {&m_forwardBackpropWorkspace, &m_deltaToGradientWorkspace, &m_ones, &m_columns})
+        {
+            if ((*buffer)() != nullptr)
+            {
+                bytes += buffer->getInfo<CL_MEM_SIZE>();
+            }
+        }
+        return bytes;
+    }
+
+    std::vector<cl::Event> BlasScratch::getDeltaToGradientWaitList(const cl::Event &p_event) const
+    {
+        std::vector<cl::Event> waitList;
+        if (p_event() != nullptr)
+        {
+            waitList.push_back(p_event);
+        }
+        if (m_deltaToGradientLastUse() != nullptr)
+        {
+            waitList.push_back(m_deltaToGradientLastUse);
+        }
+        return waitList;
+    }
+
+    size_t BlasScratch::getGemmBytes(const cl::CommandQueue &p_queue,
+                                     clblast::Transpose p_transposeA, clblast::Transpose p_transposeB,
+                                     size_t p_m, size_t p_n, size_t p_k)
+    {
+        size_t lda = p_transposeA == clblast::Transpose::kNo ? p_k : p_m;
+        size_t ldb = p_transposeB == clblast::Transpose::kNo ? p_n : p_k;
+        cl_command_queue rawQueue = p_queue.get();
+        size_t bytes = 0;
+        auto status = clblast::GemmTempBufferSize<float>(clblast::Layout::kRowMajor, p_transposeA, p_transposeB,
+                                                         p_m, p_n, p_k, 0, lda, 0, ldb, 0, p_n, &rawQueue, bytes);
+        if (status != clblast::StatusCode::kSuccess)
+        {
+            std::cerr << "Error: CLBlast temporary buffer size query failed: " << static_cast<int>(status) << std::endl;
+            throw std::runtime_error("CLBlast temporary buffer size query failed.");
+        }
+        return bytes;
+    }
+
+    void BlasScratch::resize(cl::Buffer &p_buffer, size_t p_bytes)
+    {
+        if (p_buffer() != nullptr && p_buffer.getInfo<CL_MEM_SIZE>() == BufferPool::getSizeClass(p_bytes))
+        {
+            return;
+        }
+        m_bufferPool->release(p_buffer);
+        if (p_bytes > 0)
+        {
+            p_buffer = m_bufferPool->acquire(p_bytes);
+        }
+    }
+}
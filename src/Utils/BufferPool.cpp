@@ -0,0 +1,191 @@
+#include "Utils/BufferPool.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace Utils
+{
+    BufferPool::BufferPool(const cl::Context &p_context, size_t p_arenaSize)
+        : m_context(p_context), m_arenaSize(0)
+    {
+        std::vector<cl::Device> devices = m_context.getInfo<CL_CONTEXT_DEVICES>();
+        if (devices.empty())
+        {
+            std::cerr << "Error: No devices found in the buffer pool context." << std::endl;
+            throw std::runtime_error("No devices found in the buffer pool context.");
+        }
+        m_uploadQueue = cl::CommandQueue(m_context, devices.front());
+
+        for (const auto &device : devices)
+        {
+            m_alignment = std::max<size_t>(m_alignment, device.getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>() / 8);
+            m_zeroCopy = m_zeroCopy && DeviceDiscovery::hasHostUnifiedMemory(device);
+        }
+        enableArenas(p_arenaSize);
+    }
+
+    cl::Buffer BufferPool::acquire(size_t p_bytes)
+    {
+        size_t sizeClass = getSizeClass(p_bytes);
+        FreeBuffer freeBuffer;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_freeBuffers.find(sizeClass);
+            if (it == m_freeBuffers.end() || it->second.empty())
+            {
+                return createBuffer(sizeClass);
+            }
+            freeBuffer = std::move(it->second.back());
+            it->second.pop_back();
+        }
+
+        if (freeBuffer.m_lastUse() != nullptr)
+        {
+            freeBuffer.m_lastUse.wait();
+        }
+        ++m_reused;
+        return freeBuffer.m_buffer;
+    }
+
+    cl::Buffer BufferPool::acquire(size_t p_bytes, const void *p_data)
+    {
+        cl::Buffer buffer = acquire(p_bytes);
+        if (p_bytes > 0)
+        {
+            accessHostMemory(m_uploadQueue, buffer, p_bytes, CL_MAP_WRITE_INVALIDATE_REGION,
+                             [p_data, p_bytes](void *p_mapped)
+                             { std::memcpy(p_mapped, p_data, p_bytes); });
+        }
+        return buffer;
+    }
+
+    cl::Buffer BufferPool::acquireFilled(size_t p_bytes, float p_value)
+    {
+        cl::Buffer buffer = acquire(p_bytes);
+        size_t count = p_bytes / sizeof(float);
+        if (count > 0)
+        {
+            cl::Event fillEvent;
+            m_uploadQueue.enqueueFillBuffer(buffer, p_value, 0, count * sizeof(float), nullptr, &fillEvent);
+            fillEvent.wait();
+        }
+        return buffer;
+    }
+
+    void BufferPool::release(cl::Buffer &p_buffer, const cl::Event &p_lastUse)
+    {
+        if (p_buffer() == nullptr)
+        {
+            return;
+        }
+
+        size_t size = p_buffer.getInfo<CL_MEM_SIZE>();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Buffers that did not come from the pool are only kept if they match a size class exactly.
+        if (getSizeClass(size) == size)
+        {
+            m_freeBuffers[size].push_back({std::move(p_buffer), p_lastUse});
+        }
+        p_buffer = cl::Buffer();
+    }
+
+    void BufferPool::discard(cl::Buffer &p_buffer, const cl::Event &p_lastUse)
+    {
+        if (p_buffer() == nullptr)
+        {
+            return;
+        }
+        if (p_buffer.getInfo<CL_MEM_ASSOCIATED_MEMOBJECT>()() != nullptr)
+        {
+            release(p_buffer, p_lastUse);
+            return;
+        }
+        p_buffer = cl::Buffer();
+    }
+
+    void BufferPool::trim()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_freeBuffers.clear();
+        m_arenas.clear();
+    }
+
+    void BufferPool::setZeroCopy(bool p_zeroCopy)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_zeroCopy == p_zeroCopy)
+        {
+            return;
+        }
+        // Cached buffers carry the old allocation flags.
+        m_zeroCopy = p_zeroCopy;
+        m_freeBuffers.clear();
+        m_arenas.clear();
+    }
+
+    void BufferPool::enableArenas(size_t p_arenaSize)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_arenaSize = p_arenaSize == 0 ? 0 : ((p_arenaSize + m_alignment - 1) / m_alignment) * m_alignment;
+        m_arenas.clear();
+    }
+
+    size_t BufferPool::getFreeBytes() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t bytes = 0;
+        for (const auto &[sizeClass, buffers] : m_freeBuffers)
+        {
+            bytes += sizeClass * buffers.size();
+        }
+        return bytes;
+    }
+
+    void BufferPool::printStats() const
+    {
+        std::cout << "Buffer pool: " << getCreatedCount() << " created (" << (getCreatedBytes() >> 10) << " KiB), "
+                  << getReusedCount() << " reused, " << (getFreeBytes() >> 10) << " KiB free";
+        if (m_arenaSize > 0)
+        {
+            std::cout << ", " << (m_arenaSize >> 10) << " KiB arenas";
+        }
+        std::cout << std::endl;
+    }
+
+    size_t BufferPool::getSizeClass(size_t p_bytes)
+    {
+        if (p_bytes <= MIN_SIZE_CLASS)
+        {
+            return MIN_SIZE_CLASS;
+        }
+
+        size_t power = MIN_SIZE_CLASS;
+        while (power * 2 < p_bytes)
+        {
+            power *= 2;
+        }
+        size_t step = power / 4;
+        return ((p_bytes + step - 1) / step) * step;
+    }
+
+    cl::Buffer BufferPool::createBuffer(size_t p_sizeClass)
+    {
+        ++m_created;
+        if (m_arenaSize == 0 || p_sizeClass > getArenaThreshold())
+        {
+            m_createdBytes += p_sizeClass;
+            return cl::Buffer(m_context, getMemFlags(), p_sizeClass);
+        }
+
+        size_t alignedSize = ((p_sizeClass + m_alignment - 1) / m_alignment) * m_alignment;
+        if (m_arenas.empty() || m_arenas.back().m_used + alignedSize > m_arenaSize)
+        {
+            m_arenas.push_back({cl::Buffer(m_context, getMemFlags(), m_arenaSize), 0});
+            m_createdBytes += m_arenaSize;
+        }
+
+        Arena &arena = m_arenas.back();
+        cl_buffer_region region = {arena.m_used, p_sizeClass};
+        arena.m_used += alignedSize;
+        return arena.m_buffer.createSubBuffer(CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region);
+    }
+}
@@ -0,0 +1,222 @@
+#include "Utils/CLBlastTuner.hpp"
+#include <chrono>
+#include <set>
+#include <sstream>
+
+namespace Utils
+{
+    CLBlastTuner::CLBlastTuner(const std::string &p_databaseFile)
+        : m_databaseFile(p_databaseFile)
+    {
+        load();
+    }
+
+    void CLBlastTuner::tune(const cl::CommandQueue &p_queue, const std::vector<BlasShape> &p_shapes, double p_fraction)
+    {
+        cl::Device device = p_queue.getInfo<CL_QUEUE_DEVICE>();
+        std::string deviceKey = getDeviceKey(device);
+        std::set<BlasShape> shapes(p_shapes.begin(), p_shapes.end());
+
+        for (const auto &shape : shapes)
+        {
+            if (isTuned(device, shape))
+            {
+                continue;
+            }
+
+            std::cout << "Tuning CLBlast " << shape.m_kernel << " for " << shape.m_m << "x" << shape.m_n << "x" << shape.m_k << "..." << std::endl;
+            std::unordered_map<std::string, size_t> parameters;
+            cl_command_queue rawQueue = p_queue.get();
+            clblast::StatusCode status = runTuner(rawQueue, shape, p_fraction, parameters);
+            if (status != clblast::StatusCode::kSuccess || parameters.empty())
+            {
+                std::cerr << "Warning: CLBlast tuner for " << shape.m_kernel << " failed with status "
+                          << static_cast<int>(status) << ", keeping the default parameters.\n";
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries[deviceKey + "\t" + shape.toString()] = {shape, std::move(parameters)};
+            saveLocked();
+        }
+
+        apply(device, p_shapes);
+    }
+
+    void CLBlastTuner::apply(const cl::Device &p_device, const std::vector<BlasShape> &p_shapes) const
+    {
+        std::string devicePrefix = getDeviceKey(p_device) + "\t";
+        std::set<std::string> wanted;
+        for (const auto &shape : p_shapes)
+        {
+            wanted.insert(shape.toString());
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::map<std::string, const TunedParameters *> selected;
+        for (const auto &[key, entry] : m_entries)
+        {
+            if (key.compare(0, devicePrefix.size(), devicePrefix) != 0)
+            {
+                continue;
+            }
+            if (!wanted.empty() && wanted.count(entry.m_shape.toString()) == 0)
+            {
+                continue;
+            }
+
+            const TunedParameters *&current = selected[entry.m_shape.m_kernel];
+            if (!current || entry.m_shape.getWork() > current->m_shape.getWork())
+            {
+                current = &entry;
+            }
+        }
+
+        for (const auto &[kernel, entry] : selected)
+        {
+            clblast::StatusCode status = clblast::OverrideParameters(p_device(), kernel, clblast::Precision::kSingle, entry->m_parameters);
+            if (status != clblast::StatusCode::kSuccess)
+            {
+                std::cerr << "Warning: Could not override CLBlast parameters for " << kernel << " (status "
+                          << static_cast<int>(status) << ").\n";
+            }
+        }
+    }
+
+    bool CLBlastTuner::isTuned(const cl::Device &p_device, const BlasShape &p_shape) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.count(getDeviceKey(p_device) + "\t" + p_shape.toString()) > 0;
+    }
+
+    size_t CLBlastTuner::getEntryCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    std::string CLBlastTuner::getDeviceKey(const cl::Device &p_device)
+    {
+        return p_device.getInfo<CL_DEVICE_NAME>() + " " + p_device.getInfo<CL_DRIVER_VERSION>();
+    }
+
+    clblast::StatusCode CLBlastTuner::runTuner(cl_command_queue p_queue, const BlasShape &p_shape, double p_fraction,
+                                               std::unordered_map<std::string, size_t> &p_parameters)
+    {
+        // CLBlast has no public tuner for Xconvgemm; it shares the XgemmDirect parameter set, so the
+        // implied per-image GEMM is tuned with the XgemmDirect tuner instead.
+        if (p_shape.m_kernel == "Xgemm")
+        {
+            return clblast::TuneXgemm<float>(&p_queue, p_shape.m_m, p_shape.m_n, p_shape.m_k, p_fraction, p_parameters);
+        }
+        if (p_shape.m_kernel == "XgemmDirect" || p_shape.m_kernel == "Xconvgemm")
+        {
+            return clblast::TuneXgemmDirect<float>(&p_queue, p_shape.m_m, p_shape.m_n, p_shape.m_k, p_fraction, p_parameters);
+        }
+        if (p_shape.m_kernel == "Xgemv")
+        {
+            return clblast::TuneXgemv<float>(&p_queue, p_shape.m_m, p_shape.m_n, p_fraction, p_parameters);
+        }
+        std::cerr << "Error: No CLBlast tuner for kernel " << p_shape.m_kernel << "." << std::endl;
+        throw std::invalid_argument("Unsupported CLBlast kernel: " + p_shape.m_kernel);
+    }
+
+    void CLBlastTuner::load()
+    {
+        if (m_databaseFile.empty())
+        {
+            return;
+        }
+
+        std::ifstream file(m_databaseFile);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::vector<std::string> fields;
+            std::stringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, '\t'))
+            {
+                fields.push_back(field);
+            }
+            if (fields.size() != 4)
+            {
+                continue;
+            }
+
+            TunedParameters entry;
+            entry.m_shape.m_kernel = fields[1];
+            char separator;
+            std::stringstream sizes(fields[2]);
+            sizes >> entry.m_shape.m_m >> separator >> entry.m_shape.m_n >> separator >> entry.m_shape.m_k;
+
+            // An entry with a malformed value is skipped as a whole; its shape is simply tuned again.
+            std::stringstream parameters(fields[3]);
+            std::string parameter;
+            bool malformed = false;
+            while (!malformed && std::getline(parameters, parameter, ';'))
+            {
+                size_t equals = parameter.find('=');
+                if (equals != std::string::npos)
+                {
+                    try
+                    {
+                        entry.m_parameters[parameter.substr(0, equals)] = std::stoull(parameter.substr(equals + 1));
+                    }
+                    catch (const std::logic_error &)
+                    {
+                        malformed = true;
+                    }
+                }
+            }
+            if (!malformed && !sizes.fail() && !entry.m_parameters.empty())
+            {
+                m_entries[fields[0] + "\t" + entry.m_shape.toString()] = std::move(entry);
+            }
+        }
+    }
+
+    void CLBlastTuner::saveLocked() const
+    {
+        if (m_databaseFile.empty())
+        {
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::path path(m_databaseFile);
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        {
+            std::ofstream file(temporaryPath, std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "Warning: Could not write CLBlast tuning database " << m_databaseFile << "\n";
+                return;
+            }
+            for (const auto &[key, entry] : m_entries)
+            {
+                file << key << "\t";
+                std::map<std::string, size_t> sorted(entry.m_parameters.begin(), entry.m_parameters.end());
+                bool first = true;
+                for (const auto &[name, value] : sorted)
+                {
+                    file << (first ? "" : ";") << name << "=" << value;
+                    first = false;
+                }
+                file << "\n";
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+        }
+    }
+}
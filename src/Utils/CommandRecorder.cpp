@@ -0,0 +1,103 @@
+#include "Utils/CommandRecorder.hpp"
+
+namespace Utils
+{
+    void CommandRecorder::clear()
+    {
+        m_commands.clear();
+        m_producers.clear();
+        m_provisional = false;
+    }
+
+    void CommandRecorder::recordKernel(const cl::CommandQueue &p_queue, const cl::Kernel &p_kernel,
+                                       const cl::NDRange &p_global, const cl::NDRange &p_local,
+                                       const std::vector<cl::Event> *p_waitList, const cl::Event &p_event)
+    {
+        Command command;
+        command.m_type = CommandType::Kernel;
+        command.m_queue = p_queue;
+        command.m_kernel = p_kernel;
+        command.m_dimensions = static_cast<cl_uint>(p_global.dimensions());
+        command.m_hasLocal = p_local.dimensions() == p_global.dimensions();
+        for (cl_uint i = 0; i < command.m_dimensions; ++i)
+        {
+            command.m_global[i] = p_global.get()[i];
+            command.m_local[i] = command.m_hasLocal ? p_local.get()[i] : 0;
+        }
+        addCommand(std::move(command), p_waitList, p_event);
+    }
+
+    void CommandRecorder::recordBarrier(const cl::CommandQueue &p_queue, const std::vector<cl::Event> *p_waitList, const cl::Event &p_event)
+    {
+        Command command;
+        command.m_type = CommandType::Barrier;
+        command.m_queue = p_queue;
+        addCommand(std::move(command), p_waitList, p_event);
+    }
+
+    void CommandRecorder::recordRoutine(const cl::CommandQueue &p_queue, Routine p_routine, const cl::Event &p_event)
+    {
+        Command command;
+        command.m_type = CommandType::Routine;
+        command.m_queue = p_queue;
+        command.m_routine = std::move(p_routine);
+        addCommand(std::move(command), nullptr, p_event);
+    }
+
+    void CommandRecorder::addCommand(Command &&p_command, const std::vector<cl::Event> *p_waitList, const cl::Event &p_event)
+    {
+        if (p_waitList)
+        {
+            for (const cl::Event &event : *p_waitList)
+            {
+                auto producer = m_producers.find(event());
+                if (producer != m_producers.end())
+                {
+                    p_command.m_dependencies.push_back(producer->second);
+                }
+            }
+        }
+        p_command.m_waitList.reserve(p_command.m_dependencies.size());
+        if (p_event() != nullptr)
+        {
+            m_producers[p_event()] = m_commands.size();
+        }
+        m_commands.push_back(std::move(p_command));
+    }
+
+    void CommandRecorder::replay()
+    {
+        for (Command &command : m_commands)
+        {
+            command.m_waitList.clear();
+            for (size_t dependency : command.m_dependencies)
+            {
+                command.m_waitList.push_back(m_commands[dependency].m_event());
+            }
+            cl_uint waitCount = static_cast<cl_uint>(command.m_waitList.size());
+            const cl_event *waitList = waitCount > 0 ? command.m_waitList.data() : nullptr;
+            cl_command_queue queue = command.m_queue();
+            cl_event event = nullptr;
+            cl_int err = CL_SUCCESS;
+            switch (command.m_type)
+            {
+            case CommandType::Kernel:
+                err = clEnqueueNDRangeKernel(queue, command.m_kernel(), command.m_dimensions, nullptr, command.m_global,
+                                             command.m_hasLocal ? command.m_local : nullptr, waitCount, waitList, &event);
+                break;
+            case CommandType::Barrier:
+                err = clEnqueueBarrierWithWaitList(queue, waitCount, waitList, &event);
+                break;
+            case CommandType::Routine:
+                event = command.m_routine(queue);
+                break;
+            }
+            if (err != CL_SUCCESS)
+            {
+                std::cerr << "Error: Replaying recorded command failed with error code " << err << "." << std::endl;
+                throw std::runtime_error("Failed to replay recorded command. Error code: " + std::to_string(err));
+            }
+            command.m_event = cl::Event(event);
+        }
+    }
+}
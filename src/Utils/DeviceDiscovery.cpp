@@ -0,0 +1,170 @@
+#include "Utils/DeviceDiscovery.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace Utils
+{
+    std::string DeviceCapabilities::getTypeName() const
+    {
+        if (m_type & CL_DEVICE_TYPE_GPU)
+        {
+            return "GPU";
+        }
+        if (m_type & CL_DEVICE_TYPE_ACCELERATOR)
+        {
+            return "Accelerator";
+        }
+        if (m_type & CL_DEVICE_TYPE_CPU)
+        {
+            return "CPU";
+        }
+        return "Other";
+    }
+
+    std::string DeviceCapabilities::toString() const
+    {
+        std::ostringstream oss;
+        oss << "[" << m_platformIndex << ":" << m_deviceIndex << "] " << getTypeName() << ", " << m_name
+            << " (" << m_platformName << ")"
+            << " | CUs: " << m_computeUnits
+            << " | Global: " << (m_globalMemory >> 20) << " MiB"
+            << " | Local: " << (m_localMemory >> 10) << " KiB"
+            << " | Max alloc: " << (m_maxAllocation >> 20) << " MiB"
+            << " | FP16: " << (m_fp16 ? "yes" : "no")
+            << " | Unified memory: " << (m_hostUnifiedMemory ? "yes" : "no")
+            << " | Score: " << m_score;
+        return oss.str();
+    }
+
+    std::vector<DeviceCapabilities> DeviceDiscovery::enumerateDevices(cl_device_type p_deviceType)
+    {
+        std::vector<cl::Platform> platforms;
+        cl::Platform::get(&platforms);
+
+        std::vector<DeviceCapabilities> devices;
+        for (size_t platformIndex = 0; platformIndex < platforms.size(); ++platformIndex)
+        {
+            std::vector<cl::Device> platformDevices;
+            try
+            {
+                platforms[platformIndex].getDevices(p_deviceType, &platformDevices);
+            }
+            catch (const cl::Error &)
+            {
+                continue;
+            }
+
+            for (size_t deviceIndex = 0; deviceIndex < platformDevices.size(); ++deviceIndex)
+            {
+                if (!platformDevices[deviceIndex].getInfo<CL_DEVICE_AVAILABLE>())
+                {
+                    continue;
+                }
+                devices.push_back(queryCapabilities(platforms[platformIndex], platformDevices[deviceIndex], platformIndex, deviceIndex));
+            }
+        }
+
+        std::stable_sort(devices.begin(), devices.end(),
+                         [](const DeviceCapabilities &a, const DeviceCapabilities &b)
+                         {
+                             return a.m_score > b.m_score;
+                         });
+        return devices;
+    }
+
+    DeviceCapabilities DeviceDiscovery::selectBestDevice(cl_device_type p_deviceType)
+    {
+        std::vector<DeviceCapabilities> devices = enumerateDevices(p_deviceType);
+        if (devices.empty())
+        {
+            std::cerr << "Error: No available OpenCL devices found." << std::endl;
+            throw std::runtime_error("No available OpenCL devices found. Please ensure OpenCL drivers are installed.");
+        }
+        return devices.front();
+    }
+
+    std::vector<DeviceCapabilities> DeviceDiscovery::selectBestPlatformDevices(cl_device_type p_deviceType)
+    {
+        std::vector<DeviceCapabilities> devices = enumerateDevices(p_deviceType);
+        if (devices.empty())
+        {
+            std::cerr << "Error: No available OpenCL devices found." << std::endl;
+            throw std::runtime_error("No available OpenCL devices found. Please ensure OpenCL drivers are installed.");
+        }
+
+        size_t bestPlatform = devices.front().m_platformIndex;
+        devices.erase(std::remove_if(devices.begin(), devices.end(),
+                                     [bestPlatform](const DeviceCapabilities &device)
+                                     {
+                                         return device.m_platformIndex != bestPlatform;
+                                     }),
+                      devices.end());
+        return devices;
+    }
+
+    DeviceCapabilities DeviceDiscovery::queryCapabilities(const cl::Platform &p_platform, const cl::Device &p_device,
+                                                          size_t p_platformIndex, size_t p_deviceIndex)
+    {
+        DeviceCapabilities capabilities;
+        capabilities.m_platform = p_platform;
+        capabilities.m_device = p_device;
+        capabilities.m_platformIndex = p_platformIndex;
+        capabilities.m_deviceIndex = p_deviceIndex;
+        capabilities.m_platformName = p_platform.getInfo<CL_PLATFORM_NAME>();
+        capabilities.m_name = p_device.getInfo<CL_DEVICE_NAME>();
+        capabilities.m_vendor = p_device.getInfo<CL_DEVICE_VENDOR>();
+        capabilities.m_type = p_device.getInfo<CL_DEVICE_TYPE>();
+        capabilities.m_computeUnits = p_device.getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
+        capabilities.m_maxClockFrequency = p_device.getInfo<CL_DEVICE_MAX_CLOCK_FREQUENCY>();
+        capabilities.m_globalMemory = p_device.getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>();
+        capabilities.m_localMemory = p_device.getInfo<CL_DEVICE_LOCAL_MEM_SIZE>();
+        capabilities.m_maxAllocation = p_device.getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>();
+        capabilities.m_fp16 = p_device.getInfo<CL_DEVICE_EXTENSIONS>().find("cl_khr_fp16") != std::string::npos;
+        capabilities.m_hostUnifiedMemory = hasHostUnifiedMemory(p_device);
+        capabilities.m_score = scoreDevice(capabilities);
+        return capabilities;
+    }
+
+    double DeviceDiscovery::scoreDevice(const DeviceCapabilities &p_capabilities)
+    {
+        const double mebibyte = 1024.0 * 1024.0;
+        const double kibibyte = 1024.0;
+
+        // A GPU compute unit carries far more lanes than a CPU core, so compute units are weighted by device type.
+        double typeWeight = 1.0;
+        if (p_capabilities.m_type & CL_DEVICE_TYPE_GPU)
+        {
+            typeWeight = 4.0;
+        }
+        else if (p_capabilities.m_type & CL_DEVICE_TYPE_ACCELERATOR)
+        {
+            typeWeight = 2.0;
+        }
+
+        double score = 10.0 * typeWeight * std::log2(1.0 + p_capabilities.m_computeUnits);
+        score += 4.0 * std::log2(1.0 + p_capabilities.m_globalMemory / mebibyte);
+        score += 2.0 * std::log2(1.0 + p_capabilities.m_localMemory / kibibyte);
+        score += 2.0 * std::log2(1.0 + p_capabilities.m_maxAllocation / mebibyte);
+        if (p_capabilities.m_fp16)
+        {
+            score += 5.0;
+        }
+        return score;
+    }
+
+    bool DeviceDiscovery::hasHostUnifiedMemory(const cl::Device &p_device)
+    {
+        return (p_device.getInfo<CL_DEVICE_TYPE>() & CL_DEVICE_TYPE_CPU) || p_device.getInfo<CL_DEVICE_HOST_UNIFIED_MEMORY>();
+    }
+
+    void DeviceDiscovery::printDevices(const std::vector<DeviceCapabilities> &p_devices)
+    {
+        std::cout << "Ranked OpenCL devices (" << p_devices.size() << "):" << std::endl;
+        for (const auto &device : p_devices)
+        {
+            std::cout << "  " << device.toString() << std::endl;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include "Utils/HostMemory.hpp"
+
+namespace Utils
+{
+    bool isHostResident(const cl::Buffer &p_buffer)
+    {
+        const cl_mem_flags hostFlags = CL_MEM_ALLOC_HOST_PTR | CL_MEM_USE_HOST_PTR;
+        if (p_buffer() == nullptr)
+        {
+            return false;
+        }
+        if (p_buffer.getInfo<CL_MEM_FLAGS>() & hostFlags)
+        {
+            return true;
+        }
+        // Sub-buffers inherit the host pointer flags of their parent, but not every driver reports them.
+        cl::Memory parent = p_buffer.getInfo<CL_MEM_ASSOCIATED_MEMOBJECT>();
+        return parent() != nullptr && (parent.getInfo<CL_MEM_FLAGS>() & hostFlags);
+    }
+
+    void accessHostMemory(const cl::CommandQueue &p_queue,
+                          const cl::Buffer &p_buffer,
+                          size_t p_bytes,
+                          cl_map_flags p_flags,
+                          const std::function<void(void *)> &p_access,
+                          const std::vector<cl::Event> *p_waitList)
+    {
+        if (p_bytes == 0)
+        {
+            return;
+        }
+
+        if (isHostResident(p_buffer))
+        {
+            void *mapped = p_queue.enqueueMapBuffer(p_buffer, CL_TRUE, p_flags, 0, p_bytes, p_waitList);
+            p_access(mapped);
+            cl::Event unmapEvent;
+            p_queue.enqueueUnmapMemObject(p_buffer, mapped, nullptr, &unmapEvent);
+            unmapEvent.wait();
+            return;
+        }
+
+        std::vector<unsigned char> staging(p_bytes);
+        if (p_flags & CL_MAP_READ)
+        {
+            p_queue.enqueueReadBuffer(p_buffer, CL_TRUE, 0, p_bytes, staging.data(), p_waitList);
+        }
+        else if (p_waitList != nullptr && !p_waitList->empty())
+        {
+            cl::Event::waitForEvents(*p_waitList);
+        }
+        p_access(staging.data());
+        if (p_flags & (CL_MAP_WRITE | CL_MAP_WRITE_INVALIDATE_REGION))
+        {
+            p_queue.enqueueWriteBuffer(p_buffer, CL_TRUE, 0, p_bytes, staging.data());
+        }
+    }
+}
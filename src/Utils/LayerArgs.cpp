@@ -15,12 +15,14 @@ namespace Utils
     std::unique_ptr<LayerArgs> makeConvolutionalLayerArgs(
         const FilterDimensions &p_filterDimensions,
         const StrideDimensions &p_strideDimensions,
-        PaddingType p_paddingType)
+        PaddingType p_paddingType,
+        bool p_specializeKernels)
     {
         return std::make_unique<ConvolutionalLayerArgs>(
             p_filterDimensions,
             p_strideDimensions,
-            p_paddingType);
+            p_paddingType,
+            p_specializeKernels);
     }
 
     std::unique_ptr<LayerArgs> makeReLULayerArgs()
@@ -51,7 +53,8 @@ namespace Utils
 
     std::unique_ptr<Layers::Layer> loadLayer(std::shared_ptr<Utils::SharedResources> p_sharedResources,
                                              const H5::Group &p_layerGroup,
-                                             const size_t p_batchSize)
+                                             const size_t p_batchSize,
+                                             const ExecutionMode p_mode)
     {
         unsigned int layerType;
         p_layerGroup.openAttribute("layerType").read(H5::PredType::NATIVE_UINT, &layerType);
@@ -59,19 +62,19 @@ namespace Utils
         switch (layerTypeFromUint(layerType))
         {
         case LayerType::Dense:
-            return std::make_unique<Layers::Trainable::DenseLayer>(p_sharedResources, p_layerGroup, p_batchSize);
+            return std::make_unique<Layers::Trainable::DenseLayer>(p_sharedResources, p_layerGroup, p_batchSize, p_mode);
         case LayerType::Convolutional:
-            return std::make_unique<Layers::Trainable::ConvolutionalLayer>(p_sharedResources, p_layerGroup, p_batchSize);
+            return std::make_unique<Layers::Trainable::ConvolutionalLayer>(p_sharedResources, p_layerGroup, p_batchSize, p_mode);
         case LayerType::ReLU:
-            return std::make_unique<Layers::Activation::ReLULayer>(p_sharedResources, p_layerGroup, p_batchSize);
+            return std::make_unique<Layers::Activation::ReLULayer>(p_sharedResources, p_layerGroup, p_batchSize, p_mode);
         case LayerType::LeakyReLU:
-            return std::make_unique<Layers::Activation::LeakyReLULayer>(p_sharedResources, p_layerGroup, p_batchSize);
+            return std::make_unique<Layers::Activation::LeakyReLULayer>(p_sharedResources, p_layerGroup, p_batchSize, p_mode);
         case LayerType::Sigmoid:
-            return std::make_unique<Layers::Activation::SigmoidLayer>(p_sharedResources, p_layerGroup, p_batchSize);
+            return std::make_unique<Layers::Activation::SigmoidLayer>(p_sharedResources, p_layerGroup, p_batchSize, p_mode);
         case LayerType::Tanh:
-            return std::make_unique<Layers::Activation::TanhLayer>(p_sharedResources, p_layerGroup, p_batchSize);
+            return std::make_unique<Layers::Activation::TanhLayer>(p_sharedResources, p_layerGroup, p_batchSize, p_mode);
         case LayerType::Softmax:
-            return std::make_unique<Layers::Activation::SoftmaxLayer>(p_sharedResources, p_layerGroup, p_batchSize);
+            return std::make_unique<Layers::Activation::SoftmaxLayer>(p_sharedResources, p_layerGroup, p_batchSize, p_mode);
         default:
             throw std::runtime_error("Unsupported layer type: " + std::to_string(layerType));
         }
@@ -0,0 +1,134 @@
+#include "Utils/MemoryPlanner.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace Utils
+{
+    MemoryPlanner::MemoryPlanner(size_t p_alignment)
+        : m_alignment(std::max<size_t>(p_alignment, 1))
+    {
+    }
+
+    size_t MemoryPlanner::addTensor(size_t p_bytes, size_t p_firstStep, size_t p_lastStep)
+    {
+        if (p_lastStep < p_firstStep)
+        {
+            std::cerr << "Error: Tensor lifetime ends at step " << p_lastStep << " before it starts at step " << p_firstStep << "." << std::endl;
+            throw std::invalid_argument("Tensor lifetime ends before it starts.");
+        }
+        m_tensors.push_back({p_bytes, {{p_firstStep, p_lastStep}}, 0});
+        m_planned = false;
+        return m_tensors.size() - 1;
+    }
+
+    // Extends the most recently added live range of the tensor.
+    void MemoryPlanner::extendLifetime(size_t p_tensor, size_t p_step)
+    {
+        getTensor(p_tensor);
+        std::pair<size_t, size_t> &range = m_tensors[p_tensor].m_ranges.back();
+        range.first = std::min(range.first, p_step);
+        range.second = std::max(range.second, p_step);
+        m_planned = false;
+    }
+
+    void MemoryPlanner::addLiveRange(size_t p_tensor, size_t p_firstStep, size_t p_lastStep)
+    {
+        getTensor(p_tensor);
+        if (p_lastStep < p_firstStep)
+        {
+            std::cerr << "Error: Live range ends at step " << p_lastStep << " before it starts at step " << p_firstStep << "." << std::endl;
+            throw std::invalid_argument("Tensor lifetime ends before it starts.");
+        }
+        m_tensors[p_tensor].m_ranges.push_back({p_firstStep, p_lastStep});
+        m_planned = false;
+    }
+
+    void MemoryPlanner::plan()
+    {
+        std::vector<size_t> order(m_tensors.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [this](size_t a, size_t b)
+                         { return m_tensors[a].m_bytes > m_tensors[b].m_bytes; });
+
+        m_arenaSize = 0;
+        std::vector<size_t> placed;
+        for (size_t index : order)
+        {
+            Tensor &tensor = m_tensors[index];
+            std::vector<const Tensor *> live;
+            for (size_t other : placed)
+            {
+                const Tensor &candidate = m_tensors[other];
+                if (liveTogether(candidate, tensor))
+                {
+                    live.push_back(&candidate);
+                }
+            }
+            std::sort(live.begin(), live.end(),
+                      [](const Tensor *a, const Tensor *b)
+                      { return a->m_offset < b->m_offset; });
+
+            size_t offset = 0;
+            for (const Tensor *other : live)
+            {
+                if (offset + tensor.m_bytes <= other->m_offset)
+                {
+                    break;
+                }
+                offset = std::max(offset, alignUp(other->m_offset + other->m_bytes));
+            }
+
+            tensor.m_offset = offset;
+            m_arenaSize = std::max(m_arenaSize, offset + tensor.m_bytes);
+            placed.push_back(index);
+        }
+        m_planned = true;
+    }
+
+    size_t MemoryPlanner::getOffset(size_t p_tensor) const
+    {
+        const Tensor &tensor = getTensor(p_tensor);
+        if (!m_planned)
+        {
+            std::cerr << "Error: Memory plan was not computed before querying offsets." << std::endl;
+            throw std::runtime_error("Memory plan was not computed before querying offsets.");
+        }
+        return tensor.m_offset;
+    }
+
+    size_t MemoryPlanner::getUnplannedSize() const
+    {
+        size_t bytes = 0;
+        for (const auto &tensor : m_tensors)
+        {
+            bytes += alignUp(tensor.m_bytes);
+        }
+        return bytes;
+    }
+
+    bool MemoryPlanner::liveTogether(const Tensor &p_first, const Tensor &p_second)
+    {
+        for (const auto &[firstStart, firstEnd] : p_first.m_ranges)
+        {
+            for (const auto &[secondStart, secondEnd] : p_second.m_ranges)
+            {
+                if (firstStart <= secondEnd && secondStart <= firstEnd)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    const MemoryPlanner::Tensor &MemoryPlanner::getTensor(size_t p_tensor) const
+    {
+        if (p_tensor >= m_tensors.size())
+        {
+            std::cerr << "Error: Tensor index " << p_tensor << " is out of range." << std::endl;
+            throw std::out_of_range("Tensor index out of range.");
+        }
+        return m_tensors[p_tensor];
+    }
+}
@@ -0,0 +1,81 @@
+#include "Utils/MemoryTracker.hpp"
+#include <algorithm>
+
+namespace Utils
+{
+    void MemoryTracker::beginSnapshot()
+    {
+        for (auto &[key, usage] : m_usages)
+        {
+            usage.m_currentBytes = 0;
+        }
+    }
+
+    void MemoryTracker::record(size_t p_owner, MemoryRole p_role, const cl::Buffer &p_buffer, bool p_aliased)
+    {
+        if (p_buffer() == nullptr)
+        {
+            return;
+        }
+        record(p_owner, p_role, p_buffer.getInfo<CL_MEM_SIZE>(), p_aliased);
+    }
+
+    void MemoryTracker::record(size_t p_owner, MemoryRole p_role, size_t p_bytes, bool p_aliased)
+    {
+        Usage &usage = m_usages[{p_owner, p_role}];
+        usage.m_currentBytes += p_bytes;
+        usage.m_aliased = p_aliased;
+    }
+
+    void MemoryTracker::endSnapshot()
+    {
+        m_currentBytes = 0;
+        for (auto &[owner, bytes] : m_ownerBytes)
+        {
+            bytes.first = 0;
+        }
+        for (auto &[key, usage] : m_usages)
+        {
+            usage.m_peakBytes = std::max(usage.m_peakBytes, usage.m_currentBytes);
+            m_ownerBytes[key.first].first += usage.m_currentBytes;
+            if (!usage.m_aliased)
+            {
+                m_currentBytes += usage.m_currentBytes;
+            }
+        }
+        for (auto &[owner, bytes] : m_ownerBytes)
+        {
+            bytes.second = std::max(bytes.second, bytes.first);
+        }
+        m_peakBytes = std::max(m_peakBytes, m_currentBytes);
+    }
+
+    MemoryTracker::Usage MemoryTracker::getUsage(size_t p_owner, MemoryRole p_role) const
+    {
+        auto found = m_usages.find({p_owner, p_role});
+        return found == m_usages.end() ? Usage() : found->second;
+    }
+
+    size_t MemoryTracker::getCurrentBytes(size_t p_owner) const
+    {
+        auto found = m_ownerBytes.find(p_owner);
+        return found == m_ownerBytes.end() ? 0 : found->second.first;
+    }
+
+    size_t MemoryTracker::getPeakBytes(size_t p_owner) const
+    {
+        auto found = m_ownerBytes.find(p_owner);
+        return found == m_ownerBytes.end() ? 0 : found->second.second;
+    }
+
+    void MemoryTracker::printReport() const
+    {
+        std::cout << "Device memory: " << m_currentBytes << " byte(s) current, " << m_peakBytes << " byte(s) peak\n";
+        for (const auto &[key, usage] : m_usages)
+        {
+            std::cout << "  " << (key.first == NETWORK_OWNER ? std::string("network") : "layer " + std::to_string(key.first))
+                      << " " << memoryRoleToString(key.second) << ": " << usage.m_currentBytes << " current, "
+                      << usage.m_peakBytes << " peak" << (usage.m_aliased ? " (in arena)" : "") << "\n";
+        }
+    }
+}
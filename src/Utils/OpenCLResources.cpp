@@ -1,7 +1,39 @@
 #include "Utils/OpenCLResources.hpp"
+#include <cstring>
 namespace Utils
 {
-    OpenCLResources OpenCLResources::createOpenCLResources(const std::string &p_kernelsPath, size_t p_platformIndex, size_t p_deviceIndex)
+    namespace
+    {
+        std::vector<std::string> getAllKernelFiles(const std::string &p_path)
+        {
+            std::vector<std::string> filePaths;
+
+            if (std::filesystem::is_regular_file(p_path))
+            {
+                return {p_path};
+            }
+
+            if (!std::filesystem::exists(p_path) || !std::filesystem::is_directory(p_path))
+            {
+                return {};
+            }
+
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(p_path))
+            {
+                if (entry.is_regular_file() && entry.path().extension() == ".cl")
+                {
+                    filePaths.push_back(entry.path().string());
+                }
+            }
+
+            std::sort(filePaths.begin(), filePaths.end());
+
+            return filePaths;
+        }
+    }
+
+    OpenCLResources OpenCLResources::createOpenCLResources(const std::string &p_kernelsPath, size_t p_platformIndex, size_t p_deviceIndex,
+                                                           const std::string &p_programCacheDirectory)
     {
         std::vector<cl::Platform> platforms;
         cl::Platform::get(&platforms);
@@ -57,76 +89,160 @@ namespace Utils
         std::cout << "Selected device: " << device.getInfo<CL_DEVICE_NAME>() << "\n";
 
         cl::Context context(device);
-        cl::CommandQueue forwardBackpropQueue(context, device, CL_QUEUE_PROFILING_ENABLE);
-        cl::CommandQueue deltaToGradientQueue;
-        cl::CommandQueue concurrentQueue;
+        return createOpenCLResources(createSharedResources(std::move(context), p_kernelsPath, p_programCacheDirectory), 0);
+    }
 
-        cl_ulong props;
-        device.getInfo(CL_DEVICE_QUEUE_PROPERTIES, &props);
-        if (props & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)
+    OpenCLResources OpenCLResources::createOpenCLResources(const DeviceCapabilities &p_device,
+                                                           const std::string &p_kernelsPath,
+                                                           const std::string &p_programCacheDirectory)
+    {
+        return createOpenCLResources(std::vector<DeviceCapabilities>{p_device}, p_kernelsPath, p_programCacheDirectory);
+    }
+
+    OpenCLResources OpenCLResources::createOpenCLResources(const std::vector<DeviceCapabilities> &p_devices,
+                                                           const std::string &p_kernelsPath,
+                                                           const std::string &p_programCacheDirectory)
+    {
+        if (p_devices.empty())
         {
-            deltaToGradientQueue = cl::CommandQueue(context, device, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE);
-            concurrentQueue = cl::CommandQueue(context, device, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE);
+            std::cerr << "Error: No devices given to create the OpenCL context." << std::endl;
+            throw std::invalid_argument("At least one device is required to create the OpenCL context.");
         }
-        else
+
+        std::vector<cl::Device> devices;
+        for (const auto &device : p_devices)
         {
-            deltaToGradientQueue = cl::CommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE);
-            concurrentQueue = cl::CommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE);
+            if (device.m_platformIndex != p_devices.front().m_platformIndex)
+            {
+                std::cerr << "Error: Device " << device.m_name << " is not on platform " << p_devices.front().m_platformName << "." << std::endl;
+                throw std::invalid_argument("All devices of a shared context must belong to the same platform.");
+            }
+            std::cout << "Selected device: " << device.toString() << "\n";
+            devices.push_back(device.m_device);
         }
 
-        // Handle kernels safely
-        std::vector<std::string> kernelFiles = getAllKernelFiles(p_kernelsPath);
-        cl::Program::Sources sources;
+        cl::Context context(devices);
+        return createOpenCLResources(createSharedResources(std::move(context), p_kernelsPath, p_programCacheDirectory), 0);
+    }
 
-        if (kernelFiles.empty())
+    OpenCLResources OpenCLResources::createBestOpenCLResources(const std::string &p_kernelsPath,
+                                                               const std::string &p_programCacheDirectory)
+    {
+        std::vector<DeviceCapabilities> devices = DeviceDiscovery::enumerateDevices();
+        DeviceDiscovery::printDevices(devices);
+        if (devices.empty())
         {
-            std::cout << "No kernel files found or folder does not exist. Continuing without kernels." << std::endl;
-            const char *emptyKernel = "__kernel void dummy() {}";
-            sources.emplace_back(emptyKernel, strlen(emptyKernel));
+            throw std::runtime_error("No available OpenCL devices found. Please ensure OpenCL drivers are installed.");
         }
-        else
+        return createOpenCLResources(devices.front(), p_kernelsPath, p_programCacheDirectory);
+    }
+
+    std::shared_ptr<SharedResources> OpenCLResources::createSharedResources(cl::Context &&p_context,
+                                                                            const std::string &p_kernelsPath,
+                                                                            const std::string &p_programCacheDirectory)
+    {
+        std::string buildOptions = "-I " + p_kernelsPath + "/include -DCL_ENABLE_PRINTF";
+        auto programCache = std::make_shared<ProgramCache>(p_programCacheDirectory, p_kernelsPath + "/include");
+        std::string tuningFile = p_programCacheDirectory.empty() ? "" : (std::filesystem::path(p_programCacheDirectory) / "work_sizes.tsv").string();
+        auto workSizeTuner = std::make_shared<WorkSizeTuner>(tuningFile);
+        std::string blasDatabase = p_programCacheDirectory.empty() ? "" : (std::filesystem::path(p_programCacheDirectory) / "clblast_tuning.tsv").string();
+        auto blasTuner = std::make_shared<CLBlastTuner>(blasDatabase);
+        for (const auto &device : p_context.getInfo<CL_CONTEXT_DEVICES>())
+        {
+            blasTuner->apply(device);
+        }
+        return std::make_shared<SharedResources>(std::move(p_context), std::move(programCache), p_kernelsPath, buildOptions,
+                                                 std::move(workSizeTuner), std::move(blasTuner));
+    }
+
+    const cl::Program &SharedResources::getProgram(KernelFamily p_family)
+    {
+        return requestProgram(kernelFamilyToString(p_family), kernelFamilySources(p_family), "").get();
+    }
+
+    void SharedResources::buildPrograms(const std::vector<KernelFamily> &p_families)
+    {
+        std::vector<std::shared_future<cl::Program>> pending;
+        for (KernelFamily family : p_families)
         {
-            std::cout << "Found " << kernelFiles.size() << " kernel files:" << std::endl;
-            for (const auto &filePath : kernelFiles)
-            {
-                std::cout << "- " << filePath << std::endl;
-                std::ifstream file(filePath);
-                if (!file)
-                {
-                    std::cerr << "Error: Could not open kernel file: " << filePath << std::endl;
-                    continue;
-                }
-                std::string sourceCode((std::istreambuf_iterator<char>(file)),
-                                       std::istreambuf_iterator<char>());
-                sources.emplace_back(sourceCode.c_str(), sourceCode.length());
-            }
+            pending.push_back(requestProgram(kernelFamilyToString(family), kernelFamilySources(family), ""));
+        }
+        for (auto &program : pending)
+        {
+            program.get();
+        }
+        if (m_programCache)
+        {
+            m_programCache->printStats();
         }
+    }
 
-        // Create program (empty sources is fine)
-        cl::Program program(context, sources);
+    bool SharedResources::isProgramBuilt(KernelFamily p_family) const
+    {
+        std::lock_guard<std::mutex> lock(m_programsMutex);
+        return m_programs.count(kernelFamilyToString(p_family)) > 0;
+    }
 
-        if (!sources.empty())
+    const cl::Program &SharedResources::getSpecializedProgram(const std::string &p_kernelFile, const std::string &p_defines)
+    {
+        return requestProgram(p_kernelFile + "|" + p_defines, {p_kernelFile}, p_defines).get();
+    }
+
+    size_t SharedResources::getSpecializedProgramCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_programsMutex);
+        return static_cast<size_t>(std::count_if(m_programs.begin(), m_programs.end(),
+                                                 [](const auto &entry)
+                                                 { return entry.first.find('|') != std::string::npos; }));
+    }
+
+    std::shared_future<cl::Program> SharedResources::requestProgram(const std::string &p_key, const std::vector<std::string> &p_kernelSources, const std::string &p_defines)
+    {
+        std::lock_guard<std::mutex> lock(m_programsMutex);
+        auto it = m_programs.find(p_key);
+        if (it != m_programs.end())
+        {
+            return it->second;
+        }
+
+        std::shared_future<cl::Program> program = std::async(std::launch::async, &SharedResources::buildProgram, this, p_kernelSources, p_defines).share();
+        m_programs.emplace(p_key, program);
+        return program;
+    }
+
+    cl::Program SharedResources::buildProgram(const std::vector<std::string> &p_kernelSources, const std::string &p_defines) const
+    {
+        std::vector<std::string> kernelFiles;
+        for (const auto &kernelSource : p_kernelSources)
+        {
+            std::vector<std::string> files = getAllKernelFiles(m_kernelsPath + "/" + kernelSource);
+            kernelFiles.insert(kernelFiles.end(), files.begin(), files.end());
+        }
+
+        cl::Program::Sources sources;
+        if (kernelFiles.empty())
+        {
+            std::cout << "No kernel files found for " << m_kernelsPath << ". Continuing without kernels." << std::endl;
+            sources.emplace_back("__kernel void dummy() {}");
+        }
+        for (const auto &filePath : kernelFiles)
         {
-            std::string buildOptions = "-I " + p_kernelsPath + "/include -DCL_ENABLE_PRINTF";
-            cl_int buildStatus = program.build({device}, buildOptions.c_str());
-            std::string buildLog = program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device);
-            std::cerr << "Build log for device " << device.getInfo<CL_DEVICE_NAME>() << ":\n"
-                      << buildLog << std::endl;
-            if (buildStatus != CL_SUCCESS)
+            std::ifstream file(filePath);
+            if (!file)
             {
-                std::cerr << "Warning: OpenCL program build failed, continuing without kernels.\n";
+                std::cerr << "Error: Could not open kernel file: " << filePath << std::endl;
+                continue;
             }
+            sources.emplace_back((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
         }
 
-        return OpenCLResources(
-            std::move(context),
-            std::move(program),
-            std::move(forwardBackpropQueue),
-            std::move(deltaToGradientQueue),
-            std::move(concurrentQueue));
+        std::string buildOptions = p_defines.empty() ? m_buildOptions : m_buildOptions + " " + p_defines;
+        std::shared_ptr<ProgramCache> programCache = m_programCache ? m_programCache : std::make_shared<ProgramCache>("");
+        return programCache->buildProgram(m_context, m_devices, sources, buildOptions);
     }
 
-    OpenCLResources OpenCLResources::createOpenCLResources(std::shared_ptr<SharedResources> p_sharedResources)
+    OpenCLResources OpenCLResources::createOpenCLResources(std::shared_ptr<SharedResources> p_sharedResources, size_t p_deviceIndex)
     {
         if (!p_sharedResources)
         {
@@ -134,13 +250,18 @@ namespace Utils
             throw std::invalid_argument("SharedResources pointer is null.");
         }
         cl::Context context = p_sharedResources->getContext();
-        std::vector<cl::Device> devices = context.getInfo<CL_CONTEXT_DEVICES>();
+        const std::vector<cl::Device> &devices = p_sharedResources->getDevices();
         if (devices.empty())
         {
             std::cerr << "Error: No devices found in the provided context." << std::endl;
             throw std::runtime_error("No devices found in the provided context.");
         }
-        cl::Device device = devices[0];
+        if (p_deviceIndex >= devices.size())
+        {
+            std::cerr << "Error: Device index " << p_deviceIndex << " is out of range, the context has " << devices.size() << " device(s)." << std::endl;
+            throw std::out_of_range("Device index is out of range for the shared context.");
+        }
+        cl::Device device = devices[p_deviceIndex];
 
         cl::CommandQueue forwardBackpropQueue(context, device, CL_QUEUE_PROFILING_ENABLE);
         cl::CommandQueue deltaToGradientQueue;
@@ -158,7 +279,7 @@ namespace Utils
             deltaToGradientQueue = cl::CommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE);
             concurrentQueue = cl::CommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE);
         }
-        return OpenCLResources(std::move(p_sharedResources), std::move(forwardBackpropQueue), std::move(deltaToGradientQueue), std::move(concurrentQueue));
+        return OpenCLResources(std::move(p_sharedResources), std::move(device), std::move(forwardBackpropQueue), std::move(deltaToGradientQueue), std::move(concurrentQueue));
     }
 
     void OpenCLResources::print() const
@@ -178,13 +299,11 @@ namespace Utils
                 std::cout << "  Context: Invalid" << std::endl;
             }
 
-            if (m_sharedResources->getProgram()())
-            {
-                std::cout << "  Program: Valid" << std::endl;
-            }
-            else
+            for (KernelFamily family : {KernelFamily::Activation, KernelFamily::Dense, KernelFamily::Convolutional,
+                                        KernelFamily::LossFunction, KernelFamily::Optimizer})
             {
-                std::cout << "  Program: Invalid" << std::endl;
+                std::cout << "  Program " << kernelFamilyToString(family) << ": "
+                          << (m_sharedResources->isProgramBuilt(family) ? "Built" : "Not built yet") << std::endl;
             }
         }
         else
@@ -223,32 +342,10 @@ namespace Utils
 
     bool OpenCLResources::valid() const
     {
-        return m_sharedResources && m_sharedResources->getContext()() && m_sharedResources->getProgram()() &&
+        return m_sharedResources && m_sharedResources->getContext()() &&
                m_forwardBackpropQueue() && m_deltaToGradientQueue() && m_concurrentQueue();
     }
 
-    std::vector<std::string> OpenCLResources::getAllKernelFiles(const std::string &p_folderPath)
-    {
-        std::vector<std::string> filePaths;
-
-        if (!std::filesystem::exists(p_folderPath) || !std::filesystem::is_directory(p_folderPath))
-        {
-            return {};
-        }
-
-        for (const auto &entry : std::filesystem::recursive_directory_iterator(p_folderPath))
-        {
-            if (entry.is_regular_file() && entry.path().extension() == ".cl")
-            {
-                filePaths.push_back(entry.path().string());
-            }
-        }
-
-        std::sort(filePaths.begin(), filePaths.end());
-
-        return filePaths;
-    }
-
     void saveBuffer(const cl::CommandQueue &p_queue, const cl::Buffer &p_buffer, H5::Group &p_group, const std::string &p_name, size_t p_size)
     {
         if (H5Lexists(p_group.getId(), p_name.c_str(), H5P_DEFAULT))
@@ -256,25 +353,26 @@ namespace Utils
             std::cerr << "Warning: Dataset '" << p_name << "' already exists. Skipping write.\n";
             return;
         }
-        std::vector<float> host_data(p_size);
-        p_queue.enqueueReadBuffer(p_buffer, BLOCKING_READ, NO_OFFSET, p_size * sizeof(float), host_data.data());
-
         H5::DataSpace dataspace(H5S_SIMPLE);
         hsize_t dims[1] = {p_size};
         dataspace.setExtentSimple(1, dims);
 
         H5::DataSet dataset = p_group.createDataSet(p_name, H5::PredType::NATIVE_FLOAT, dataspace);
-        dataset.write(host_data.data(), H5::PredType::NATIVE_FLOAT);
+        accessHostMemory(p_queue, p_buffer, p_size * sizeof(float), CL_MAP_READ,
+                         [&dataset](void *p_hostData)
+                         { dataset.write(p_hostData, H5::PredType::NATIVE_FLOAT); });
     }
 
-    cl::Buffer loadBuffer(const cl::Context &p_context,
+    cl::Buffer loadBuffer(const std::shared_ptr<BufferPool> &p_bufferPool,
                           const H5::Group &p_layerGroup,
                           const std::string &p_bufferName,
                           size_t p_size)
     {
-        std::vector<float> data(p_size);
-        p_layerGroup.openDataSet(p_bufferName).read(data.data(), H5::PredType::NATIVE_FLOAT);
-        cl::Buffer buffer(p_context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, p_size * sizeof(float), data.data());
+        H5::DataSet dataset = p_layerGroup.openDataSet(p_bufferName);
+        cl::Buffer buffer = p_bufferPool->acquire(p_size * sizeof(float));
+        accessHostMemory(p_bufferPool->getUploadQueue(), buffer, p_size * sizeof(float), CL_MAP_WRITE_INVALIDATE_REGION,
+                         [&dataset](void *p_hostData)
+                         { dataset.read(p_hostData, H5::PredType::NATIVE_FLOAT); });
         return buffer;
     }
 
@@ -293,13 +391,27 @@ namespace Utils
     std::vector<float> readCLBuffer(const cl::CommandQueue &p_queue, const cl::Buffer &p_buffer, size_t p_size)
     {
         std::vector<float> hostData(p_size);
+        if (isHostResident(p_buffer))
+        {
+            accessHostMemory(p_queue, p_buffer, p_size * sizeof(float), CL_MAP_READ,
+                             [&hostData](void *p_mapped)
+                             { std::memcpy(hostData.data(), p_mapped, hostData.size() * sizeof(float)); });
+            return hostData;
+        }
         p_queue.enqueueReadBuffer(p_buffer, BLOCKING_READ, NO_OFFSET, p_size * sizeof(float), hostData.data());
         return hostData;
     }
 
     cl::Buffer createCLBuffer(const cl::Context &p_context, std::vector<float> &p_data)
     {
-        cl::Buffer buffer(p_context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, p_data.size() * sizeof(float), p_data.data());
+        // The copy lands in host-resident memory on unified-memory devices, so later reads map it in place.
+        cl_mem_flags flags = CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR;
+        std::vector<cl::Device> devices = p_context.getInfo<CL_CONTEXT_DEVICES>();
+        if (!devices.empty() && std::all_of(devices.begin(), devices.end(), DeviceDiscovery::hasHostUnifiedMemory))
+        {
+            flags |= CL_MEM_ALLOC_HOST_PTR;
+        }
+        cl::Buffer buffer(p_context, flags, p_data.size() * sizeof(float), p_data.data());
         return buffer;
     }
 
@@ -0,0 +1,60 @@
+#include "Utils/ParameterArena.hpp"
+
+namespace Utils
+{
+    ParameterArena::ParameterArena(const cl::Context &p_context, cl_mem_flags p_memFlags, size_t p_alignment)
+        : m_context(p_context),
+          m_memFlags(p_memFlags),
+          m_alignmentElements(std::max<size_t>(1, (p_alignment + sizeof(float) - 1) / sizeof(float)))
+    {
+    }
+
+    size_t ParameterArena::addRange(const std::string &p_id, size_t p_elements)
+    {
+        if (p_elements == 0)
+        {
+            std::cerr << "Error: Parameter range " << p_id << " is empty." << std::endl;
+            throw std::invalid_argument("Parameter ranges must hold at least one element.");
+        }
+        if (m_parameters() != nullptr)
+        {
+            std::cerr << "Error: Cannot add parameter range " << p_id << " after the arena was allocated." << std::endl;
+            throw std::runtime_error("Parameter arena is already allocated.");
+        }
+        m_ranges.push_back({p_id, m_totalElements, p_elements});
+        m_totalElements += ((p_elements + m_alignmentElements - 1) / m_alignmentElements) * m_alignmentElements;
+        return m_ranges.size() - 1;
+    }
+
+    void ParameterArena::allocate(const cl::CommandQueue &p_queue)
+    {
+        m_parameters = createBuffer(p_queue);
+        m_gradients = createBuffer(p_queue);
+    }
+
+    cl::Buffer ParameterArena::createBuffer(const cl::CommandQueue &p_queue) const
+    {
+        if (m_totalElements == 0)
+        {
+            return cl::Buffer();
+        }
+        cl::Buffer buffer(m_context, m_memFlags, m_totalElements * sizeof(float));
+        cl::Event fillEvent;
+        p_queue.enqueueFillBuffer(buffer, 0.0f, 0, m_totalElements * sizeof(float), nullptr, &fillEvent);
+        fillEvent.wait();
+        return buffer;
+    }
+
+    cl::Buffer ParameterArena::createRegion(const cl::Buffer &p_buffer, size_t p_range) const
+    {
+        if (p_range >= m_ranges.size())
+        {
+            std::cerr << "Error: Parameter range " << p_range << " out of range (" << m_ranges.size() << " ranges)." << std::endl;
+            throw std::out_of_range("Parameter range index out of range.");
+        }
+        const Range &range = m_ranges[p_range];
+        cl_buffer_region region = {range.m_offset * sizeof(float), range.m_elements * sizeof(float)};
+        cl::Buffer parent = p_buffer;
+        return parent.createSubBuffer(CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region);
+    }
+}
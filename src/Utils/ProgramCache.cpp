@@ -0,0 +1,257 @@
+#include "Utils/ProgramCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+
+namespace Utils
+{
+    namespace
+    {
+        const char PROGRAM_CACHE_MAGIC[8] = {'O', 'C', 'L', 'N', 'N', 'B', 'I', 'N'};
+        const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+        const uint64_t FNV_PRIME = 1099511628211ULL;
+    }
+
+    ProgramCache::ProgramCache(const std::string &p_cacheDirectory, const std::string &p_includeDirectory)
+        : m_cacheDirectory(p_cacheDirectory)
+    {
+        m_includeHash = FNV_OFFSET_BASIS;
+        if (p_includeDirectory.empty() || !std::filesystem::is_directory(p_includeDirectory))
+        {
+            return;
+        }
+
+        std::vector<std::string> includeFiles;
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(p_includeDirectory))
+        {
+            if (entry.is_regular_file())
+            {
+                includeFiles.push_back(entry.path().string());
+            }
+        }
+        std::sort(includeFiles.begin(), includeFiles.end());
+
+        for (const auto &filePath : includeFiles)
+        {
+            std::ifstream file(filePath, std::ios::binary);
+            std::string contents((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+            m_includeHash = hashString(filePath, m_includeHash);
+            m_includeHash = hashString(contents, m_includeHash);
+        }
+    }
+
+    cl::Program ProgramCache::buildProgram(const cl::Context &p_context,
+                                           const std::vector<cl::Device> &p_devices,
+                                           const cl::Program::Sources &p_sources,
+                                           const std::string &p_buildOptions)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        std::string key;
+        cl::Program program;
+        bool loadedFromCache = false;
+
+        if (enabled())
+        {
+            key = computeKey(p_devices, p_sources, p_buildOptions);
+            cl::Program::Binaries binaries;
+            if (loadBinaries(key, p_devices.size(), binaries))
+            {
+                try
+                {
+                    program = cl::Program(p_context, p_devices, binaries);
+                    program.build(p_devices, p_buildOptions.c_str());
+                    loadedFromCache = true;
+                }
+                catch (const cl::Error &e)
+                {
+                    std::cerr << "Warning: Cached program binary " << key << " was rejected (" << e.what()
+                              << ", " << e.err() << "), rebuilding from source.\n";
+                }
+            }
+        }
+
+        if (!loadedFromCache)
+        {
+            program = cl::Program(p_context, p_sources);
+            try
+            {
+                program.build(p_devices, p_buildOptions.c_str());
+            }
+            catch (const cl::Error &)
+            {
+                printBuildLog(program, p_devices);
+                throw;
+            }
+            printBuildLog(program, p_devices);
+
+            if (enabled())
+            {
+                storeBinaries(key, program.getInfo<CL_PROGRAM_BINARIES>());
+            }
+            ++m_misses;
+        }
+        else
+        {
+            ++m_hits;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        m_buildMicroseconds += static_cast<uint64_t>(elapsed.count());
+        return program;
+    }
+
+    void ProgramCache::printStats() const
+    {
+        std::cout << "Program cache: " << getHits() << " hit(s), " << getMisses() << " miss(es), "
+                  << getBuildMilliseconds() << " ms spent building programs";
+        if (enabled())
+        {
+            std::cout << " (" << m_cacheDirectory << ")";
+        }
+        else
+        {
+            std::cout << " (cache disabled)";
+        }
+        std::cout << std::endl;
+    }
+
+    std::string ProgramCache::computeKey(const std::vector<cl::Device> &p_devices,
+                                         const cl::Program::Sources &p_sources,
+                                         const std::string &p_buildOptions) const
+    {
+        uint64_t hash = m_includeHash;
+        for (const auto &device : p_devices)
+        {
+            hash = hashString(device.getInfo<CL_DEVICE_NAME>(), hash);
+            hash = hashString(device.getInfo<CL_DEVICE_VERSION>(), hash);
+            hash = hashString(device.getInfo<CL_DRIVER_VERSION>(), hash);
+        }
+        hash = hashString(p_buildOptions, hash);
+        for (const auto &source : p_sources)
+        {
+            hash = hashString(source, hash);
+        }
+
+        std::ostringstream key;
+        key << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return key.str();
+    }
+
+    bool ProgramCache::loadBinaries(const std::string &p_key, size_t p_deviceCount, cl::Program::Binaries &p_binaries) const
+    {
+        std::filesystem::path path = std::filesystem::path(m_cacheDirectory) / (p_key + ".bin");
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        char magic[sizeof(PROGRAM_CACHE_MAGIC)];
+        uint64_t count = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char *>(&count), sizeof(count));
+        if (!file || !std::equal(magic, magic + sizeof(magic), PROGRAM_CACHE_MAGIC) || count != p_deviceCount)
+        {
+            std::cerr << "Warning: Ignoring malformed program cache entry " << path.string() << "\n";
+            return false;
+        }
+
+        p_binaries.assign(count, {});
+        for (auto &binary : p_binaries)
+        {
+            uint64_t size = 0;
+            file.read(reinterpret_cast<char *>(&size), sizeof(size));
+            if (!file || size == 0)
+            {
+                return false;
+            }
+            binary.resize(size);
+            file.read(reinterpret_cast<char *>(binary.data()), static_cast<std::streamsize>(size));
+            if (!file)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ProgramCache::storeBinaries(const std::string &p_key, const cl::Program::Binaries &p_binaries) const
+    {
+        if (p_binaries.empty() || std::any_of(p_binaries.begin(), p_binaries.end(),
+                                              [](const std::vector<unsigned char> &binary)
+                                              { return binary.empty(); }))
+        {
+            std::cerr << "Warning: Driver returned no program binaries, nothing cached.\n";
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(m_cacheDirectory, error);
+        if (error)
+        {
+            std::cerr << "Warning: Could not create program cache directory " << m_cacheDirectory
+                      << ": " << error.message() << "\n";
+            return;
+        }
+
+        std::filesystem::path path = std::filesystem::path(m_cacheDirectory) / (p_key + ".bin");
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "Warning: Could not write program cache entry " << path.string() << "\n";
+                return;
+            }
+            uint64_t count = p_binaries.size();
+            file.write(PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC));
+            file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+            for (const auto &binary : p_binaries)
+            {
+                uint64_t size = binary.size();
+                file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+                file.write(reinterpret_cast<const char *>(binary.data()), static_cast<std::streamsize>(size));
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+        }
+    }
+
+    uint64_t ProgramCache::hashBytes(const void *p_data, size_t p_size, uint64_t p_seed)
+    {
+        const unsigned char *bytes = static_cast<const unsigned char *>(p_data);
+        uint64_t hash = p_seed;
+        for (size_t i = 0; i < p_size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    uint64_t ProgramCache::hashString(const std::string &p_value, uint64_t p_seed)
+    {
+        uint64_t length = p_value.size();
+        uint64_t hash = hashBytes(&length, sizeof(length), p_seed);
+        return hashBytes(p_value.data(), p_value.size(), hash);
+    }
+
+    void ProgramCache::printBuildLog(const cl::Program &p_program, const std::vector<cl::Device> &p_devices)
+    {
+        for (const auto &device : p_devices)
+        {
+            std::string buildLog = p_program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device);
+            std::cerr << "Build log for device " << device.getInfo<CL_DEVICE_NAME>() << ":\n"
+                      << buildLog << std::endl;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include "Utils/StagingRing.hpp"
+#include "Utils/BufferPool.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace Utils
+{
+    StagingRing::StagingRing(const cl::Context &p_context, size_t p_slotCount)
+        : m_context(p_context), m_slots(std::max<size_t>(p_slotCount, 1))
+    {
+        std::vector<cl::Device> devices = m_context.getInfo<CL_CONTEXT_DEVICES>();
+        if (devices.empty())
+        {
+            std::cerr << "Error: No devices found in the staging ring context." << std::endl;
+            throw std::runtime_error("No devices found in the staging ring context.");
+        }
+        m_transferQueue = cl::CommandQueue(m_context, devices.front());
+    }
+
+    StagingRing::~StagingRing()
+    {
+        m_transferQueue.finish();
+        for (auto &slot : m_slots)
+        {
+            unmap(slot);
+        }
+        m_transferQueue.finish();
+    }
+
+    cl::Event StagingRing::upload(const cl::Buffer &p_buffer, const void *p_data, size_t p_bytes)
+    {
+        cl::Event uploadEvent;
+        if (p_bytes == 0)
+        {
+            return uploadEvent;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Slot &slot = m_slots[m_next];
+        m_next = (m_next + 1) % m_slots.size();
+        if (slot.m_lastUse() != nullptr)
+        {
+            slot.m_lastUse.wait();
+        }
+        reserve(slot, p_bytes);
+
+        std::memcpy(slot.m_host, p_data, p_bytes);
+        m_transferQueue.enqueueWriteBuffer(p_buffer, CL_FALSE, 0, p_bytes, slot.m_host, nullptr, &uploadEvent);
+        m_transferQueue.flush();
+        slot.m_lastUse = uploadEvent;
+        return uploadEvent;
+    }
+
+    size_t StagingRing::getPinnedBytes() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t bytes = 0;
+        for (const auto &slot : m_slots)
+        {
+            bytes += slot.m_bytes;
+        }
+        return bytes;
+    }
+
+    void StagingRing::reserve(Slot &p_slot, size_t p_bytes)
+    {
+        if (p_slot.m_bytes >= p_bytes)
+        {
+            return;
+        }
+        unmap(p_slot);
+        p_slot.m_bytes = BufferPool::getSizeClass(p_bytes);
+        p_slot.m_pinned = cl::Buffer(m_context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, p_slot.m_bytes);
+        p_slot.m_host = m_transferQueue.enqueueMapBuffer(p_slot.m_pinned, CL_TRUE, CL_MAP_WRITE, 0, p_slot.m_bytes);
+    }
+
+    void StagingRing::unmap(Slot &p_slot)
+    {
+        if (p_slot.m_host == nullptr)
+        {
+            return;
+        }
+        cl::Event unmapEvent;
+        m_transferQueue.enqueueUnmapMemObject(p_slot.m_pinned, p_slot.m_host, nullptr, &unmapEvent);
+        unmapEvent.wait();
+        p_slot.m_host = nullptr;
+        p_slot.m_pinned = cl::Buffer();
+        p_slot.m_bytes = 0;
+    }
+}
@@ -0,0 +1,455 @@
+#include "Utils/WorkSizeTuner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <set>
+#include <sstream>
+
+namespace Utils
+{
+    WorkSizeTuner::WorkSizeTuner(const std::string &p_tuningFile, size_t p_samplesPerCandidate)
+        : m_tuningFile(p_tuningFile), m_samplesPerCandidate(std::max<size_t>(p_samplesPerCandidate, 1))
+    {
+        load();
+    }
+
+    cl_int WorkSizeTuner::enqueue(const cl::CommandQueue &p_queue,
+                                  const cl::Kernel &p_kernel,
+                                  const cl::NDRange &p_global,
+                                  const std::vector<cl::Event> *p_waitList,
+                                  cl::Event *p_event)
+    {
+        cl::Device device = p_queue.getInfo<CL_QUEUE_DEVICE>();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        collectLocked();
+
+        std::string key = makeKey(device, p_kernel, p_global);
+        TuningEntry &entry = getEntry(key, device, p_kernel, p_global);
+        if (entry.m_tuned)
+        {
+            return p_queue.enqueueNDRangeKernel(p_kernel, cl::NullRange, p_global, toNDRange(entry.m_winner), p_waitList, p_event);
+        }
+
+        bool profiling = (p_queue.getInfo<CL_QUEUE_PROPERTIES>() & CL_QUEUE_PROFILING_ENABLE) != 0;
+        size_t candidate = nextCandidate(entry);
+        if (!m_tuningEnabled || !profiling || m_pending.size() >= MAX_PENDING_LAUNCHES || candidate >= entry.m_candidates.size())
+        {
+            return p_queue.enqueueNDRangeKernel(p_kernel, cl::NullRange, p_global, cl::NullRange, p_waitList, p_event);
+        }
+
+        cl::Event event;
+        try
+        {
+            p_queue.enqueueNDRangeKernel(p_kernel, cl::NullRange, p_global, toNDRange(entry.m_candidates[candidate]), p_waitList, &event);
+        }
+        catch (const cl::Error &e)
+        {
+            if (e.err() != CL_INVALID_WORK_GROUP_SIZE && e.err() != CL_OUT_OF_RESOURCES)
+            {
+                throw;
+            }
+            entry.m_bestNanoseconds[candidate] = std::numeric_limits<cl_ulong>::max();
+            entry.m_samples[candidate] = m_samplesPerCandidate;
+            if (nextCandidate(entry) >= entry.m_candidates.size() && std::all_of(entry.m_inFlight.begin(), entry.m_inFlight.end(), [](size_t n)
+                                                                                 { return n == 0; }))
+            {
+                finishTuning(key, entry);
+            }
+            return p_queue.enqueueNDRangeKernel(p_kernel, cl::NullRange, p_global, cl::NullRange, p_waitList, p_event);
+        }
+
+        ++entry.m_inFlight[candidate];
+        m_pending.push_back({key, candidate, event});
+        if (p_event)
+        {
+            *p_event = event;
+        }
+        return CL_SUCCESS;
+    }
+
+    cl::NDRange WorkSizeTuner::getLocalSize(const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(makeKey(p_device, p_kernel, p_global));
+        if (it == m_entries.end() || !it->second.m_tuned)
+        {
+            return cl::NullRange;
+        }
+        return toNDRange(it->second.m_winner);
+    }
+
+    bool WorkSizeTuner::isSettled(const cl::CommandQueue &p_queue, const cl::Kernel &p_kernel, const cl::NDRange &p_global)
+    {
+        bool profiling = (p_queue.getInfo<CL_QUEUE_PROPERTIES>() & CL_QUEUE_PROFILING_ENABLE) != 0;
+        if (!m_tuningEnabled || !profiling)
+        {
+            return true;
+        }
+        cl::Device device = p_queue.getInfo<CL_QUEUE_DEVICE>();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(makeKey(device, p_kernel, p_global));
+        return it != m_entries.end() && it->second.m_tuned;
+    }
+
+    size_t WorkSizeTuner::getTunedCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<size_t>(std::count_if(m_entries.begin(), m_entries.end(),
+                                                 [](const auto &entry)
+                                                 { return entry.second.m_tuned; }));
+    }
+
+    size_t WorkSizeTuner::getTuningCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<size_t>(std::count_if(m_entries.begin(), m_entries.end(),
+                                                 [](const auto &entry)
+                                                 { return !entry.second.m_tuned; }));
+    }
+
+    void WorkSizeTuner::collect()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        collectLocked();
+    }
+
+    void WorkSizeTuner::save() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        saveLocked();
+    }
+
+    void WorkSizeTuner::printStats() const
+    {
+        std::cout << "Work-size tuner: " << getTunedCount() << " tuned, " << getTuningCount() << " tuning";
+        if (!m_tuningFile.empty())
+        {
+            std::cout << " (" << m_tuningFile << ")";
+        }
+        std::cout << std::endl;
+    }
+
+    std::string WorkSizeTuner::makeKey(const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global)
+    {
+        auto deviceName = m_deviceNames.find(p_device());
+        if (deviceName == m_deviceNames.end())
+        {
+            deviceName = m_deviceNames.emplace(p_device(), p_device.getInfo<CL_DEVICE_NAME>() + " " + p_device.getInfo<CL_DRIVER_VERSION>()).first;
+        }
+
+        const size_t *global = p_global;
+        std::vector<size_t> globalSizes(global, global + p_global.dimensions());
+        return deviceName->second + "\t" + p_kernel.getInfo<CL_KERNEL_FUNCTION_NAME>() + "\t" + sizesToString(globalSizes);
+    }
+
+    WorkSizeTuner::TuningEntry &WorkSizeTuner::getEntry(const std::string &p_key, const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global)
+    {
+        auto it = m_entries.find(p_key);
+        if (it != m_entries.end())
+        {
+            return it->second;
+        }
+
+        TuningEntry entry;
+        entry.m_candidates = generateCandidates(p_device, p_kernel, p_global);
+        entry.m_bestNanoseconds.assign(entry.m_candidates.size(), std::numeric_limits<cl_ulong>::max());
+        entry.m_samples.assign(entry.m_candidates.size(), 0);
+        entry.m_inFlight.assign(entry.m_candidates.size(), 0);
+        if (entry.m_candidates.size() <= 1)
+        {
+            entry.m_tuned = true;
+        }
+        return m_entries.emplace(p_key, std::move(entry)).first->second;
+    }
+
+    size_t WorkSizeTuner::nextCandidate(const TuningEntry &p_entry) const
+    {
+        for (size_t i = 0; i < p_entry.m_candidates.size(); ++i)
+        {
+            if (p_entry.m_samples[i] + p_entry.m_inFlight[i] < m_samplesPerCandidate)
+            {
+                return i;
+            }
+        }
+        return p_entry.m_candidates.size();
+    }
+
+    void WorkSizeTuner::collectLocked()
+    {
+        std::set<std::string> touched;
+        auto remaining = std::remove_if(m_pending.begin(), m_pending.end(),
+                                        [this, &touched](PendingLaunch &p_launch)
+                                        {
+                                            cl_int status = p_launch.m_event.getInfo<CL_EVENT_COMMAND_EXECUTION_STATUS>();
+                                            if (status > CL_COMPLETE)
+                                            {
+                                                return false;
+                                            }
+
+                                            TuningEntry &entry = m_entries.at(p_launch.m_key);
+                                            --entry.m_inFlight[p_launch.m_candidate];
+                                            if (status == CL_COMPLETE)
+                                            {
+                                                EventProfile profile = EventProfiler::profileEvent(p_launch.m_event, p_launch.m_key);
+                                                entry.m_bestNanoseconds[p_launch.m_candidate] = std::min(entry.m_bestNanoseconds[p_launch.m_candidate],
+                                                                                                         profile.m_end - profile.m_start);
+                                                ++entry.m_samples[p_launch.m_candidate];
+                                            }
+                                            touched.insert(p_launch.m_key);
+                                            return true;
+                                        });
+        m_pending.erase(remaining, m_pending.end());
+
+        for (const auto &key : touched)
+        {
+            TuningEntry &entry = m_entries.at(key);
+            bool measured = std::all_of(entry.m_samples.begin(), entry.m_samples.end(),
+                                        [this](size_t p_samples)
+                                        { return p_samples >= m_samplesPerCandidate; });
+            if (!entry.m_tuned && measured)
+            {
+                finishTuning(key, entry);
+            }
+        }
+    }
+
+    void WorkSizeTuner::finishTuning(const std::string &p_key, TuningEntry &p_entry)
+    {
+        size_t best = static_cast<size_t>(std::min_element(p_entry.m_bestNanoseconds.begin(), p_entry.m_bestNanoseconds.end()) - p_entry.m_bestNanoseconds.begin());
+        p_entry.m_winner = p_entry.m_candidates[best];
+        p_entry.m_winnerNanoseconds = p_entry.m_bestNanoseconds[best];
+        p_entry.m_tuned = true;
+
+        if (m_verbose)
+        {
+            std::string kernelKey = p_key.substr(p_key.find('\t') + 1);
+            std::replace(kernelKey.begin(), kernelKey.end(), '\t', ' ');
+            std::cout << "Tuned local work size for " << kernelKey << ": " << sizesToString(p_entry.m_winner)
+                      << " (" << p_entry.m_winnerNanoseconds * 1e-6 << " ms)" << std::endl;
+        }
+        saveLocked();
+    }
+
+    void WorkSizeTuner::load()
+    {
+        if (m_tuningFile.empty())
+        {
+            return;
+        }
+
+        std::ifstream file(m_tuningFile);
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::vector<std::string> fields;
+            std::stringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, '\t'))
+            {
+                fields.push_back(field);
+            }
+            if (fields.size() != 5)
+            {
+                continue;
+            }
+
+            // A hand-edited or truncated line is skipped like a short one; that launch is simply tuned again.
+            TuningEntry entry;
+            try
+            {
+                entry.m_winner = sizesFromString(fields[3]);
+                entry.m_winnerNanoseconds = std::stoull(fields[4]);
+            }
+            catch (const std::logic_error &)
+            {
+                continue;
+            }
+            if (std::find(entry.m_winner.begin(), entry.m_winner.end(), size_t(0)) != entry.m_winner.end())
+            {
+                continue;
+            }
+            entry.m_tuned = true;
+            m_entries[fields[0] + "\t" + fields[1] + "\t" + fields[2]] = std::move(entry);
+        }
+    }
+
+    void WorkSizeTuner::saveLocked() const
+    {
+        if (m_tuningFile.empty())
+        {
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::path path(m_tuningFile);
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        std::filesystem::path temporaryPath = path;
+        temporaryPath += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        {
+            std::ofstream file(temporaryPath, std::ios::trunc);
+            if (!file)
+            {
+                std::cerr << "Warning: Could not write work-size tuning file " << m_tuningFile << "\n";
+                return;
+            }
+            for (const auto &[key, entry] : m_entries)
+            {
+                if (entry.m_tuned && entry.m_winnerNanoseconds > 0)
+                {
+                    file << key << "\t" << sizesToString(entry.m_winner) << "\t" << entry.m_winnerNanoseconds << "\n";
+                }
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(temporaryPath, error);
+        }
+    }
+
+    std::vector<std::vector<size_t>> WorkSizeTuner::generateCandidates(const cl::Device &p_device, const cl::Kernel &p_kernel, const cl::NDRange &p_global)
+    {
+        size_t dimensions = p_global.dimensions();
+        const size_t *global = p_global;
+        size_t kernelMax = p_kernel.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(p_device);
+        size_t preferredMultiple = std::max<size_t>(p_kernel.getWorkGroupInfo<CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE>(p_device), 1);
+        std::vector<size_t> maxItemSizes = p_device.getInfo<CL_DEVICE_MAX_WORK_ITEM_SIZES>();
+
+        // Local sizes must divide the global size exactly (OpenCL 1.2), so each dimension only offers its
+        // power-of-two divisors and the full extent.
+        std::vector<std::vector<size_t>> options(dimensions);
+        size_t totalGlobal = 1;
+        for (size_t d = 0; d < dimensions; ++d)
+        {
+            totalGlobal *= global[d];
+            size_t limit = std::min(kernelMax, d < maxItemSizes.size() ? maxItemSizes[d] : kernelMax);
+            for (size_t size = 1; size <= limit && size <= global[d]; size *= 2)
+            {
+                if (global[d] % size == 0)
+                {
+                    options[d].push_back(size);
+                }
+            }
+            if (global[d] <= limit && (global[d] & (global[d] - 1)) != 0)
+            {
+                options[d].push_back(global[d]);
+            }
+        }
+
+        std::vector<std::vector<size_t>> combinations = {{}};
+        for (size_t d = 0; d < dimensions; ++d)
+        {
+            std::vector<std::vector<size_t>> extended;
+            for (const auto &combination : combinations)
+            {
+                for (size_t size : options[d])
+                {
+                    std::vector<size_t> next = combination;
+                    next.push_back(size);
+                    extended.push_back(std::move(next));
+                }
+            }
+            combinations = std::move(extended);
+        }
+
+        auto product = [](const std::vector<size_t> &p_sizes)
+        {
+            size_t result = 1;
+            for (size_t size : p_sizes)
+            {
+                result *= size;
+            }
+            return result;
+        };
+
+        size_t minimumGroup = std::min(preferredMultiple, totalGlobal);
+        std::vector<std::vector<size_t>> valid;
+        for (const auto &combination : combinations)
+        {
+            size_t groupSize = product(combination);
+            if (groupSize <= kernelMax && groupSize >= minimumGroup)
+            {
+                valid.push_back(combination);
+            }
+        }
+
+        // Larger groups first; for equal sizes prefer the widest first dimension, which maps to contiguous memory.
+        std::sort(valid.begin(), valid.end(),
+                  [&product](const std::vector<size_t> &a, const std::vector<size_t> &b)
+                  {
+                      size_t productA = product(a);
+                      size_t productB = product(b);
+                      if (productA != productB)
+                      {
+                          return productA > productB;
+                      }
+                      return a > b;
+                  });
+
+        std::vector<std::vector<size_t>> candidates = {{}};
+        std::map<size_t, size_t> perGroupSize;
+        for (const auto &combination : valid)
+        {
+            if (candidates.size() >= MAX_CANDIDATES)
+            {
+                break;
+            }
+            if (perGroupSize[product(combination)]++ < 2)
+            {
+                candidates.push_back(combination);
+            }
+        }
+        return candidates;
+    }
+
+    cl::NDRange WorkSizeTuner::toNDRange(const std::vector<size_t> &p_sizes)
+    {
+        switch (p_sizes.size())
+        {
+        case 1:
+            return cl::NDRange(p_sizes[0]);
+        case 2:
+            return cl::NDRange(p_sizes[0], p_sizes[1]);
+        case 3:
+            return cl::NDRange(p_sizes[0], p_sizes[1], p_sizes[2]);
+        default:
+            return cl::NullRange;
+        }
+    }
+
+    std::string WorkSizeTuner::sizesToString(const std::vector<size_t> &p_sizes)
+    {
+        if (p_sizes.empty())
+        {
+            return "default";
+        }
+        std::string result;
+        for (size_t i = 0; i < p_sizes.size(); ++i)
+        {
+            result += (i == 0 ? "" : "x") + std::to_string(p_sizes[i]);
+        }
+        return result;
+    }
+
+    std::vector<size_t> WorkSizeTuner::sizesFromString(const std::string &p_value)
+    {
+        std::vector<size_t> sizes;
+        if (p_value == "default")
+        {
+            return sizes;
+        }
+        std::stringstream stream(p_value);
+        std::string size;
+        while (std::getline(stream, size, 'x'))
+        {
+            sizes.push_back(std::stoull(size));
+        }
+        return sizes;
+    }
+}
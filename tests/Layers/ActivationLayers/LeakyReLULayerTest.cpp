@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "Layers/ActivationLayers/PreActivationLayers/LeakyReLU/LeakyReLULayer.hpp"
+#include "Layers/ActivationLayers/PreActivationLayers/ReLU/ReLULayer.hpp"
+#include "Utils/OpenCLResources.hpp"
+#include <random>
+
+using namespace Layers::Activation;
+
+class LeakyReLULayerTest : public ::testing::Test
+{
+protected:
+    Utils::OpenCLResources ocl = Utils::OpenCLResources::createOpenCLResources();
+    std::mt19937 rng{42};
+    const size_t ELEMENTS = 37;
+    const size_t B = 3;
+
+    std::vector<float> randomVector(size_t size)
+    {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> v(size);
+        for (auto &x : v)
+            x = dist(rng);
+        return v;
+    }
+
+    void checkForwardBackward(ActivationLayer &p_layer, float p_alpha)
+    {
+        const size_t elements = p_layer.getTotalOutputElements();
+        std::vector<float> inputs = randomVector(B * elements);
+        inputs[0] = 0.0f;
+        std::vector<float> deltas = randomVector(B * elements);
+        cl::Buffer inputBuffer = Utils::createCLBuffer(ocl.getContext(), inputs);
+        cl::Buffer previousDeltas(ocl.getContext(), CL_MEM_READ_WRITE, B * elements * sizeof(float));
+        const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+
+        p_layer.runForward(queue, inputBuffer, B).wait();
+        queue.enqueueWriteBuffer(p_layer.getDeltas(), CL_TRUE, 0, deltas.size() * sizeof(float), deltas.data());
+        p_layer.backpropDeltas(queue, previousDeltas, B).wait();
+
+        std::vector<float> outputs = Utils::readBuffer1D(queue, p_layer.getOutputs(), B * elements);
+        std::vector<float> gradients = Utils::readBuffer1D(queue, previousDeltas, B * elements);
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            float x = inputs[i];
+            EXPECT_NEAR(outputs[i], x > 0.0f ? x : p_alpha * x, 1e-6);
+            EXPECT_NEAR(gradients[i], x > 0.0f ? deltas[i] : p_alpha * deltas[i], 1e-6) << "at element " << i;
+        }
+    }
+};
+
+TEST_F(LeakyReLULayerTest, ReLUBackwardFromOutputs)
+{
+    ReLULayer layer(0, ocl.getSharedResources(), Utils::Dimensions({ELEMENTS}), B);
+    EXPECT_TRUE(layer.readsOutputsInBackward());
+    EXPECT_EQ(layer.getSignMask()(), nullptr);
+    checkForwardBackward(layer, 0.0f);
+}
+
+TEST_F(LeakyReLULayerTest, PositiveAlphaBackwardFromOutputs)
+{
+    LeakyReLULayer layer(0, ocl.getSharedResources(), Utils::Dimensions({ELEMENTS}), 0.1f, B);
+    EXPECT_TRUE(layer.readsOutputsInBackward());
+    EXPECT_EQ(layer.getSignMask()(), nullptr);
+    EXPECT_TRUE(layer.isGridStride());
+    checkForwardBackward(layer, 0.1f);
+}
+
+// More vectors than the capped global size, plus a scalar tail: every work-item strides over several.
+TEST_F(LeakyReLULayerTest, VectorKernelsStrideOverLargeTensors)
+{
+    LeakyReLULayer layer(0, ocl.getSharedResources(), Utils::Dimensions({200003}), 0.2f, B);
+    ASSERT_TRUE(layer.getVectorWidth() == 1 || layer.getVectorWidth() == 4 || layer.getVectorWidth() == 8);
+    EXPECT_EQ(layer.isVectorized(), layer.getVectorWidth() > 1);
+    checkForwardBackward(layer, 0.2f);
+}
+
+TEST_F(LeakyReLULayerTest, NegativeAlphaUsesSignMask)
+{
+    LeakyReLULayer layer(0, ocl.getSharedResources(), Utils::Dimensions({ELEMENTS}), -0.5f, B);
+    EXPECT_FALSE(layer.readsOutputsInBackward());
+    ASSERT_NE(layer.getSignMask()(), nullptr);
+    EXPECT_FALSE(layer.isGridStride());
+    EXPECT_LT(layer.getSignMask().getInfo<CL_MEM_SIZE>(), B * ELEMENTS * sizeof(float));
+    checkForwardBackward(layer, -0.5f);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "Layers/ActivationLayers/Softmax/SoftmaxLayer.hpp"
+#include "Utils/OpenCLResources.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace Layers::Activation;
+
+class SoftmaxLayerTest : public ::testing::Test
+{
+protected:
+    Utils::OpenCLResources ocl = Utils::OpenCLResources::createOpenCLResources();
+    std::mt19937 rng{11};
+    const size_t B = 3;
+
+    std::vector<float> randomVector(size_t size, float scale)
+    {
+        std::uniform_real_distribution<float> dist(-scale, scale);
+        std::vector<float> v(size);
+        for (auto &x : v)
+            x = dist(rng);
+        return v;
+    }
+
+    void checkForwardBackward(SoftmaxLayer &p_layer, size_t p_classes)
+    {
+        std::vector<float> inputs = randomVector(B * p_classes, 20.0f);
+        std::vector<float> deltas = randomVector(B * p_classes, 1.0f);
+        cl::Buffer inputBuffer = Utils::createCLBuffer(ocl.getContext(), inputs);
+        cl::Buffer previousDeltas(ocl.getContext(), CL_MEM_READ_WRITE, B * p_classes * sizeof(float));
+        const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+
+        p_layer.runForward(queue, inputBuffer, B).wait();
+        queue.enqueueWriteBuffer(p_layer.getDeltas(), CL_TRUE, 0, deltas.size() * sizeof(float), deltas.data());
+        p_layer.backpropDeltas(queue, previousDeltas, B).wait();
+
+        std::vector<float> outputs = Utils::readBuffer1D(queue, p_layer.getOutputs(), B * p_classes);
+        std::vector<float> gradients = Utils::readBuffer1D(queue, previousDeltas, B * p_classes);
+        for (size_t b = 0; b < B; ++b)
+        {
+            const float *row = inputs.data() + b * p_classes;
+            float maxVal = *std::max_element(row, row + p_classes);
+            double sumExp = 0.0;
+            for (size_t c = 0; c < p_classes; ++c)
+                sumExp += std::exp(row[c] - maxVal);
+            std::vector<double> expected(p_classes);
+            double dot = 0.0;
+            for (size_t c = 0; c < p_classes; ++c)
+            {
+                expected[c] = std::exp(row[c] - maxVal) / sumExp;
+                dot += expected[c] * deltas[b * p_classes + c];
+            }
+            for (size_t c = 0; c < p_classes; ++c)
+            {
+                size_t i = b * p_classes + c;
+                EXPECT_NEAR(outputs[i], expected[c], 1e-5) << "row " << b << ", class " << c;
+                EXPECT_NEAR(gradients[i], expected[c] * (deltas[i] - dot), 1e-5) << "row " << b << ", class " << c;
+            }
+        }
+    }
+};
+
+TEST_F(SoftmaxLayerTest, NarrowRowsUseRowSerialKernels)
+{
+    const size_t classes = 10;
+    SoftmaxLayer layer(0, ocl.getSharedResources(), Utils::Dimensions({classes}), B);
+    EXPECT_FALSE(layer.usesWorkGroupKernels());
+    checkForwardBackward(layer, classes);
+}
+
+// 1001 classes leave a scalar tail after the float4 chunks and more chunks than work-items.
+TEST_F(SoftmaxLayerTest, WideRowsUseWorkGroupKernels)
+{
+    const size_t classes = 1001;
+    SoftmaxLayer layer(0, ocl.getSharedResources(), Utils::Dimensions({classes}), B);
+    EXPECT_TRUE(layer.usesWorkGroupKernels());
+    checkForwardBackward(layer, classes);
+}
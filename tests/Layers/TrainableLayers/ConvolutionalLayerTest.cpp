@@ -389,3 +389,61 @@ TEST_F(ConvolutionalLayerTest, GradientsBatch6)
     auto deltas = randomVector(6 * OC * layer.getOutputHeight() * layer.getOutputWidth());
     checkGradients(layer, inputs, deltas, 6);
 }
+
+TEST_F(ConvolutionalLayerTest, SpecializedKernelsMatchReference)
+{
+    ConvolutionalLayer specialized{1, ocl.getSharedResources(), inputDims, filterDims, strideDims, padding, B, rng, true};
+    ConvolutionalLayer twin{2, ocl.getSharedResources(), inputDims, filterDims, strideDims, padding, B, rng, true};
+    EXPECT_EQ(ocl.getSharedResources()->getSpecializedProgramCount(), 1u) << "Identical shapes should share one specialized program.";
+
+    auto inputs = randomVector(B * IC * IH * IW);
+    auto deltas = randomVector(B * OC * specialized.getOutputHeight() * specialized.getOutputWidth());
+    checkBackprop(specialized, deltas, B);
+    checkGradients(specialized, inputs, deltas, B);
+}
+
+TEST_F(ConvolutionalLayerTest, GradientsSplitAcrossBatchChunks)
+{
+    const size_t bigC = 64, bigH = 64, bigW = 64, bigB = 8;
+    ConvolutionalLayer big{3, ocl.getSharedResources(), Dimensions({bigC, bigH, bigW}), FilterDimensions(3, 3, bigC, bigC), StrideDimensions(1, 1), PaddingType::Same, bigB, rng};
+    EXPECT_EQ(big.getBlasScratch(), nullptr) << "The private columns scratch should wait for the first gradients.";
+    big.setGradientColumnsBudget(size_t(32) << 20);
+    ASSERT_LT(big.getGradientChunkSize(bigB), bigB) << "The im2col columns of the whole batch should exceed the budget.";
+
+    const size_t spatial = big.getOutputHeight() * big.getOutputWidth();
+    auto inputs = randomVector(bigB * bigC * bigH * bigW);
+    auto deltas = randomVector(bigB * bigC * spatial);
+    cl::Buffer inputBuf(ocl.getContext(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                        inputs.size() * sizeof(float), inputs.data());
+    const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+    queue.enqueueWriteBuffer(big.getDeltas(), CL_TRUE, 0, deltas.size() * sizeof(float), deltas.data());
+
+    cl::Event empty;
+    auto [wgEv, bgEv] = big.computeGradients(queue, empty, inputBuf, bigB);
+    wgEv.wait();
+    bgEv.wait();
+    EXPECT_NE(big.getBlasScratch(), nullptr);
+
+    std::vector<float> gpuW(big.getWeightsSize());
+    queue.enqueueReadBuffer(big.getWeightsGradients(), CL_TRUE, 0, gpuW.size() * sizeof(float), gpuW.data());
+
+    const int pad = static_cast<int>(big.getPaddingValues().getTop());
+    std::uniform_int_distribution<size_t> pick(0, gpuW.size() - 1);
+    for (int sample = 0; sample < 64; ++sample)
+    {
+        size_t w = pick(rng);
+        size_t fw = w % 3, fh = (w / 3) % 3, ic = (w / 9) % bigC, oc = w / (9 * bigC);
+        double expected = 0.0;
+        for (size_t b = 0; b < bigB; ++b)
+            for (size_t oh = 0; oh < bigH; ++oh)
+                for (size_t ow = 0; ow < bigW; ++ow)
+                {
+                    int ih = int(oh) - pad + int(fh);
+                    int iw = int(ow) - pad + int(fw);
+                    if (ih < 0 || ih >= int(bigH) || iw < 0 || iw >= int(bigW))
+                        continue;
+                    expected += inputs[((b * bigC + ic) * bigH + ih) * bigW + iw] * deltas[(b * bigC + oc) * spatial + oh * bigW + ow];
+                }
+        EXPECT_NEAR(gpuW[w], expected / bigB, 1e-3) << "at weight " << w;
+    }
+}
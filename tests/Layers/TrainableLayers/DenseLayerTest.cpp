@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "Layers/TrainableLayers/Dense/DenseLayer.hpp"
+#include "Optimizers/SGD/SGDOptimizer.hpp"
 #include "Utils/OpenCLResources.hpp"
 #include "Utils/Dimensions.hpp"
 #include <random>
@@ -271,3 +272,127 @@ TEST_F(DenseLayerTest, GradientsBatch8)
     auto deltas = randomVector(8 * OUT);
     checkGradients(layer, inputs, deltas, 8, IN, OUT);
 }
+
+TEST_F(DenseLayerTest, InferenceOnlySkipsTrainingBuffers)
+{
+    std::mt19937 sameSeed{123};
+    DenseLayer inferenceLayer{0,
+                              ocl.getSharedResources(),
+                              Utils::Dimensions({IN}),
+                              Utils::Dimensions({OUT}),
+                              B,
+                              sameSeed,
+                              ExecutionMode::Inference};
+
+    EXPECT_TRUE(inferenceLayer.isInferenceOnly());
+    EXPECT_EQ(inferenceLayer.getDeltas()(), nullptr);
+    EXPECT_EQ(inferenceLayer.getWeightsGradients()(), nullptr);
+    EXPECT_EQ(inferenceLayer.getBiasesGradients()(), nullptr);
+    EXPECT_EQ(inferenceLayer.getBlasScratch(), nullptr);
+
+    checkForward(inferenceLayer, randomVector(B * IN), B, IN, OUT);
+}
+
+TEST_F(DenseLayerTest, SharedBlasScratch)
+{
+    DenseLayer wideLayer{1,
+                         ocl.getSharedResources(),
+                         Utils::Dimensions({OUT}),
+                         Utils::Dimensions({4 * IN}),
+                         B,
+                         rng};
+    auto scratch = std::make_shared<BlasScratch>(ocl.getSharedResources()->getBufferPool());
+    layer.reserveBlasScratch(ocl.getForwardBackpropQueue(), *scratch, B, ExecutionMode::Training);
+    wideLayer.reserveBlasScratch(ocl.getForwardBackpropQueue(), *scratch, B, ExecutionMode::Training);
+    scratch->allocate();
+    layer.assignBlasScratch(scratch);
+    wideLayer.assignBlasScratch(scratch);
+
+    EXPECT_EQ(layer.getBlasScratch(), wideLayer.getBlasScratch());
+    ASSERT_NE(scratch->getOnes()(), nullptr);
+    EXPECT_EQ(Utils::readBuffer1D(ocl.getForwardBackpropQueue(), scratch->getOnes(), B), std::vector<float>(B, 1.0f));
+
+    checkForward(layer, randomVector(B * IN), B, IN, OUT);
+    checkBackprop(layer, randomVector(B * OUT), B, IN, OUT);
+    checkGradients(layer, randomVector(B * IN), randomVector(B * OUT), B, IN, OUT);
+
+    layer.assignBlasScratch(nullptr);
+    EXPECT_NE(layer.getBlasScratch(), scratch);
+    checkGradients(layer, randomVector(B * IN), randomVector(B * OUT), B, IN, OUT);
+}
+
+TEST_F(DenseLayerTest, BatchCapacityGrowsGeometrically)
+{
+    checkForward(layer, randomVector(9 * IN), 9, IN, OUT);
+    EXPECT_EQ(layer.getBatchSize(), 2 * B);
+    cl_mem outputs = layer.getOutputs()();
+
+    checkForward(layer, randomVector(12 * IN), 12, IN, OUT);
+    checkForward(layer, randomVector(3 * IN), 3, IN, OUT);
+    EXPECT_EQ(layer.getBatchSize(), 2 * B);
+    EXPECT_EQ(layer.getOutputs()(), outputs) << "Batches within the capacity must not reallocate.";
+}
+
+TEST_F(DenseLayerTest, PackedParametersUpdateInOneLaunch)
+{
+    const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+    const std::shared_ptr<BufferPool> &pool = ocl.getSharedResources()->getBufferPool();
+    std::vector<float> weights = layer.getWeightsCPU(queue);
+    std::vector<float> biases = layer.getBiasesCPU(queue);
+
+    ParameterArena arena(ocl.getContext(), pool->getMemFlags(), pool->getAlignment());
+    arena.addRange("0Weights", layer.getWeightsSize());
+    arena.addRange("0Biases", layer.getBiasesSize());
+    arena.allocate(queue);
+    EXPECT_GE(arena.getRanges()[1].m_offset, layer.getWeightsSize());
+    EXPECT_EQ((arena.getRanges()[1].m_offset * sizeof(float)) % pool->getAlignment(), 0u);
+    layer.assignParameterRegions(queue,
+                                 arena.createRegion(arena.getParameters(), 0), arena.createRegion(arena.getParameters(), 1),
+                                 arena.createRegion(arena.getGradients(), 0), arena.createRegion(arena.getGradients(), 1));
+    EXPECT_TRUE(layer.hasPackedParameters());
+    EXPECT_EQ(layer.getWeightsCPU(queue), weights);
+    EXPECT_EQ(layer.getBiasesCPU(queue), biases);
+
+    checkForward(layer, randomVector(B * IN), B, IN, OUT);
+    checkGradients(layer, randomVector(B * IN), randomVector(B * OUT), B, IN, OUT);
+    std::vector<float> weightsGradients = Utils::readBuffer1D(queue, layer.getWeightsGradients(), layer.getWeightsSize());
+    std::vector<float> biasesGradients = Utils::readBuffer1D(queue, layer.getBiasesGradients(), layer.getBiasesSize());
+
+    Optimizers::SGDOptimizer sgd(ocl.getSharedResources(), 0.5f, 0.0f);
+    sgd.bindParameterArena(queue, arena);
+    sgd.updateParameterArena(queue, {}, arena).wait();
+
+    std::vector<float> updatedWeights = layer.getWeightsCPU(queue);
+    std::vector<float> updatedBiases = layer.getBiasesCPU(queue);
+    for (size_t i = 0; i < weights.size(); ++i)
+        EXPECT_NEAR(updatedWeights[i], weights[i] - 0.5f * weightsGradients[i], 1e-5);
+    for (size_t i = 0; i < biases.size(); ++i)
+        EXPECT_NEAR(updatedBiases[i], biases[i] - 0.5f * biasesGradients[i], 1e-5);
+}
+
+TEST_F(DenseLayerTest, FusedActivationWritesActivatedOutputs)
+{
+    const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+    std::vector<float> inputs = randomVector(B * IN);
+    cl::Buffer inputBuf = Utils::createCLBuffer(ocl.getContext(), inputs);
+    cl::Buffer activated(ocl.getContext(), CL_MEM_READ_WRITE, B * OUT * sizeof(float));
+    auto cpu = cpuDenseForward(inputs, layer.getWeightsCPU(queue), layer.getBiasesCPU(queue), B, IN, OUT);
+
+    const std::vector<std::pair<LayerType, std::function<float(float)>>> activations = {
+        {LayerType::ReLU, [](float x) { return std::max(x, 0.0f); }},
+        {LayerType::LeakyReLU, [](float x) { return x > 0.0f ? x : 0.1f * x; }},
+        {LayerType::Sigmoid, [](float x) { return 1.0f / (1.0f + std::exp(-x)); }},
+        {LayerType::Tanh, [](float x) { return std::tanh(x); }}};
+    for (const auto &[type, activation] : activations)
+    {
+        layer.fuseActivation(type, 0.1f, activated);
+        EXPECT_TRUE(layer.hasFusedActivation());
+        layer.runForward(queue, inputBuf, B).wait();
+        std::vector<float> gpu = Utils::readBuffer1D(queue, activated, B * OUT);
+        for (size_t i = 0; i < gpu.size(); ++i)
+            EXPECT_NEAR(gpu[i], activation(cpu[i]), 1e-4) << layerTypeToString(type) << " at element " << i;
+    }
+
+    layer.clearFusedActivation();
+    checkForward(layer, inputs, B, IN, OUT);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "LossFunctions/AllLossFunctions.hpp"
+#include "Utils/OpenCLResources.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace LossFunctions;
+
+class LossFunctionTest : public ::testing::Test
+{
+protected:
+    Utils::OpenCLResources ocl = Utils::OpenCLResources::createOpenCLResources();
+    std::mt19937 rng{7};
+    const size_t CLASSES = 5;
+    const size_t B = 300;
+
+    std::vector<float> probabilities()
+    {
+        std::uniform_real_distribution<float> dist(0.01f, 0.99f);
+        std::vector<float> v(B * CLASSES);
+        for (auto &x : v)
+            x = dist(rng);
+        return v;
+    }
+
+    std::vector<float> oneHot()
+    {
+        std::uniform_int_distribution<size_t> dist(0, CLASSES - 1);
+        std::vector<float> v(B * CLASSES, 0.0f);
+        for (size_t b = 0; b < B; ++b)
+            v[b * CLASSES + dist(rng)] = 1.0f;
+        return v;
+    }
+
+    // Two accumulated batches must add up to twice the host loss of one.
+    void checkAccumulatedLoss(LossFunction &p_loss)
+    {
+        std::vector<float> predictions = probabilities();
+        std::vector<float> targets = oneHot();
+        cl::Buffer predictionBuffer = Utils::createCLBuffer(ocl.getContext(), predictions);
+        cl::Buffer targetBuffer = Utils::createCLBuffer(ocl.getContext(), targets);
+        const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+
+        std::vector<cl::Event> waitList;
+        float hostLoss = p_loss.computeLoss(queue, waitList, predictionBuffer, targets, CLASSES, B);
+
+        p_loss.resetLossSum(queue);
+        p_loss.accumulateLoss(queue, predictionBuffer, targetBuffer, CLASSES, B);
+        p_loss.accumulateLoss(queue, predictionBuffer, targetBuffer, CLASSES, B);
+        EXPECT_NEAR(p_loss.readLossSum(queue), 2.0f * hostLoss, 1e-4f * std::max(1.0f, hostLoss));
+
+        p_loss.resetLossSum(queue);
+        EXPECT_EQ(p_loss.readLossSum(queue), 0.0f);
+    }
+};
+
+TEST_F(LossFunctionTest, MeanSquaredErrorAccumulatesOnDevice)
+{
+    MeanSquaredError loss(ocl.getSharedResources());
+    checkAccumulatedLoss(loss);
+}
+
+TEST_F(LossFunctionTest, BinaryCrossEntropyAccumulatesOnDevice)
+{
+    BinaryCrossEntropy loss(ocl.getSharedResources());
+    checkAccumulatedLoss(loss);
+}
+
+TEST_F(LossFunctionTest, CategoricalCrossEntropyAccumulatesOnDevice)
+{
+    CategoricalCrossEntropy loss(ocl.getSharedResources());
+    checkAccumulatedLoss(loss);
+}
+
+TEST_F(LossFunctionTest, SoftmaxCrossEntropyAccumulatesOnDevice)
+{
+    SoftmaxCrossEntropy loss(ocl.getSharedResources());
+    checkAccumulatedLoss(loss);
+}
+
+// Rows wider than one work-group make every work-item stride over several classes.
+TEST_F(LossFunctionTest, SoftmaxCrossEntropyRowKernelMatchesHost)
+{
+    SoftmaxCrossEntropy loss(ocl.getSharedResources());
+    const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+    const size_t rows = 4;
+    std::normal_distribution<float> logitDist(0.0f, 8.0f);
+    for (size_t classes : {size_t(3), size_t(1000)})
+    {
+        std::vector<float> logits(rows * classes);
+        for (auto &x : logits)
+            x = logitDist(rng);
+        std::vector<float> targets(rows * classes, 0.0f);
+        for (size_t r = 0; r < rows; ++r)
+            targets[r * classes + (r * 7) % classes] = 1.0f;
+
+        cl::Buffer logitBuffer = Utils::createCLBuffer(ocl.getContext(), logits);
+        cl::Buffer targetBuffer = Utils::createCLBuffer(ocl.getContext(), targets);
+        cl::Buffer gradientBuffer(ocl.getContext(), CL_MEM_READ_WRITE, rows * classes * sizeof(float));
+        cl::Buffer sampleLossBuffer(ocl.getContext(), CL_MEM_READ_WRITE, rows * sizeof(float));
+        loss.computeLossGradientAndSampleLosses(queue, logitBuffer, targetBuffer, gradientBuffer, sampleLossBuffer, classes, rows).wait();
+        std::vector<float> gradients = Utils::readBuffer1D(queue, gradientBuffer, rows * classes);
+        std::vector<float> sampleLosses = Utils::readBuffer1D(queue, sampleLossBuffer, rows);
+
+        double expectedTotal = 0.0;
+        for (size_t r = 0; r < rows; ++r)
+        {
+            const float *row = logits.data() + r * classes;
+            float maxLogit = *std::max_element(row, row + classes);
+            double sumExp = 0.0;
+            for (size_t c = 0; c < classes; ++c)
+                sumExp += std::exp(row[c] - maxLogit);
+            double expectedLoss = 0.0;
+            for (size_t c = 0; c < classes; ++c)
+            {
+                double softmax = std::exp(row[c] - maxLogit) / sumExp;
+                EXPECT_NEAR(gradients[r * classes + c], softmax - targets[r * classes + c], 1e-5) << classes << " classes, row " << r << ", class " << c;
+                expectedLoss -= targets[r * classes + c] * (row[c] - maxLogit - std::log(sumExp));
+            }
+            EXPECT_NEAR(sampleLosses[r], expectedLoss, 1e-3 * std::max(1.0, expectedLoss)) << classes << " classes, row " << r;
+            expectedTotal += expectedLoss;
+        }
+
+        // The accumulated loss reads the same logits, so it must be the mean of the per-sample losses.
+        loss.resetLossSum(queue);
+        loss.accumulateLoss(queue, logitBuffer, targetBuffer, classes, rows);
+        double expectedMean = expectedTotal / rows;
+        EXPECT_NEAR(loss.readLossSum(queue), expectedMean, 1e-3 * std::max(1.0, expectedMean)) << classes << " classes";
+
+        // Training with loss reporting takes the loss from the gradient pass itself.
+        loss.resetLossSum(queue);
+        cl::Buffer fusedGradientBuffer(ocl.getContext(), CL_MEM_READ_WRITE, rows * classes * sizeof(float));
+        loss.computeLossGradientAndAccumulateLoss(queue, logitBuffer, targetBuffer, fusedGradientBuffer, classes, rows);
+        EXPECT_NEAR(loss.readLossSum(queue), expectedMean, 1e-3 * std::max(1.0, expectedMean)) << classes << " classes";
+        EXPECT_EQ(Utils::readBuffer1D(queue, fusedGradientBuffer, rows * classes), gradients);
+    }
+}
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include "NeuralNetworks/Local/LocalNeuralNetwork.hpp"
+#include "DataLoaders/AllDataLoaders.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+using NeuralNetworks::Local::LocalNeuralNetwork;
+
+class LocalNeuralNetworkTest : public ::testing::Test
+{
+protected:
+    const size_t INPUTS = 6;
+    const size_t OUTPUTS = 3;
+    const size_t B = 4;
+    const size_t SEED = 7;
+    std::mt19937 rng{42};
+
+    LocalNeuralNetwork makeNetwork(Utils::OpenCLResources &&p_oclResources)
+    {
+        LocalNeuralNetwork network(std::move(p_oclResources),
+                                   Utils::createNetworkArgs(Utils::Dimensions({INPUTS}), {}, Utils::makeAdamArgs(0.01f),
+                                                            Utils::makeMeanSquaredErrorLossFunctionArgs()),
+                                   SEED, B);
+        network.addDense(8).addReLU().addDense(OUTPUTS).addSigmoid();
+        return network;
+    }
+
+    std::vector<float> randomVector(size_t p_size)
+    {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        std::vector<float> values(p_size);
+        for (auto &value : values)
+            value = dist(rng);
+        return values;
+    }
+
+    Utils::Batch makeBatch(const LocalNeuralNetwork &p_network, std::vector<float> p_inputs, std::vector<float> p_targets)
+    {
+        const cl::Context &context = p_network.getSharedResources()->getContext();
+        return Utils::Batch(Utils::createCLBuffer(context, p_inputs), Utils::createCLBuffer(context, p_targets), p_inputs, p_targets, B,
+                            Utils::Dimensions({INPUTS}), Utils::Dimensions({OUTPUTS}));
+    }
+};
+
+TEST_F(LocalNeuralNetworkTest, TrainsAfterTuningBlasKernels)
+{
+    LocalNeuralNetwork network = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    network.planMemory(Utils::ExecutionMode::Training);
+    network.tuneBlasKernels(0.05);
+
+    Utils::Batch batch = makeBatch(network, randomVector(B * INPUTS), randomVector(B * OUTPUTS));
+    double loss = network.trainStep(batch, true);
+    EXPECT_TRUE(std::isfinite(loss));
+}
+
+// The per-layer tensors the arena replaces must be freed, not parked in the pool.
+TEST_F(LocalNeuralNetworkTest, PlanningFreesReplacedActivations)
+{
+    const size_t WIDTH = 512;
+    LocalNeuralNetwork network(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""),
+                               Utils::createNetworkArgs(Utils::Dimensions({INPUTS}), {}, Utils::makeAdamArgs(0.01f),
+                                                        Utils::makeMeanSquaredErrorLossFunctionArgs()),
+                               SEED, 64);
+    network.addDense(WIDTH).addReLU().addDense(WIDTH).addReLU().addDense(OUTPUTS);
+    const std::shared_ptr<Utils::BufferPool> &bufferPool = network.getSharedResources()->getBufferPool();
+
+    size_t freeBefore = bufferPool->getFreeBytes();
+    network.planMemory(Utils::ExecutionMode::Training);
+    size_t freeAfter = bufferPool->getFreeBytes();
+    ASSERT_GT(network.getUnplannedActivationSize(), 0u);
+    EXPECT_LT(freeAfter - std::min(freeBefore, freeAfter), network.getUnplannedActivationSize() / 4);
+}
+
+TEST_F(LocalNeuralNetworkTest, CompiledStepsMatchUncompiledTraining)
+{
+    LocalNeuralNetwork eager = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    LocalNeuralNetwork compiled = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    eager.getSharedResources()->getWorkSizeTuner()->setTuningEnabled(false);
+    compiled.getSharedResources()->getWorkSizeTuner()->setTuningEnabled(false);
+    compiled.setCompiledSteps(true);
+
+    // Adam's bias correction changes every step, so replayed steps only match if its arguments are rebound.
+    const size_t STEPS = 5;
+    for (size_t step = 0; step < STEPS; ++step)
+    {
+        std::vector<float> inputs = randomVector(B * INPUTS);
+        std::vector<float> targets = randomVector(B * OUTPUTS);
+        eager.trainStep(makeBatch(eager, inputs, targets));
+        compiled.trainStep(makeBatch(compiled, inputs, targets));
+    }
+    ASSERT_GT(compiled.getRecordedCommandCount(), 0u) << "Later steps should replay the recording.";
+
+    std::vector<float> probe = randomVector(B * INPUTS);
+    std::vector<float> eagerOutputs = eager.predict(Utils::createCLBuffer(eager.getSharedResources()->getContext(), probe), B);
+    std::vector<float> compiledOutputs = compiled.predict(Utils::createCLBuffer(compiled.getSharedResources()->getContext(), probe), B);
+    ASSERT_EQ(eagerOutputs.size(), compiledOutputs.size());
+    for (size_t i = 0; i < eagerOutputs.size(); ++i)
+    {
+        EXPECT_NEAR(eagerOutputs[i], compiledOutputs[i], 1e-5f) << "Output " << i << " diverged.";
+    }
+}
+
+TEST_F(LocalNeuralNetworkTest, CompiledStepsRecordAgainWhileTuning)
+{
+    // Without a cache directory the tuner is in-memory, so every launch starts untuned.
+    LocalNeuralNetwork network = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    std::shared_ptr<Utils::WorkSizeTuner> tuner = network.getSharedResources()->getWorkSizeTuner();
+    ASSERT_TRUE(tuner->getTuningFile().empty());
+    ASSERT_EQ(tuner->getTunedCount(), 0u);
+    tuner->setTuningEnabled(true);
+    network.setCompiledSteps(true);
+
+    Utils::Batch batch = makeBatch(network, randomVector(B * INPUTS), randomVector(B * OUTPUTS));
+    network.trainStep(batch, true);
+    tuner->collect();
+    ASSERT_GT(tuner->getTuningCount(), 0u) << "The first step should leave launches being tuned.";
+    EXPECT_EQ(network.getRecordedCommandCount(), 0u) << "A step recorded before tuning finished must not be replayed.";
+
+    const size_t MAX_STEPS = 500;
+    for (size_t step = 0; step < MAX_STEPS && tuner->getTuningCount() > 0; ++step)
+    {
+        network.trainStep(batch, true);
+        tuner->collect();
+    }
+    ASSERT_EQ(tuner->getTuningCount(), 0u) << "Tuning should settle within " << MAX_STEPS << " steps.";
+
+    network.trainStep(batch, true);
+    EXPECT_GT(network.getRecordedCommandCount(), 0u) << "Once tuning settles the step should be recorded for replay.";
+}
+
+// The fused backward pass applies the activation derivative in place on the deltas the activation shares
+// with its layer, so the weights it trains must match separate activation layers.
+TEST_F(LocalNeuralNetworkTest, FusedActivationsTrainLikeSeparateLayers)
+{
+    LocalNeuralNetwork fused = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    LocalNeuralNetwork separate = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    separate.setActivationFusion(false);
+
+    const size_t STEPS = 3;
+    for (size_t step = 0; step < STEPS; ++step)
+    {
+        std::vector<float> inputs = randomVector(B * INPUTS);
+        std::vector<float> targets = randomVector(B * OUTPUTS);
+        fused.trainStep(makeBatch(fused, inputs, targets));
+        separate.trainStep(makeBatch(separate, inputs, targets));
+    }
+    ASSERT_TRUE(fused.isActivationFused(1) && fused.isActivationFused(3));
+    ASSERT_FALSE(separate.isActivationFused(1) || separate.isActivationFused(3));
+
+    std::vector<float> probe = randomVector(B * INPUTS);
+    std::vector<float> fusedOutputs = fused.predict(Utils::createCLBuffer(fused.getSharedResources()->getContext(), probe), B);
+    std::vector<float> separateOutputs = separate.predict(Utils::createCLBuffer(separate.getSharedResources()->getContext(), probe), B);
+    ASSERT_EQ(fusedOutputs.size(), separateOutputs.size());
+    for (size_t i = 0; i < fusedOutputs.size(); ++i)
+    {
+        EXPECT_NEAR(fusedOutputs[i], separateOutputs[i], 1e-5f) << "Output " << i << " diverged.";
+    }
+}
+
+// Pipelined steps wait for the previous optimizer update on the device instead of on the host, and must
+// still see every update in order.
+TEST_F(LocalNeuralNetworkTest, PipelinedTrainingMatchesSequentialTraining)
+{
+    const size_t SAMPLES = 10 * B;
+    std::filesystem::path csvPath = std::filesystem::temp_directory_path() / "local_network_pipeline_test.csv";
+    std::vector<std::string> inputColumns;
+    std::vector<std::string> targetColumns;
+    {
+        std::ofstream csv(csvPath);
+        std::vector<std::string> header;
+        for (size_t i = 0; i < INPUTS; ++i)
+            inputColumns.push_back("x" + std::to_string(i));
+        for (size_t i = 0; i < OUTPUTS; ++i)
+            targetColumns.push_back("y" + std::to_string(i));
+        header.insert(header.end(), inputColumns.begin(), inputColumns.end());
+        header.insert(header.end(), targetColumns.begin(), targetColumns.end());
+        for (size_t i = 0; i < header.size(); ++i)
+            csv << (i ? "," : "") << header[i];
+        csv << "\n";
+        for (size_t sample = 0; sample < SAMPLES; ++sample)
+        {
+            std::vector<float> row = randomVector(INPUTS + OUTPUTS);
+            for (size_t i = 0; i < row.size(); ++i)
+                csv << (i ? "," : "") << row[i];
+            csv << "\n";
+        }
+    }
+
+    LocalNeuralNetwork sequential = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    LocalNeuralNetwork pipelined = makeNetwork(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""));
+    sequential.setPipelineDepth(1);
+    pipelined.setPipelineDepth(3);
+
+    DataLoaders::CSVNumericalLoader sequentialLoader(sequential.getSharedResources(), B, inputColumns, targetColumns);
+    DataLoaders::CSVNumericalLoader pipelinedLoader(pipelined.getSharedResources(), B, inputColumns, targetColumns);
+    for (DataLoaders::CSVNumericalLoader *loader : {&sequentialLoader, &pipelinedLoader})
+    {
+        loader->loadData(csvPath.string());
+        loader->splitData(1.0f, 0.0f, SEED);
+    }
+    sequential.train(sequentialLoader, 2);
+    pipelined.train(pipelinedLoader, 2);
+    std::filesystem::remove(csvPath);
+
+    std::vector<float> probe = randomVector(B * INPUTS);
+    std::vector<float> sequentialOutputs = sequential.predict(Utils::createCLBuffer(sequential.getSharedResources()->getContext(), probe), B);
+    std::vector<float> pipelinedOutputs = pipelined.predict(Utils::createCLBuffer(pipelined.getSharedResources()->getContext(), probe), B);
+    ASSERT_EQ(sequentialOutputs.size(), pipelinedOutputs.size());
+    for (size_t i = 0; i < sequentialOutputs.size(); ++i)
+    {
+        EXPECT_NEAR(sequentialOutputs[i], pipelinedOutputs[i], 1e-5f) << "Output " << i << " diverged.";
+    }
+}
+
+// Checkpointed backward passes recompute each segment's outputs before backpropagating through it, so the
+// weights they train must match those of a network that keeps every output.
+TEST_F(LocalNeuralNetworkTest, GradientCheckpointingTrainsLikeFullActivations)
+{
+    auto makeDeepNetwork = [this]()
+    {
+        LocalNeuralNetwork network(Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, ""),
+                                   Utils::createNetworkArgs(Utils::Dimensions({INPUTS}), {}, Utils::makeAdamArgs(0.01f),
+                                                            Utils::makeMeanSquaredErrorLossFunctionArgs()),
+                                   SEED, B);
+        network.addDense(8).addReLU().addDense(8).addTanh().addDense(8).addReLU().addDense(OUTPUTS).addSigmoid();
+        return network;
+    };
+    LocalNeuralNetwork full = makeDeepNetwork();
+    LocalNeuralNetwork checkpointed = makeDeepNetwork();
+    checkpointed.setGradientCheckpointing(true, 2);
+
+    const size_t STEPS = 3;
+    for (size_t step = 0; step < STEPS; ++step)
+    {
+        std::vector<float> inputs = randomVector(B * INPUTS);
+        std::vector<float> targets = randomVector(B * OUTPUTS);
+        full.trainStep(makeBatch(full, inputs, targets));
+        checkpointed.trainStep(makeBatch(checkpointed, inputs, targets));
+    }
+    ASSERT_GT(checkpointed.getCheckpointSegments().size(), 1u) << "The network should be split into several segments.";
+
+    std::vector<float> probe = randomVector(B * INPUTS);
+    std::vector<float> fullOutputs = full.predict(Utils::createCLBuffer(full.getSharedResources()->getContext(), probe), B);
+    std::vector<float> checkpointedOutputs = checkpointed.predict(Utils::createCLBuffer(checkpointed.getSharedResources()->getContext(), probe), B);
+    ASSERT_EQ(fullOutputs.size(), checkpointedOutputs.size());
+    for (size_t i = 0; i < fullOutputs.size(); ++i)
+    {
+        EXPECT_NEAR(fullOutputs[i], checkpointedOutputs[i], 1e-5f) << "Output " << i << " diverged.";
+    }
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "Utils/OpenCLResources.hpp"
+
+TEST(BufferPoolTest, SizeClassesBoundSlack)
+{
+    EXPECT_EQ(Utils::BufferPool::getSizeClass(1), 256u);
+    EXPECT_EQ(Utils::BufferPool::getSizeClass(256), 256u);
+    EXPECT_EQ(Utils::BufferPool::getSizeClass(300), 320u);
+    EXPECT_EQ(Utils::BufferPool::getSizeClass(512), 512u);
+    EXPECT_EQ(Utils::BufferPool::getSizeClass(513), 640u);
+    for (size_t bytes = 1; bytes < (1u << 20); bytes = bytes * 3 + 1)
+    {
+        size_t sizeClass = Utils::BufferPool::getSizeClass(bytes);
+        EXPECT_GE(sizeClass, bytes);
+        EXPECT_LE(sizeClass, std::max<size_t>(256, bytes + bytes / 4 + 1));
+    }
+}
+
+TEST(BufferPoolTest, ReleasedBuffersAreReused)
+{
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, "");
+    Utils::BufferPool pool(clRes.getContext());
+
+    cl::Buffer first = pool.acquire(1000 * sizeof(float));
+    pool.release(first);
+    EXPECT_EQ(first(), nullptr);
+
+    cl::Buffer second = pool.acquire(990 * sizeof(float));
+    EXPECT_NE(second(), nullptr);
+    EXPECT_EQ(pool.getCreatedCount(), 1u);
+    EXPECT_EQ(pool.getReusedCount(), 1u);
+
+    cl::Buffer third = pool.acquire(1000 * sizeof(float));
+    EXPECT_NE(third(), second());
+    EXPECT_EQ(pool.getCreatedCount(), 2u) << "A buffer still in use must not be handed out twice.";
+}
+
+TEST(BufferPoolTest, DiscardedBuffersAreNotCached)
+{
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, "");
+    Utils::BufferPool pool(clRes.getContext(), 1 << 20);
+
+    cl::Buffer standalone = pool.acquire(1 << 20);
+    pool.discard(standalone);
+    EXPECT_EQ(standalone(), nullptr);
+    EXPECT_EQ(pool.getFreeBytes(), 0u) << "A standalone buffer should be freed, not cached.";
+
+    cl::Buffer subBuffer = pool.acquire(1000 * sizeof(float));
+    pool.discard(subBuffer);
+    EXPECT_EQ(subBuffer(), nullptr);
+    EXPECT_GT(pool.getFreeBytes(), 0u) << "Arena sub-buffers can only be handed out again.";
+}
+
+TEST(BufferPoolTest, ArenaSubBuffersHoldData)
+{
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, "");
+    Utils::BufferPool pool(clRes.getContext(), 1 << 20);
+
+    std::vector<float> a(100, 1.0f);
+    std::vector<float> b(200, 2.0f);
+    cl::Buffer bufferA = pool.acquire(a.size() * sizeof(float), a.data());
+    cl::Buffer bufferB = pool.acquire(b.size() * sizeof(float), b.data());
+    cl::Buffer zeros = pool.acquireFilled(50 * sizeof(float), 0.0f);
+
+    EXPECT_TRUE(Utils::compare1D(Utils::readBuffer1D(clRes.getForwardBackpropQueue(), bufferA, a.size()), a));
+    EXPECT_TRUE(Utils::compare1D(Utils::readBuffer1D(clRes.getForwardBackpropQueue(), bufferB, b.size()), b));
+    EXPECT_TRUE(Utils::compare1D(Utils::readBuffer1D(clRes.getForwardBackpropQueue(), zeros, 50), std::vector<float>(50, 0.0f)));
+    EXPECT_EQ(pool.getCreatedBytes(), static_cast<size_t>(1 << 20)) << "Small buffers should share one arena.";
+}
+
+TEST(BufferPoolTest, ZeroCopyBuffersRoundTrip)
+{
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, "");
+    Utils::BufferPool pool(clRes.getContext());
+    std::vector<float> data(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<float>(i) * 0.5f;
+    }
+
+    for (bool zeroCopy : {true, false})
+    {
+        pool.setZeroCopy(zeroCopy);
+        EXPECT_EQ(pool.isZeroCopy(), zeroCopy);
+        cl::Buffer buffer = pool.acquire(data.size() * sizeof(float), data.data());
+        EXPECT_EQ(Utils::isHostResident(buffer), zeroCopy);
+        EXPECT_EQ(Utils::readCLBuffer(clRes.getForwardBackpropQueue(), buffer, data.size()), data);
+
+        Utils::accessHostMemory(clRes.getForwardBackpropQueue(), buffer, sizeof(float), CL_MAP_WRITE,
+                                [](void *p_mapped)
+                                { static_cast<float *>(p_mapped)[0] = -1.0f; });
+        EXPECT_EQ(Utils::readCLBuffer(clRes.getForwardBackpropQueue(), buffer, 2), std::vector<float>({-1.0f, 0.5f}));
+        pool.release(buffer);
+    }
+}
@@ -0,0 +1,22 @@
+#include <gtest/gtest.h>
+#include "Utils/CLBlastTuner.hpp"
+
+TEST(CLBlastTunerTest, SkipsMalformedEntries)
+{
+    std::filesystem::path file = std::filesystem::temp_directory_path() / "OpenCLNeuralNetworkMalformedCLBlast.tsv";
+    {
+        std::ofstream out(file);
+        out << "device\tXgemm\t64x32x16\tMWG=64;NWG=64;KWG=16\n";
+        out << "device\tXgemv\t64x32x0\tWGS1=128\n";
+        out << "device\tXgemm\t128x32x16\tMWG=64;NWG=big;KWG=16\n";
+        out << "device\tXgemm\t256x32x16\tMWG=\n";
+        out << "device\tXgemm\t512x32x16\n";
+    }
+
+    std::unique_ptr<Utils::CLBlastTuner> tuner;
+    EXPECT_NO_THROW(tuner = std::make_unique<Utils::CLBlastTuner>(file.string()));
+    ASSERT_TRUE(tuner != nullptr);
+    EXPECT_EQ(tuner->getEntryCount(), 2u) << "Only the well-formed entries should be loaded.";
+
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "Layers/ActivationLayers/PreActivationLayers/ReLU/ReLULayer.hpp"
+#include "Utils/OpenCLResources.hpp"
+
+using Layers::Activation::ReLULayer;
+
+class CommandRecorderTest : public ::testing::Test
+{
+protected:
+    Utils::OpenCLResources ocl = Utils::OpenCLResources::createOpenCLResources();
+    const size_t ELEMENTS = 16;
+    const size_t B = 2;
+
+    std::vector<float> ramp(float p_start)
+    {
+        std::vector<float> values(B * ELEMENTS);
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = p_start + static_cast<float>(i);
+        }
+        return values;
+    }
+};
+
+TEST_F(CommandRecorderTest, ReplayReadsCurrentBufferContents)
+{
+    ReLULayer layer(0, ocl.getSharedResources(), Utils::Dimensions({ELEMENTS}), B);
+    const cl::CommandQueue &queue = ocl.getForwardBackpropQueue();
+    std::vector<float> inputs = ramp(-10.0f);
+    cl::Buffer inputBuffer = Utils::createCLBuffer(ocl.getContext(), inputs);
+
+    Utils::CommandRecorder recorder;
+    ocl.getSharedResources()->setCommandRecorder(&recorder);
+    layer.runForward(queue, inputBuffer, B).wait();
+    ocl.getSharedResources()->setCommandRecorder(nullptr);
+    ASSERT_EQ(recorder.getCommandCount(), 1u);
+
+    inputs = ramp(-20.0f);
+    queue.enqueueWriteBuffer(inputBuffer, CL_TRUE, 0, inputs.size() * sizeof(float), inputs.data());
+    recorder.replay();
+    queue.finish();
+
+    std::vector<float> outputs = Utils::readBuffer1D(queue, layer.getOutputs(), B * ELEMENTS);
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        EXPECT_NEAR(outputs[i], std::max(inputs[i], 0.0f), 1e-6) << "at element " << i;
+    }
+}
+
+TEST_F(CommandRecorderTest, DependenciesAcrossQueuesAreReplayed)
+{
+    ReLULayer layer(0, ocl.getSharedResources(), Utils::Dimensions({ELEMENTS}), B);
+    std::vector<float> inputs = ramp(-5.0f);
+    cl::Buffer inputBuffer = Utils::createCLBuffer(ocl.getContext(), inputs);
+
+    Utils::CommandRecorder recorder;
+    ocl.getSharedResources()->setCommandRecorder(&recorder);
+    std::vector<cl::Event> waitList = {layer.runForward(ocl.getForwardBackpropQueue(), inputBuffer, B)};
+    cl::Event barrierEvent;
+    ocl.getSharedResources()->enqueueBarrier(ocl.getConcurrentQueue(), &waitList, &barrierEvent);
+    ocl.getSharedResources()->setCommandRecorder(nullptr);
+    ocl.getConcurrentQueue().finish();
+    EXPECT_EQ(recorder.getCommandCount(), 2u);
+
+    recorder.replay();
+    ocl.getConcurrentQueue().finish();
+    std::vector<float> outputs = Utils::readBuffer1D(ocl.getForwardBackpropQueue(), layer.getOutputs(), B * ELEMENTS);
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        EXPECT_NEAR(outputs[i], std::max(inputs[i], 0.0f), 1e-6);
+    }
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "Utils/MemoryPlanner.hpp"
+#include <random>
+
+TEST(MemoryPlannerTest, ForwardChainNeedsOnlyTwoLiveTensors)
+{
+    Utils::MemoryPlanner planner(256);
+    std::vector<size_t> sizes = {4096, 16384, 16384, 1024, 1024, 40};
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        planner.addTensor(sizes[i], i, i + 1);
+    }
+    planner.plan();
+
+    EXPECT_LE(planner.getArenaSize(), 16384u + 16384u);
+    EXPECT_LT(planner.getArenaSize(), planner.getUnplannedSize());
+    for (size_t i = 0; i < planner.getTensorCount(); ++i)
+    {
+        EXPECT_EQ(planner.getOffset(i) % 256, 0u);
+    }
+}
+
+TEST(MemoryPlannerTest, LiveTensorsNeverOverlap)
+{
+    Utils::MemoryPlanner planner(128);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> sizeDistribution(1, 10000);
+    std::uniform_int_distribution<size_t> stepDistribution(0, 20);
+    for (int i = 0; i < 64; ++i)
+    {
+        size_t first = stepDistribution(rng);
+        size_t last = first + stepDistribution(rng) / 4;
+        planner.addTensor(sizeDistribution(rng), first, last);
+    }
+    planner.extendLifetime(0, 40);
+    planner.plan();
+
+    std::mt19937 replay(7);
+    std::vector<std::pair<size_t, size_t>> lifetimes;
+    for (int i = 0; i < 64; ++i)
+    {
+        sizeDistribution(replay);
+        size_t first = stepDistribution(replay);
+        size_t last = first + stepDistribution(replay) / 4;
+        lifetimes.push_back({first, last});
+    }
+    lifetimes[0].second = 40;
+
+    for (size_t a = 0; a < planner.getTensorCount(); ++a)
+    {
+        EXPECT_LE(planner.getOffset(a) + planner.getBytes(a), planner.getArenaSize());
+        for (size_t b = a + 1; b < planner.getTensorCount(); ++b)
+        {
+            bool liveTogether = lifetimes[a].first <= lifetimes[b].second && lifetimes[b].first <= lifetimes[a].second;
+            bool shareBytes = planner.getOffset(a) < planner.getOffset(b) + planner.getBytes(b) &&
+                              planner.getOffset(b) < planner.getOffset(a) + planner.getBytes(a);
+            EXPECT_FALSE(liveTogether && shareBytes) << "Tensors " << a << " and " << b << " overlap while both are live.";
+        }
+    }
+}
+
+TEST(MemoryPlannerTest, RejectsInvalidLifetimes)
+{
+    Utils::MemoryPlanner planner;
+    EXPECT_THROW(planner.addTensor(16, 3, 2), std::invalid_argument);
+    size_t tensor = planner.addTensor(16, 0, 0);
+    EXPECT_THROW(planner.getOffset(tensor), std::runtime_error);
+    EXPECT_THROW(planner.getOffset(tensor + 1), std::out_of_range);
+}
+
+TEST(MemoryPlannerTest, DisjointLiveRangesShareMemory)
+{
+    Utils::MemoryPlanner planner(64);
+    size_t recomputed = planner.addTensor(1024, 0, 1);
+    planner.addLiveRange(recomputed, 6, 7);
+    size_t middle = planner.addTensor(1024, 2, 5);
+    size_t late = planner.addTensor(1024, 7, 8);
+    planner.plan();
+
+    EXPECT_EQ(planner.getOffset(recomputed), planner.getOffset(middle));
+    EXPECT_NE(planner.getOffset(recomputed), planner.getOffset(late));
+    EXPECT_EQ(planner.getArenaSize(), 2048u);
+    EXPECT_THROW(planner.addLiveRange(recomputed, 9, 8), std::invalid_argument);
+}
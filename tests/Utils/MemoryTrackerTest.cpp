@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include "Utils/MemoryTracker.hpp"
+
+using Utils::MemoryRole;
+using Utils::MemoryTracker;
+
+TEST(MemoryTrackerTest, AliasedViewsCountPerOwnerOnly)
+{
+    MemoryTracker tracker;
+    tracker.beginSnapshot();
+    tracker.record(MemoryTracker::NETWORK_OWNER, MemoryRole::Activations, 4096);
+    tracker.record(0, MemoryRole::Outputs, 1024, true);
+    tracker.record(0, MemoryRole::Deltas, 1024, true);
+    tracker.record(1, MemoryRole::Outputs, 2048, true);
+    tracker.record(1, MemoryRole::SignMasks, 64);
+    tracker.endSnapshot();
+
+    EXPECT_EQ(tracker.getCurrentBytes(), 4096u + 64u);
+    EXPECT_EQ(tracker.getCurrentBytes(0), 2048u);
+    EXPECT_EQ(tracker.getCurrentBytes(1), 2048u + 64u);
+    EXPECT_TRUE(tracker.getUsage(0, MemoryRole::Outputs).m_aliased);
+    EXPECT_EQ(tracker.getUsage(2, MemoryRole::Weights).m_currentBytes, 0u);
+}
+
+TEST(MemoryTrackerTest, PeaksSurviveSmallerSnapshots)
+{
+    MemoryTracker tracker;
+    tracker.beginSnapshot();
+    tracker.record(MemoryTracker::NETWORK_OWNER, MemoryRole::Batch, 8192);
+    tracker.record(3, MemoryRole::Weights, 512);
+    tracker.endSnapshot();
+
+    tracker.beginSnapshot();
+    tracker.record(MemoryTracker::NETWORK_OWNER, MemoryRole::Batch, 1024);
+    tracker.record(3, MemoryRole::Weights, 512);
+    tracker.endSnapshot();
+
+    EXPECT_EQ(tracker.getCurrentBytes(), 1024u + 512u);
+    EXPECT_EQ(tracker.getPeakBytes(), 8192u + 512u);
+    MemoryTracker::Usage batch = tracker.getUsage(MemoryTracker::NETWORK_OWNER, MemoryRole::Batch);
+    EXPECT_EQ(batch.m_currentBytes, 1024u);
+    EXPECT_EQ(batch.m_peakBytes, 8192u);
+    EXPECT_EQ(tracker.getPeakBytes(3), 512u);
+}
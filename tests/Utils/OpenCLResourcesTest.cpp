@@ -15,4 +15,120 @@ TEST(OpenCLResourcesTest, GetDeviceCount)
     std::vector<cl::Device> devices = context.getInfo<CL_CONTEXT_DEVICES>();
     size_t count = devices.size();
     EXPECT_GT(count, 0) << "Should detect at least one OpenCL device.";
-}
\ No newline at end of file
+}
+
+TEST(OpenCLResourcesTest, ProgramCacheHitOnSecondStartup)
+{
+    std::filesystem::path cacheDir = std::filesystem::temp_directory_path() / "OpenCLNeuralNetworkProgramCacheTest";
+    std::filesystem::remove_all(cacheDir);
+
+    Utils::OpenCLResources first = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, cacheDir.string());
+    ASSERT_TRUE(first.valid());
+    first.getProgram(Utils::KernelFamily::Activation);
+    EXPECT_EQ(first.getSharedResources()->getProgramCache()->getHits(), 0u);
+    EXPECT_EQ(first.getSharedResources()->getProgramCache()->getMisses(), 1u);
+
+    Utils::OpenCLResources second = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, cacheDir.string());
+    ASSERT_TRUE(second.valid());
+    second.getProgram(Utils::KernelFamily::Activation);
+    EXPECT_EQ(second.getSharedResources()->getProgramCache()->getHits(), 1u) << "Second startup should load the cached program binary.";
+    EXPECT_EQ(second.getSharedResources()->getProgramCache()->getMisses(), 0u);
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+
+TEST(OpenCLResourcesTest, ProgramFamiliesBuildOnDemand)
+{
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, "");
+    std::shared_ptr<Utils::SharedResources> shared = clRes.getSharedResources();
+    EXPECT_FALSE(shared->isProgramBuilt(Utils::KernelFamily::Activation));
+    EXPECT_FALSE(shared->isProgramBuilt(Utils::KernelFamily::Convolutional));
+
+    shared->buildPrograms({Utils::KernelFamily::Activation, Utils::KernelFamily::Dense});
+    EXPECT_TRUE(shared->isProgramBuilt(Utils::KernelFamily::Activation));
+    EXPECT_TRUE(shared->isProgramBuilt(Utils::KernelFamily::Dense));
+    EXPECT_FALSE(shared->isProgramBuilt(Utils::KernelFamily::Convolutional));
+
+    cl_int err = CL_SUCCESS;
+    cl::Kernel kernel(shared->getProgram(Utils::KernelFamily::Activation), "reLUForward", &err);
+    EXPECT_EQ(err, CL_SUCCESS);
+}
+
+TEST(OpenCLResourcesTest, DevicesAreRankedByScore)
+{
+    std::vector<Utils::DeviceCapabilities> devices = Utils::DeviceDiscovery::enumerateDevices();
+    ASSERT_FALSE(devices.empty()) << "Should detect at least one OpenCL device.";
+    for (size_t i = 1; i < devices.size(); ++i)
+    {
+        EXPECT_GE(devices[i - 1].m_score, devices[i].m_score);
+    }
+
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(devices.front(), KERNELS_DIR, "");
+    ASSERT_TRUE(clRes.valid());
+    EXPECT_EQ(clRes.getDevice().getInfo<CL_DEVICE_NAME>(), devices.front().m_name);
+}
+
+TEST(OpenCLResourcesTest, MultiDeviceContextSharesPrograms)
+{
+    std::vector<Utils::DeviceCapabilities> devices = Utils::DeviceDiscovery::selectBestPlatformDevices();
+    Utils::OpenCLResources first = Utils::OpenCLResources::createOpenCLResources(devices, KERNELS_DIR, "");
+    ASSERT_TRUE(first.valid());
+    std::shared_ptr<Utils::SharedResources> shared = first.getSharedResources();
+    EXPECT_EQ(shared->getDevices().size(), devices.size());
+
+    Utils::OpenCLResources last = Utils::OpenCLResources::createOpenCLResources(shared, devices.size() - 1);
+    ASSERT_TRUE(last.valid());
+    EXPECT_EQ(last.getContext()(), first.getContext()());
+    EXPECT_THROW(Utils::OpenCLResources::createOpenCLResources(shared, devices.size()), std::out_of_range);
+}
+
+TEST(OpenCLResourcesTest, WorkSizeTunerPersistsWinners)
+{
+    std::filesystem::path cacheDir = std::filesystem::temp_directory_path() / "OpenCLNeuralNetworkWorkSizeTest";
+    std::filesystem::remove_all(cacheDir);
+
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, cacheDir.string());
+    std::shared_ptr<Utils::SharedResources> shared = clRes.getSharedResources();
+    const size_t elements = 4096;
+    std::vector<float> data(elements, -1.0f);
+    cl::Buffer inputs = Utils::createCLBuffer(clRes.getContext(), data);
+    cl::Buffer outputs(clRes.getContext(), CL_MEM_READ_WRITE, elements * sizeof(float));
+    cl::Kernel kernel(shared->getProgram(Utils::KernelFamily::Activation), "reLUForward");
+    Utils::setKernelArgs(kernel, inputs, outputs, 0.0f, (cl_uint)elements);
+
+    for (size_t i = 0; i < 64; ++i)
+    {
+        EXPECT_EQ(shared->enqueueKernel(clRes.getForwardBackpropQueue(), kernel, cl::NDRange(elements)), CL_SUCCESS);
+        clRes.getForwardBackpropQueue().finish();
+    }
+    shared->getWorkSizeTuner()->collect();
+    EXPECT_EQ(shared->getWorkSizeTuner()->getTuningCount(), 0u) << "The kernel should be tuned after enough launches.";
+    EXPECT_TRUE(Utils::compare1D(Utils::readBuffer1D(clRes.getForwardBackpropQueue(), outputs, elements), std::vector<float>(elements, 0.0f)));
+
+    Utils::WorkSizeTuner reloaded(shared->getWorkSizeTuner()->getTuningFile());
+    EXPECT_EQ(reloaded.getTunedCount(), shared->getWorkSizeTuner()->getTunedCount());
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+TEST(OpenCLResourcesTest, WorkSizeTunerSkipsMalformedLines)
+{
+    std::filesystem::path file = std::filesystem::temp_directory_path() / "OpenCLNeuralNetworkMalformedWorkSizes.tsv";
+    {
+        std::ofstream out(file);
+        out << "device\treLUForward\t4096\t64\t1200\n";
+        out << "device\treLUBackward\t4096\t6x4\t1200\n";
+        out << "device\tsigmoidForward\t4096\tabc\t1200\n";
+        out << "device\ttanhForward\t4096\t64\tfast\n";
+        out << "device\ttanhBackward\t4096\t64\t\n";
+        out << "device\tsoftmaxForward\t4096\t0\t1200\n";
+    }
+
+    std::unique_ptr<Utils::WorkSizeTuner> tuner;
+    EXPECT_NO_THROW(tuner = std::make_unique<Utils::WorkSizeTuner>(file.string()));
+    ASSERT_TRUE(tuner != nullptr);
+    EXPECT_EQ(tuner->getTunedCount(), 2u) << "Only the well-formed lines should be loaded.";
+
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+#include "Utils/OpenCLResources.hpp"
+
+TEST(StagingRingTest, UploadsLandInDeviceBuffers)
+{
+    Utils::OpenCLResources clRes = Utils::OpenCLResources::createOpenCLResources(KERNELS_DIR, 0, 0, "");
+    Utils::StagingRing ring(clRes.getContext(), 2);
+
+    std::vector<cl::Buffer> buffers;
+    std::vector<std::vector<float>> expected;
+    std::vector<cl::Event> uploads;
+    for (size_t i = 0; i < 5; ++i)
+    {
+        std::vector<float> data(100 * (i + 1), static_cast<float>(i));
+        buffers.emplace_back(clRes.getContext(), CL_MEM_READ_WRITE, data.size() * sizeof(float));
+        uploads.push_back(ring.upload(buffers.back(), data.data(), data.size() * sizeof(float)));
+        expected.push_back(std::move(data));
+    }
+
+    EXPECT_EQ(ring.getSlotCount(), 2u);
+    EXPECT_GE(ring.getPinnedBytes(), (400u + 500u) * sizeof(float));
+    cl::Event::waitForEvents(uploads);
+    for (size_t i = 0; i < buffers.size(); ++i)
+    {
+        EXPECT_EQ(Utils::readCLBuffer(clRes.getForwardBackpropQueue(), buffers[i], expected[i].size()), expected[i]);
+    }
+    EXPECT_EQ(ring.upload(buffers.front(), nullptr, 0)(), nullptr);
+}